@@ -0,0 +1,230 @@
+#include <ituGL/core/JobSystem.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+
+// Benchmark and stress test of the JobSystem. Doesn't need a GL context
+// Each test checks its results, the program returns 1 if any of them failed
+
+using Clock = std::chrono::steady_clock;
+
+static double GetMilliseconds(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static bool Report(const char* name, bool passed, double milliseconds)
+{
+    std::cout << std::left << std::setw(40) << name << (passed ? "OK    " : "FAILED") << std::right << std::setw(10) << std::fixed << std::setprecision(2) << milliseconds << " ms" << std::endl;
+    return passed;
+}
+
+// Some work per element, with a cost that changes along the range, so the chunks are uneven
+static unsigned int ComputeElement(unsigned int index)
+{
+    unsigned int value = index;
+    unsigned int iterations = 16 + (index % 1024) / 8;
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+        value = value * 1664525u + 1013904223u;
+        value ^= value >> 13;
+    }
+    return value;
+}
+
+// ParallelFor against a serial loop, with adaptive and fixed grain sizes
+static bool TestParallelFor(JobSystem& jobSystem)
+{
+    const unsigned int elementCount = 1 << 20;
+
+    std::vector<unsigned int> expected(elementCount);
+    Clock::time_point start = Clock::now();
+    for (unsigned int i = 0; i < elementCount; ++i)
+    {
+        expected[i] = ComputeElement(i);
+    }
+    bool passed = Report("ParallelFor (serial reference)", true, GetMilliseconds(start));
+
+    const unsigned int grainSizes[] = { 0, 256, 16384 };
+    const char* names[] = { "ParallelFor (adaptive grain)", "ParallelFor (grain 256)", "ParallelFor (grain 16384)" };
+    for (unsigned int test = 0; test < 3; ++test)
+    {
+        std::vector<unsigned int> results(elementCount, 0);
+        start = Clock::now();
+        jobSystem.ParallelFor(0, elementCount, [&](unsigned int begin, unsigned int end)
+            {
+                for (unsigned int i = begin; i < end; ++i)
+                {
+                    results[i] = ComputeElement(i);
+                }
+            }, grainSizes[test]);
+        double milliseconds = GetMilliseconds(start);
+        passed &= Report(names[test], results == expected, milliseconds);
+    }
+
+    return passed;
+}
+
+// ParallelFor inside the chunks of another ParallelFor. The inner waits run other jobs instead of blocking
+static bool TestNestedParallelFor(JobSystem& jobSystem)
+{
+    const unsigned int outerCount = 64;
+    const unsigned int innerCount = 4096;
+
+    std::vector<std::atomic<unsigned int>> sums(outerCount);
+    Clock::time_point start = Clock::now();
+    jobSystem.ParallelFor(0, outerCount, [&](unsigned int outerBegin, unsigned int outerEnd)
+        {
+            for (unsigned int outer = outerBegin; outer < outerEnd; ++outer)
+            {
+                jobSystem.ParallelFor(0, innerCount, [&, outer](unsigned int begin, unsigned int end)
+                    {
+                        sums[outer] += end - begin;
+                    }, 64);
+            }
+        }, 1);
+    double milliseconds = GetMilliseconds(start);
+
+    bool passed = true;
+    for (const std::atomic<unsigned int>& sum : sums)
+    {
+        passed &= sum == innerCount;
+    }
+    return Report("Nested ParallelFor", passed, milliseconds);
+}
+
+// Layers of jobs, where each job depends on all the jobs of the previous layer
+// A job that starts before its dependencies finished sees an incomplete count
+static bool TestDependencies(JobSystem& jobSystem)
+{
+    const unsigned int layerCount = 32;
+    const unsigned int layerWidth = 64;
+
+    std::vector<std::atomic<unsigned int>> finishedCounts(layerCount);
+    std::atomic<unsigned int> violations = 0;
+
+    Clock::time_point start = Clock::now();
+    std::vector<JobSystem::JobHandle> previousLayer, currentLayer;
+    for (unsigned int layer = 0; layer < layerCount; ++layer)
+    {
+        currentLayer.clear();
+        for (unsigned int i = 0; i < layerWidth; ++i)
+        {
+            JobSystem::JobHandle job = jobSystem.CreateJob([&, layer]
+                {
+                    if (layer > 0 && finishedCounts[layer - 1] != layerWidth)
+                    {
+                        violations++;
+                    }
+                    ComputeElement(layer * layerWidth);
+                    finishedCounts[layer]++;
+                }, "Layer");
+            for (const JobSystem::JobHandle& dependency : previousLayer)
+            {
+                jobSystem.AddDependency(job, dependency);
+            }
+            currentLayer.push_back(job);
+        }
+
+        // Submitted as they are created, so some dependencies may already be finished when added
+        for (const JobSystem::JobHandle& job : currentLayer)
+        {
+            jobSystem.Submit(job);
+        }
+        std::swap(previousLayer, currentLayer);
+    }
+
+    for (const JobSystem::JobHandle& job : previousLayer)
+    {
+        jobSystem.Wait(job);
+    }
+    double milliseconds = GetMilliseconds(start);
+
+    return Report("Dependency layers", violations == 0 && finishedCounts[layerCount - 1] == layerWidth, milliseconds);
+}
+
+// All jobs are pushed to the main thread queue, so the workers only get them by stealing
+static bool TestStealing(JobSystem& jobSystem)
+{
+    const unsigned int jobCount = 2048;
+
+    std::vector<std::atomic<unsigned int>> threadJobCounts(jobSystem.GetWorkerCount() + 1);
+    std::vector<JobSystem::JobHandle> jobs;
+    jobs.reserve(jobCount);
+
+    Clock::time_point start = Clock::now();
+    for (unsigned int i = 0; i < jobCount; ++i)
+    {
+        jobs.push_back(jobSystem.Run([&, i]
+            {
+                ComputeElement(i);
+                threadJobCounts[jobSystem.GetCurrentThreadIndex()]++;
+            }, "Steal"));
+    }
+    for (const JobSystem::JobHandle& job : jobs)
+    {
+        jobSystem.Wait(job);
+    }
+    double milliseconds = GetMilliseconds(start);
+
+    unsigned int totalCount = 0;
+    for (const std::atomic<unsigned int>& count : threadJobCounts)
+    {
+        totalCount += count;
+    }
+    unsigned int stolenCount = totalCount - threadJobCounts[JobSystem::MainThreadIndex];
+
+    // Without workers there is nobody to steal
+    bool passed = totalCount == jobCount && (jobSystem.GetWorkerCount() == 0 || stolenCount > 0);
+    passed = Report("Stealing from the main thread", passed, milliseconds);
+    std::cout << "    " << stolenCount << " of " << jobCount << " jobs stolen by the workers" << std::endl;
+    return passed;
+}
+
+// Jobs submitted by a thread that doesn't belong to the job system go through the injection queue
+static bool TestExternalThread(JobSystem& jobSystem)
+{
+    const unsigned int jobCount = 1024;
+
+    std::atomic<unsigned int> executedCount = 0;
+    std::vector<JobSystem::JobHandle> jobs(jobCount);
+
+    Clock::time_point start = Clock::now();
+    std::thread externalThread([&]
+        {
+            for (unsigned int i = 0; i < jobCount; ++i)
+            {
+                jobs[i] = jobSystem.Run([&] { executedCount++; }, "External");
+            }
+        });
+    externalThread.join();
+
+    for (const JobSystem::JobHandle& job : jobs)
+    {
+        jobSystem.Wait(job);
+    }
+    double milliseconds = GetMilliseconds(start);
+
+    return Report("Submission from an external thread", executedCount == jobCount, milliseconds);
+}
+
+// Optional argument: number of worker threads. By default, one per hardware thread, minus the main thread
+int main(int argc, char** argv)
+{
+    unsigned int workerCount = argc > 1 ? static_cast<unsigned int>(std::atoi(argv[1])) : JobSystem::GetDefaultWorkerCount();
+    JobSystem jobSystem(workerCount);
+    std::cout << "JobSystem with " << jobSystem.GetWorkerCount() << " workers" << std::endl;
+
+    bool passed = true;
+    passed &= TestParallelFor(jobSystem);
+    passed &= TestNestedParallelFor(jobSystem);
+    passed &= TestDependencies(jobSystem);
+    passed &= TestStealing(jobSystem);
+    passed &= TestExternalThread(jobSystem);
+
+    return passed ? 0 : 1;
+}
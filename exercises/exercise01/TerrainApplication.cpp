@@ -1,6 +1,6 @@
 #include "TerrainApplication.h"
 
-#include <ituGL/geometry/VertexAttribute.h>
+#include <ituGL/geometry/VertexLayout.h>
 
 #define STB_PERLIN_IMPLEMENTATION
 #include <stb_perlin.h>
@@ -39,6 +39,23 @@ struct Vertex
     Vector3 normal;
 };
 
+// Tell VertexLayout how our helper structures are stored: 2 or 3 floats
+template<>
+struct VertexAttributeTraits<Vector2>
+{
+    using ComponentType = float;
+    static constexpr Data::Type type = Data::Type::Float;
+    static constexpr int components = 2;
+};
+
+template<>
+struct VertexAttributeTraits<Vector3>
+{
+    using ComponentType = float;
+    static constexpr Data::Type type = Data::Type::Float;
+    static constexpr int components = 3;
+};
+
 
 // Forward declare helper function
 Vector3 GetColorFromHeight(float height);
@@ -134,31 +151,22 @@ void TerrainApplication::Initialize()
         }
     }
 
-    // Declare attributes
-    VertexAttribute positionAttribute(Data::Type::Float, 3);
-    VertexAttribute texCoordAttribute(Data::Type::Float, 2);
-    VertexAttribute colorAttribute(Data::Type::Float, 3);
-    VertexAttribute normalAttribute(Data::Type::Float, 3);
-
-    // Compute offsets inside the VERTEX STRUCT
-    size_t positionOffset = 0u;
-    size_t texCoordOffset = positionOffset + positionAttribute.GetSize();
-    size_t colorOffset = texCoordOffset + texCoordAttribute.GetSize();
-    size_t normalOffset = colorOffset + colorAttribute.GetSize();
+    // Declare the attributes from the members of the VERTEX STRUCT
+    // The type, size and offset of each attribute is computed at compile time, and it doesn't compile if a member is missing
+    constexpr auto vertexLayout = MakeVertexLayout(
+        VertexMember(&Vertex::position),
+        VertexMember(&Vertex::texCoord),
+        VertexMember(&Vertex::color),
+        VertexMember(&Vertex::normal));
 
     // Allocate uninitialized data for the total size in the VBO
     m_vbo.Bind();
     m_vbo.AllocateData(std::span(vertices));
 
-    // The stride is not automatic now. Each attribute element is "sizeof(Vertex)" bytes apart from next
-    GLsizei stride = sizeof(Vertex);
-
-    // Set the pointer to the data in the VAO (notice that this offsets are for a single element)
+    // Set the pointer to the data in the VAO, in locations 0 to 3 (notice that the offsets are for a single element)
+    // The stride is "sizeof(Vertex)": each attribute element is that many bytes apart from the next
     m_vao.Bind();
-    m_vao.SetAttribute(0, positionAttribute, static_cast<GLint>(positionOffset), stride);
-    m_vao.SetAttribute(1, texCoordAttribute, static_cast<GLint>(texCoordOffset), stride);
-    m_vao.SetAttribute(2, colorAttribute, static_cast<GLint>(colorOffset), stride);
-    m_vao.SetAttribute(3, normalAttribute, static_cast<GLint>(normalOffset), stride);
+    m_vao.SetAttributes(m_vbo, vertexLayout);
 
     // With VAO bound, bind EBO to register it (and allocate element buffer at the same time)
     m_ebo.Bind();
@@ -1,41 +1,21 @@
 #include "ParticlesApplication.h"
 
 #include <ituGL/shader/Shader.h>
-#include <ituGL/geometry/VertexAttribute.h>
+#include <ituGL/geometry/VertexLayout.h>
 #include <cassert>
 #include <array>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
-// Structure defining that Particle data
-struct Particle
-{
-    glm::vec2 position;
-    float size;
-    float birth;
-    float duration;
-    Color color;
-    glm::vec2 velocity;
-};
-
-// List of attributes of the particle. Must match the structure above
-const std::array<VertexAttribute, 6> s_vertexAttributes =
-{
-    VertexAttribute(Data::Type::Float, 2), // position
-    VertexAttribute(Data::Type::Float, 1), // size
-    VertexAttribute(Data::Type::Float, 1), // birth
-    VertexAttribute(Data::Type::Float, 1), // duration
-    VertexAttribute(Data::Type::Float, 4), // color
-    VertexAttribute(Data::Type::Float, 2), // velocity
-};
-
 
 ParticlesApplication::ParticlesApplication()
     : Application(1024, 1024, "Particles demo")
+    , m_particleBuffers(m_frameSync)
     , m_currentTimeUniform(0)
     , m_gravityUniform(0)
     , m_mousePosition(0)
+    , m_mouseVelocity(0)
     , m_particleCount(0)
     , m_particleCapacity(2048)  // You can change the capacity here to have more particles
 {
@@ -60,6 +40,9 @@ void ParticlesApplication::Initialize()
     // We need to enable V-sync, otherwise the framerate would be too high and spawn multiple particles in one click
     GetDevice().SetVSyncEnabled(true);
 
+    // Emit particles at a constant rate, so the result doesn't depend on the framerate
+    SetFixedTickRate(60.0f);
+
     // Get "CurrentTime" uniform location in the shader program
     m_currentTimeUniform = m_shaderProgram.GetUniformLocation("CurrentTime");
 
@@ -67,24 +50,37 @@ void ParticlesApplication::Initialize()
     m_gravityUniform = m_shaderProgram.GetUniformLocation("Gravity");
 }
 
-void ParticlesApplication::Update()
+void ParticlesApplication::FixedUpdate()
 {
-    Application::Update();
+    Application::FixedUpdate();
 
     const Window& window = GetMainWindow();
 
-    // Get the mouse position this frame
-    glm::vec2 mousePosition = window.GetMousePosition(true);
-
     // Emit particles while the left button is pressed
     if (window.IsMouseButtonPressed(Window::MouseButton::Left))
     {
         float size = RandomRange(10.0f, 30.0f);
         float duration = RandomRange(1.0f, 2.0f);
         Color color = RandomColor();
-        glm::vec2 velocity = 0.5f * (mousePosition - m_mousePosition) / GetDeltaTime();
+        glm::vec2 velocity = 0.5f * m_mouseVelocity;
+
+        EmitParticle(m_mousePosition, size, duration, color, velocity);
+    }
+}
+
+void ParticlesApplication::Update()
+{
+    Application::Update();
 
-        EmitParticle(mousePosition, size, duration, color, velocity);
+    const Window& window = GetMainWindow();
+
+    // Get the mouse position this frame
+    glm::vec2 mousePosition = window.GetMousePosition(true);
+
+    // The mouse only moves between frames, compute its velocity here and use it in the next ticks
+    if (GetDeltaTime() > 0.0f)
+    {
+        m_mouseVelocity = (mousePosition - m_mousePosition) / GetDeltaTime();
     }
 
     // save the mouse position (to compare next frame and obtain velocity)
@@ -93,53 +89,69 @@ void ParticlesApplication::Update()
 
 void ParticlesApplication::Render()
 {
+    // Wait until the GPU is done with the particle buffer of this frame, and update it
+    m_frameSync.BeginFrame();
+    UploadParticles();
+
     // Clear background
     GetDevice().Clear(Color(0.0f, 0.0f, 0.0f));
 
     // Set our particles shader program
     m_shaderProgram.Use();
 
-    // Set CurrentTime uniform
-    m_shaderProgram.SetUniform(m_currentTimeUniform, GetCurrentTime());
+    // Set CurrentTime uniform, in simulation time, between the last tick and the next one
+    m_shaderProgram.SetUniform(m_currentTimeUniform, GetSimulationTime() + GetInterpolationFactor() * GetFixedDeltaTime());
 
     // Set Gravity uniform
     m_shaderProgram.SetUniform(m_gravityUniform, -9.8f);
 
     // Bind the particle system VAO
-    m_vao.Bind();
+    m_particleBuffers.Get().vao.Bind();
 
     // Draw points. The amount of points can't exceed the capacity
     glDrawArrays(GL_POINTS, 0, std::min(m_particleCount, m_particleCapacity));
 
+    // The buffer of this frame can't be written again until the GPU passes this point
+    m_frameSync.EndFrame();
+
     Application::Render();
 }
 
 // Nothing to do in this method for this exercise.
-// Change s_vertexAttributes and the Particle struct to add new vertex attributes
+// Change the Particle struct and its layout to add new vertex attributes
 void ParticlesApplication::InitializeGeometry()
 {
-    m_vbo.Bind();
+    // List of attributes of the particle. It doesn't compile if it doesn't match the Particle structure in the header
+    constexpr auto particleLayout = MakeVertexLayout(
+        VertexMember(&Particle::position),
+        VertexMember(&Particle::size),
+        VertexMember(&Particle::birth),
+        VertexMember(&Particle::duration),
+        VertexMember(&Particle::color),
+        VertexMember(&Particle::velocity));
+
+    m_particles.resize(m_particleCapacity);
+
+    for (unsigned int i = 0; i < m_particleBuffers.GetVersionCount(); ++i)
+    {
+        ParticleBuffer& particleBuffer = m_particleBuffers.GetVersion(i);
 
-    // Allocate enough data for all the particles
-    // Notice the DynamicDraw usage, because we will update the buffer every time we emit a particle
-    m_vbo.AllocateData(m_particleCapacity * sizeof(Particle), BufferObject::Usage::DynamicDraw);
+        particleBuffer.vbo.Bind();
 
-    m_vao.Bind();
+        // Allocate enough data for all the particles
+        // Notice the DynamicDraw usage, because we will update the buffer every time we emit a particle
+        particleBuffer.vbo.AllocateData(m_particleCapacity * sizeof(Particle), BufferObject::Usage::DynamicDraw);
 
-    // Automatically iterate through the vertex attributes, and set the pointer
-    // We use interleaved attributes, so the offset is local to the particle, and the stride is the size of the particle
-    GLsizei stride = sizeof(Particle);
-    GLint offset = 0;
-    GLuint location = 0;
-    for (const VertexAttribute& attribute : s_vertexAttributes)
-    {
-        m_vao.SetAttribute(location++, attribute, offset, stride);
-        offset += attribute.GetSize();
-    }
+        particleBuffer.vao.Bind();
 
-    // Unbind VAO and VBO
-    VertexArrayObject::Unbind();
-    VertexBufferObject::Unbind();
+        // Set all the vertex attributes, in consecutive locations
+        // We use interleaved attributes, so the offset is local to the particle, and the stride is the size of the particle
+        particleBuffer.vao.SetAttributes(particleBuffer.vbo, particleLayout);
+
+        // Unbind VAO and VBO
+        VertexArrayObject::Unbind();
+        VertexBufferObject::Unbind();
+    }
 }
 
 // Load, compile and Build shaders
@@ -166,26 +178,46 @@ void ParticlesApplication::EmitParticle(const glm::vec2& position, float size, f
     Particle particle;
     particle.position = position;
     particle.size = size;
-    particle.birth = GetCurrentTime();
+    particle.birth = GetSimulationTime();
     particle.duration = duration;
     particle.color = color;
     particle.velocity = velocity;
 
-    // Get the index in the circular buffer
+    // Store it in the circular buffer. It will be copied to the VBOs when they are used
     unsigned int particleIndex = m_particleCount % m_particleCapacity;
+    m_particles[particleIndex] = particle;
+
+    // Increment the particle count
+    m_particleCount++;
+}
+
+void ParticlesApplication::UploadParticles()
+{
+    ParticleBuffer& particleBuffer = m_particleBuffers.Get();
+
+    // Particles emitted since this buffer was updated. If more than the capacity, all of them changed
+    unsigned int newParticleCount = std::min(m_particleCount - particleBuffer.particleCount, m_particleCapacity);
+    if (newParticleCount == 0)
+    {
+        return;
+    }
 
     // Bind the VBO before updating data
-    m_vbo.Bind();
+    particleBuffer.vbo.Bind();
 
-    // Update the particle data in the VBO
-    int offset = particleIndex * sizeof(Particle);
-    m_vbo.UpdateData(std::span(&particle, 1), offset);
+    // Update the particle data in the VBO, in up to 2 ranges if it wraps around the circular buffer
+    unsigned int firstIndex = (m_particleCount - newParticleCount) % m_particleCapacity;
+    unsigned int firstCount = std::min(newParticleCount, m_particleCapacity - firstIndex);
+    particleBuffer.vbo.UpdateData(std::span(&m_particles[firstIndex], firstCount), firstIndex * sizeof(Particle));
+    if (firstCount < newParticleCount)
+    {
+        particleBuffer.vbo.UpdateData(std::span(&m_particles[0], newParticleCount - firstCount), 0);
+    }
 
     // Unbind the VBO
     VertexBufferObject::Unbind();
 
-    // Increment the particle count
-    m_particleCount++;
+    particleBuffer.particleCount = m_particleCount;
 }
 
 void ParticlesApplication::LoadAndCompileShader(Shader& shader, const char* path)
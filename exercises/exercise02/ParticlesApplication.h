@@ -4,6 +4,8 @@
 #include <ituGL/geometry/VertexBufferObject.h>
 #include <ituGL/geometry/VertexArrayObject.h>
 #include <ituGL/shader/ShaderProgram.h>
+#include <ituGL/core/FrameVersioned.h>
+#include <vector>
 
 class ParticlesApplication : public Application
 {
@@ -12,6 +14,7 @@ public:
 
 protected:
     void Initialize() override;
+    void FixedUpdate() override;
     void Update() override;
     void Render() override;
 
@@ -25,6 +28,9 @@ private:
     // Helper function to encapsulate loading and compiling a shader
     void LoadAndCompileShader(Shader& shader, const char* path);
 
+    // Copy the particles emitted since the last time this buffer was used
+    void UploadParticles();
+
     // Emit a new particle
     void EmitParticle(const glm::vec2& position, float size, float duration, const Color& color, const glm::vec2& velocity);
 
@@ -35,11 +41,35 @@ private:
     static Color RandomColor();
 
 private:
-    // All particles stored in a single VBO with interleaved attributes
-    VertexBufferObject m_vbo;
-
-    // VAO that represents the particle system
-    VertexArrayObject m_vao;
+    // Structure defining that Particle data
+    struct Particle
+    {
+        glm::vec2 position;
+        float size;
+        float birth;
+        float duration;
+        Color color;
+        glm::vec2 velocity;
+    };
+
+    // All particles stored in a single VBO with interleaved attributes, and the VAO that represents the particle system
+    struct ParticleBuffer
+    {
+        VertexBufferObject vbo;
+        VertexArrayObject vao;
+
+        // Value of m_particleCount the last time the buffer was updated
+        unsigned int particleCount = 0;
+    };
+
+    // Fences for the frames that the GPU may still be drawing
+    FrameSync m_frameSync;
+
+    // One particle buffer per frame in flight, so we never write to a buffer the GPU is reading
+    FrameVersioned<ParticleBuffer> m_particleBuffers;
+
+    // CPU copy of the particles, used to update each particle buffer when it is its turn
+    std::vector<Particle> m_particles;
 
     // Particles shader program
     ShaderProgram m_shaderProgram;
@@ -53,6 +83,9 @@ private:
     // Mouse position during this frame
     glm::vec2 m_mousePosition;
 
+    // Mouse velocity during this frame
+    glm::vec2 m_mouseVelocity;
+
     // Total number of particles created
     unsigned int m_particleCount;
 
@@ -2,7 +2,7 @@
 
 #include <ituGL/shader/Shader.h>
 #include <ituGL/shader/ShaderProgram.h>
-#include <ituGL/geometry/VertexFormat.h>
+#include <ituGL/geometry/VertexLayout.h>
 #include <cassert>  // for asserts
 #include <array>    // to get shader error messages
 #include <fstream>  // shader loading
@@ -18,6 +18,8 @@ GearsApplication::GearsApplication()
     , m_worldMatrixUniform(-1)
     , m_viewProjUniform(-1)
 {
+    // Draw in a render thread, while the main thread updates the next frame
+    EnableRenderThread();
 }
 
 void GearsApplication::Initialize()
@@ -58,6 +60,16 @@ void GearsApplication::Update()
 }
 
 void GearsApplication::Render()
+{
+    // Record the frame for the render thread. The frame state is copied, Update keeps changing the camera
+    glm::mat4 viewProjMatrix = m_camera.GetViewProjectionMatrix();
+    float time = GetCurrentTime();
+    GetRenderThread()->Enqueue([this, viewProjMatrix, time] { RenderFrame(viewProjMatrix, time); });
+
+    Application::Render();
+}
+
+void GearsApplication::RenderFrame(const glm::mat4& viewProjMatrix, float time)
 {
     // Clear background
     GetDevice().Clear(true, Color(0.0f, 0.0f, 0.0f), true, 1.0f);
@@ -66,11 +78,10 @@ void GearsApplication::Render()
     m_shaderProgram.Use();
 
     // Set view projection matrix
-    m_shaderProgram.SetUniform(m_viewProjUniform, m_camera.GetViewProjectionMatrix());
+    m_shaderProgram.SetUniform(m_viewProjUniform, viewProjMatrix);
 
     // Global rotation
     float speed = 1.0f;
-    float time = GetCurrentTime();
     glm::vec3 axis(0.0f, 0.0f, 1.0f);
 
     // Draw large gear at the center
@@ -91,8 +102,6 @@ void GearsApplication::Render()
     float linkedRatio = -1.0f;
     glm::mat4 linkedGearMatrix(glm::translate(glm::vec3(0.0f, 0.2f, 0.0f)) * glm::rotate(speed * time * linkedRatio, axis));
     DrawGear(m_smallGear, centerGearMatrix * linkedGearMatrix, Color(0.8f, 0.8f, 0.2f));
-
-    Application::Render();
 }
 
 // Create the meshes that we will use during the exercise
@@ -147,10 +156,10 @@ void GearsApplication::CreateGearMesh(Mesh& mesh, unsigned int cogCount, float i
         glm::vec3 normal;
     };
 
-    // Define the vertex format (should match the vertex structure)
-    VertexFormat vertexFormat;
-    vertexFormat.AddVertexAttribute<float>(3);
-    vertexFormat.AddVertexAttribute<float>(3);
+    // Define the vertex layout from the members of the vertex structure (checked at compile time)
+    constexpr auto vertexLayout = MakeVertexLayout(
+        VertexMember(&Vertex::position, VertexAttribute::Semantic::Position),
+        VertexMember(&Vertex::normal, VertexAttribute::Semantic::Normal));
 
     // List of vertices (VBO)
     std::vector<Vertex> vertices;
@@ -281,8 +290,7 @@ void GearsApplication::CreateGearMesh(Mesh& mesh, unsigned int cogCount, float i
     }
 
     // Finally create the new submesh with all the data
-    mesh.AddSubmesh<Vertex, unsigned short, VertexFormat::LayoutIterator>(Drawcall::Primitive::Triangles, vertices, indices,
-        vertexFormat.LayoutBegin(static_cast<int>(vertices.size()), true /* interleaved */), vertexFormat.LayoutEnd());
+    mesh.AddSubmesh<Vertex, unsigned short>(Drawcall::Primitive::Triangles, vertices, indices, vertexLayout);
 }
 
 void GearsApplication::LoadAndCompileShader(Shader& shader, const char* path)
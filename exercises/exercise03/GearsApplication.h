@@ -31,6 +31,9 @@ private:
     // depth: Size of the cog in Z-coordinate
     void CreateGearMesh(Mesh& mesh, unsigned int cogCount, float innerRadius, float pitchRadius, float addendum, float cogRatio, float depth);
 
+    // Draw the gears. Executed in the render thread, with the state recorded in Render
+    void RenderFrame(const glm::mat4& viewProjMatrix, float time);
+
     // Draw a gear mesh with a specific world matrix and color
     void DrawGear(const Mesh& mesh, const glm::mat4& worldMatrix, const Color& color);
 
@@ -1,6 +1,6 @@
 #include "TexturedTerrainApplication.h"
 
-#include <ituGL/geometry/VertexFormat.h>
+#include <ituGL/geometry/VertexLayout.h>
 #include <ituGL/texture/Texture2DObject.h>
 
 #include <glm/gtx/transform.hpp>  // for matrix transformations
@@ -253,11 +253,11 @@ void TexturedTerrainApplication::CreateTerrainMesh(Mesh& mesh, unsigned int grid
         glm::vec2 texCoord;
     };
 
-    // Define the vertex format (should match the vertex structure)
-    VertexFormat vertexFormat;
-    vertexFormat.AddVertexAttribute<float>(3);
-    vertexFormat.AddVertexAttribute<float>(3);
-    vertexFormat.AddVertexAttribute<float>(2);
+    // Define the vertex layout from the members of the vertex structure (checked at compile time)
+    constexpr auto vertexLayout = MakeVertexLayout(
+        VertexMember(&Vertex::position, VertexAttribute::Semantic::Position),
+        VertexMember(&Vertex::normal, VertexAttribute::Semantic::Normal),
+        VertexMember(&Vertex::texCoord, VertexAttribute::Semantic::TexCoord0));
 
     // List of vertices (VBO)
     std::vector<Vertex> vertices;
@@ -304,6 +304,5 @@ void TexturedTerrainApplication::CreateTerrainMesh(Mesh& mesh, unsigned int grid
         }
     }
 
-    mesh.AddSubmesh<Vertex, unsigned int, VertexFormat::LayoutIterator>(Drawcall::Primitive::Triangles, vertices, indices,
-        vertexFormat.LayoutBegin(static_cast<int>(vertices.size()), true /* interleaved */), vertexFormat.LayoutEnd());
+    mesh.AddSubmesh<Vertex, unsigned int>(Drawcall::Primitive::Triangles, vertices, indices, vertexLayout);
 }
@@ -3,10 +3,12 @@
 #include <ituGL/asset/ShaderLoader.h>
 #include <ituGL/asset/ModelLoader.h>
 #include <ituGL/asset/Texture2DLoader.h>
+#include <ituGL/asset/LazyShaderProgram.h>
 #include <ituGL/shader/Material.h>
 #include <ituGL/renderer/ForwardRenderPass.h>
 #include <ituGL/renderer/GBufferRenderPass.h>
 #include <ituGL/renderer/DeferredRenderPass.h>
+#include <ituGL/scene/Transform.h>
 #include <glm/gtx/transform.hpp>
 #include <imgui.h>
 
@@ -39,6 +41,16 @@ void FirefliesApplication::Initialize()
     DeviceGL& device = GetDevice();
     device.EnableFeature(GL_DEPTH_TEST);
     device.SetVSyncEnabled(true);
+
+    // Move the fireflies at a constant rate, and interpolate them when rendering
+    SetFixedTickRate(60.0f);
+}
+
+void FirefliesApplication::FixedUpdate()
+{
+    Application::FixedUpdate();
+
+    MoveFireflies();
 }
 
 void FirefliesApplication::Update()
@@ -210,12 +222,11 @@ void FirefliesApplication::InitializeDeferredMaterials()
         m_gbufferMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
     }
 
-    // Deferred material
+    // Deferred material shader program. Built the first time it is rendered, the material is created with the g-buffer pass
     {
         std::vector<const char*> vertexShaderPaths;
         vertexShaderPaths.push_back("shaders/version330.glsl");
         vertexShaderPaths.push_back("shaders/deferred.vert");
-        Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
         std::vector<const char*> fragmentShaderPaths;
         fragmentShaderPaths.push_back("shaders/version330.glsl");
@@ -223,40 +234,69 @@ void FirefliesApplication::InitializeDeferredMaterials()
         fragmentShaderPaths.push_back("shaders/blinn-phong.glsl");
         fragmentShaderPaths.push_back("shaders/lighting.glsl");
         fragmentShaderPaths.push_back("shaders/deferred.frag");
-        Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
 
-        std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-        shaderProgramPtr->Build(vertexShader, fragmentShader);
+        m_deferredShaderProgram = std::make_shared<LazyShaderProgram>(m_shaderProgramCache, vertexShaderPaths, fragmentShaderPaths);
+    }
 
-        // Filter out uniforms that are not material properties
-        ShaderUniformCollection::NameSet filteredUniforms;
-        filteredUniforms.insert("InvProjMatrix");
-        filteredUniforms.insert("WorldViewProjMatrix");
+    // Deferred placeholder material, cheap to build and render
+    {
+        std::vector<const char*> vertexShaderPaths;
+        vertexShaderPaths.push_back("shaders/version330.glsl");
+        vertexShaderPaths.push_back("shaders/deferred.vert");
+
+        std::vector<const char*> fragmentShaderPaths;
+        fragmentShaderPaths.push_back("shaders/version330.glsl");
+        fragmentShaderPaths.push_back("shaders/deferred-placeholder.frag");
+
+        std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
+        m_shaderProgramCache.Build(*shaderProgramPtr, vertexShaderPaths, fragmentShaderPaths);
 
         // Get transform related uniform locations
-        ShaderProgram::Location invViewMatrixLocation = shaderProgramPtr->GetUniformLocation("InvViewMatrix");
-        ShaderProgram::Location invProjMatrixLocation = shaderProgramPtr->GetUniformLocation("InvProjMatrix");
         ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
 
-        // Register shader with renderer
+        // Register shader with renderer. Without lighting, it renders in a single pass
         m_renderer.RegisterShaderProgram(shaderProgramPtr,
-            [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+            [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool)
             {
-                if (cameraChanged)
-                {
-                    shaderProgram.SetUniform(invViewMatrixLocation, glm::inverse(camera.GetViewMatrix()));
-                    shaderProgram.SetUniform(invProjMatrixLocation, glm::inverse(camera.GetProjectionMatrix()));
-                }
                 shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
             },
-            GetUpdateLightsFunction(shaderProgramPtr)
+            [](const ShaderProgram&, std::span<const Light* const>, unsigned int& lightIndex) -> bool
+            {
+                return lightIndex++ == 0;
+            }
         );
 
+        // Filter out uniforms that are not material properties
+        ShaderUniformCollection::NameSet filteredUniforms;
+        filteredUniforms.insert("WorldViewProjMatrix");
+
         // Create material
-        m_deferredMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
+        m_deferredPlaceholderMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
     }
 }
 
+void FirefliesApplication::RegisterDeferredShaderProgram(std::shared_ptr<ShaderProgram> shaderProgramPtr)
+{
+    // Get transform related uniform locations
+    ShaderProgram::Location invViewMatrixLocation = shaderProgramPtr->GetUniformLocation("InvViewMatrix");
+    ShaderProgram::Location invProjMatrixLocation = shaderProgramPtr->GetUniformLocation("InvProjMatrix");
+    ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
+
+    // Register shader with renderer
+    m_renderer.RegisterShaderProgram(shaderProgramPtr,
+        [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+        {
+            if (cameraChanged)
+            {
+                shaderProgram.SetUniform(invViewMatrixLocation, glm::inverse(camera.GetViewMatrix()));
+                shaderProgram.SetUniform(invProjMatrixLocation, glm::inverse(camera.GetProjectionMatrix()));
+            }
+            shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
+        },
+        GetUpdateLightsFunction(shaderProgramPtr)
+    );
+}
+
 void FirefliesApplication::InitializeModels()
 {
     std::shared_ptr<Material> material = m_renderMode == RenderMode::Forward ? m_forwardMaterial : m_gbufferMaterial;
@@ -314,11 +354,32 @@ void FirefliesApplication::InitializeRenderer()
             GetMainWindow().GetDimensions(width, height);
             std::unique_ptr<GBufferRenderPass> gbufferRenderPass(std::make_unique<GBufferRenderPass>(width, height));
 
-            // Set the g-buffer textures as properties of the deferred material
-            m_deferredMaterial->SetUniformValue("DepthTexture", gbufferRenderPass->GetDepthTexture());
-            m_deferredMaterial->SetUniformValue("AlbedoTexture", gbufferRenderPass->GetAlbedoTexture());
-            m_deferredMaterial->SetUniformValue("NormalTexture", gbufferRenderPass->GetNormalTexture());
-            m_deferredMaterial->SetUniformValue("OthersTexture", gbufferRenderPass->GetOthersTexture());
+            // The placeholder only needs the albedo
+            m_deferredPlaceholderMaterial->SetUniformValue("AlbedoTexture", gbufferRenderPass->GetAlbedoTexture());
+
+            // Filter out uniforms that are not material properties
+            ShaderUniformCollection::NameSet filteredUniforms;
+            filteredUniforms.insert("InvProjMatrix");
+            filteredUniforms.insert("WorldViewProjMatrix");
+
+            // Create the deferred material, with the placeholder until its shader program is ready
+            // Then register the shader with the renderer and set the g-buffer textures as properties
+            std::shared_ptr<LazyShaderProgram> deferredShaderProgram = m_deferredShaderProgram;
+            std::shared_ptr<Texture2DObject> depthTexture = gbufferRenderPass->GetDepthTexture();
+            std::shared_ptr<Texture2DObject> albedoTexture = gbufferRenderPass->GetAlbedoTexture();
+            std::shared_ptr<Texture2DObject> normalTexture = gbufferRenderPass->GetNormalTexture();
+            std::shared_ptr<Texture2DObject> othersTexture = gbufferRenderPass->GetOthersTexture();
+            m_deferredMaterial = std::make_shared<Material>(
+                [=]() { return deferredShaderProgram->Request(); },
+                m_deferredPlaceholderMaterial, filteredUniforms,
+                [=, this](Material& material)
+                {
+                    RegisterDeferredShaderProgram(material.GetShaderProgram());
+                    material.SetUniformValue("DepthTexture", depthTexture);
+                    material.SetUniformValue("AlbedoTexture", albedoTexture);
+                    material.SetUniformValue("NormalTexture", normalTexture);
+                    material.SetUniformValue("OthersTexture", othersTexture);
+                });
 
             // Add the render passes
             m_renderer.AddRenderPass(std::move(gbufferRenderPass));
@@ -357,10 +418,28 @@ void FirefliesApplication::UpdateFireflies()
     }
 
     m_renderer.AddModel(m_floorModel, glm::mat4(1.0f));
+
+    // Render between the last two ticks
+    float interpolationFactor = GetInterpolationFactor();
+    for (Firefly& firefly : m_fireflies)
+    {
+        glm::mat4 worldMatrix = Transform::Interpolate(firefly.previousWorldMatrix, firefly.worldMatrix, interpolationFactor);
+
+        // Copy the position to the light
+        firefly.pointLight.SetPosition(worldMatrix[3]);
+
+        m_renderer.AddModel(m_fireflyModel, worldMatrix);
+        m_renderer.AddLight(firefly.pointLight);
+    }
+}
+
+void FirefliesApplication::MoveFireflies()
+{
+    float deltaTime = GetFixedDeltaTime();
     for (Firefly& firefly : m_fireflies)
     {
-        float deltaTime = GetDeltaTime();
         glm::mat4& worldMatrix = firefly.worldMatrix;
+        firefly.previousWorldMatrix = worldMatrix;
 
         // Rotate a random angle
         firefly.rotationSpeed += RandomRange(-0.25f, 0.25f);
@@ -369,12 +448,6 @@ void FirefliesApplication::UpdateFireflies()
 
         // Advance in forward direction
         worldMatrix[3] += -worldMatrix[2] * 2.0f * deltaTime;
-
-        // Copy the position to the light
-        firefly.pointLight.SetPosition(worldMatrix[3]);
-
-        m_renderer.AddModel(m_fireflyModel, firefly.worldMatrix);
-        m_renderer.AddLight(firefly.pointLight);
     }
 }
 
@@ -392,6 +465,7 @@ void FirefliesApplication::AddFirefly(glm::vec2 position2D)
     pointLight.SetDistanceAttenuation(glm::vec2(1.0f, 2.0f));
 
     firefly.worldMatrix = glm::translate(position3D) * glm::rotate(RandomRange(-3.1416f, 3.1416f), glm::vec3(0, 1, 0)) * glm::scale(glm::vec3(0.25f));
+    firefly.previousWorldMatrix = firefly.worldMatrix;
 
     firefly.rotationSpeed = 0.0f;
 }
@@ -2,6 +2,7 @@
 
 #include <ituGL/application/Application.h>
 
+#include <ituGL/asset/ShaderProgramCache.h>
 #include <ituGL/camera/Camera.h>
 #include <ituGL/geometry/Model.h>
 #include <ituGL/lighting/PointLight.h>
@@ -11,6 +12,7 @@
 
 class Texture2DObject;
 class Light;
+class LazyShaderProgram;
 
 class FirefliesApplication : public Application
 {
@@ -19,6 +21,7 @@ public:
 
 protected:
     void Initialize() override;
+    void FixedUpdate() override;
     void Update() override;
     void Render() override;
     void Cleanup() override;
@@ -31,9 +34,12 @@ private:
     void InitializeLights();
     void InitializeRenderer();
 
+    void RegisterDeferredShaderProgram(std::shared_ptr<ShaderProgram> shaderProgramPtr);
+
     Renderer::UpdateLightsFunction GetUpdateLightsFunction(std::shared_ptr<ShaderProgram> shaderProgramPtr);
 
     void UpdateFireflies();
+    void MoveFireflies();
 
     void AddFirefly(glm::vec2 position);
 
@@ -57,11 +63,19 @@ private:
     // Camera controller parameters
     Camera m_camera;
 
+    // Linked shader programs stored on disk, and the programs still building
+    ShaderProgramCache m_shaderProgramCache;
+
     // Default materials
     std::shared_ptr<Material> m_forwardMaterial;
     std::shared_ptr<Material> m_gbufferMaterial;
     std::shared_ptr<Material> m_deferredMaterial;
 
+    // Deferred lighting program, only built when the deferred pass renders for the first time
+    // Until it is ready, the placeholder material shows the unlit albedo
+    std::shared_ptr<LazyShaderProgram> m_deferredShaderProgram;
+    std::shared_ptr<Material> m_deferredPlaceholderMaterial;
+
     // Loaded models
     Model m_floorModel;
     Model m_fireflyModel;
@@ -71,6 +85,8 @@ private:
     {
         PointLight pointLight;
         glm::mat4 worldMatrix;
+        // World matrix in the previous tick, to interpolate
+        glm::mat4 previousWorldMatrix;
         float rotationSpeed;
     };
     std::vector<Firefly> m_fireflies;
@@ -0,0 +1,14 @@
+//Inputs
+in vec2 TexCoord;
+
+//Outputs
+out vec4 FragColor;
+
+//Uniforms
+uniform sampler2D AlbedoTexture;
+
+void main()
+{
+	// Unlit albedo, while the deferred lighting shader is building
+	FragColor = vec4(texture(AlbedoTexture, TexCoord).rgb, 1.0f);
+}
@@ -13,6 +13,7 @@
 
 #include <ituGL/shader/ShaderUniformCollection.h>
 #include <ituGL/shader/Material.h>
+#include <ituGL/shader/UniformBufferArena.h>
 #include <ituGL/geometry/Model.h>
 #include <ituGL/scene/SceneModel.h>
 
@@ -41,6 +42,9 @@ void SceneViewerApplication::Initialize()
     InitializeMaterial();
     InitializeModels();
     InitializeRenderer();
+
+    // Don't let the driver queue frames, so the camera responds to the latest input
+    GetFramePacer().SetMaxFramesInFlight(1);
 }
 
 void SceneViewerApplication::Update()
@@ -127,24 +131,8 @@ void SceneViewerApplication::InitializeMaterial()
     std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
     shaderProgramPtr->Build(vertexShader, fragmentShader);
 
-    // Get transform related uniform locations
-    ShaderProgram::Location cameraPositionLocation = shaderProgramPtr->GetUniformLocation("CameraPosition");
-    ShaderProgram::Location worldMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldMatrix");
-    ShaderProgram::Location viewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("ViewProjMatrix");
-
-    // Register shader with renderer
-    m_renderer.RegisterShaderProgram(shaderProgramPtr,
-        [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
-        {
-            if (cameraChanged)
-            {
-                shaderProgram.SetUniform(cameraPositionLocation, camera.ExtractTranslation());
-                shaderProgram.SetUniform(viewProjMatrixLocation, camera.GetViewProjectionMatrix());
-            }
-            shaderProgram.SetUniform(worldMatrixLocation, worldMatrix);
-        },
-        m_renderer.GetDefaultUpdateLightsFunction(*shaderProgramPtr)
-    );
+    // Register shader with renderer. Transform and light uniforms are bound by name
+    m_renderer.RegisterShaderProgram(shaderProgramPtr, ShaderBindingTable(*shaderProgramPtr));
 
     // Filter out uniforms that are not material properties
     ShaderUniformCollection::NameSet filteredUniforms;
@@ -160,6 +148,10 @@ void SceneViewerApplication::InitializeMaterial()
     // Create reference material
     assert(shaderProgramPtr);
     m_defaultMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
+
+    // Material parameters are stored in a range of the arena. The copies made by the model loader get their own range
+    m_materialArena = std::make_shared<UniformBufferArena>();
+    m_defaultMaterial->SetUniformBlock("MaterialBlock", 0, m_materialArena);
 }
 
 void SceneViewerApplication::InitializeModels()
@@ -186,6 +178,11 @@ void SceneViewerApplication::InitializeModels()
     // Flip vertically textures loaded by the model loader
     loader.GetTexture2DLoader().SetFlipVertical(true);
 
+    // All the model textures share the same trilinear sampler
+    SamplerObject::State samplerState;
+    samplerState.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    loader.SetTextureSampler(m_samplerCache.GetSampler(samplerState));
+
     // Link vertex properties to attributes
     loader.SetMaterialAttribute(VertexAttribute::Semantic::Position, "VertexPosition");
     loader.SetMaterialAttribute(VertexAttribute::Semantic::Normal, "VertexNormal");
@@ -230,5 +227,38 @@ void SceneViewerApplication::RenderGUI()
     // Draw GUI for camera controller
     m_cameraController.DrawGUI(m_imGui);
 
+    // Draw GUI for frame pacing
+    if (auto window = m_imGui.UseWindow("Frame pacing"))
+    {
+        FramePacer& framePacer = GetFramePacer();
+
+        int maxFramesInFlight = framePacer.GetMaxFramesInFlight();
+        if (ImGui::SliderInt("Max frames in flight", &maxFramesInFlight, 0, 3))
+        {
+            framePacer.SetMaxFramesInFlight(maxFramesInFlight);
+        }
+
+        float targetFrameRate = framePacer.GetTargetFrameRate();
+        if (ImGui::SliderFloat("Frame rate cap", &targetFrameRate, 0.0f, 240.0f))
+        {
+            framePacer.SetTargetFrameRate(targetFrameRate);
+        }
+
+        const FramePacer::LatencyStats& latencyStats = framePacer.GetLatencyStats();
+        ImGui::Text("Input latency: %.1f ms (avg %.1f ms, max %.1f ms)", latencyStats.last * 1000.0f, latencyStats.average * 1000.0f, latencyStats.max * 1000.0f);
+    }
+
+    // Draw GUI for the texture binding stats of the last frame
+    if (auto window = m_imGui.UseWindow("Binding stats"))
+    {
+        const DeviceGL::BindingStats& bindingStats = GetDevice().GetBindingStats();
+        ImGui::Text("Texture binds: %u (elided %u)", bindingStats.textureBindCount, bindingStats.elidedTextureBindCount);
+        ImGui::Text("Active texture changes: %u (elided %u)", bindingStats.activeTextureCount, bindingStats.elidedActiveTextureCount);
+        ImGui::Text("Sampler binds: %u (elided %u)", bindingStats.samplerBindCount, bindingStats.elidedSamplerBindCount);
+        ImGui::Text("Sampler uniforms: %u (elided %u)", bindingStats.samplerUniformCount, bindingStats.elidedSamplerUniformCount);
+        ImGui::Text("Uniform buffer binds: %u (elided %u)", bindingStats.uniformBufferBindCount, bindingStats.elidedUniformBufferBindCount);
+    }
+    GetDevice().ResetBindingStats();
+
     m_imGui.EndFrame();
 }
@@ -6,9 +6,11 @@
 #include <ituGL/renderer/Renderer.h>
 #include <ituGL/camera/CameraController.h>
 #include <ituGL/utils/DearImGui.h>
+#include <ituGL/texture/SamplerCache.h>
 
 class TextureCubemapObject;
 class Material;
+class UniformBufferArena;
 
 class SceneViewerApplication : public Application
 {
@@ -48,4 +50,10 @@ private:
 
     // Default material
     std::shared_ptr<Material> m_defaultMaterial;
+
+    // Samplers shared by all the materials
+    SamplerCache m_samplerCache;
+
+    // Uniform buffer where the materials store their MaterialBlock
+    std::shared_ptr<UniformBufferArena> m_materialArena;
 };
@@ -9,7 +9,10 @@ in vec2 TexCoord;
 out vec4 FragColor;
 
 //Uniforms
-uniform vec3 Color;
+uniform MaterialBlock
+{
+	vec3 Color;
+};
 uniform sampler2D ColorTexture;
 uniform sampler2D NormalTexture;
 uniform sampler2D SpecularTexture;
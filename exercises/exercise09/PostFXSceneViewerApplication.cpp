@@ -1,7 +1,6 @@
 #include "PostFXSceneViewerApplication.h"
 
 #include <ituGL/asset/TextureCubemapLoader.h>
-#include <ituGL/asset/ShaderLoader.h>
 #include <ituGL/asset/ModelLoader.h>
 
 #include <ituGL/camera/Camera.h>
@@ -13,6 +12,7 @@
 
 #include <ituGL/shader/ShaderUniformCollection.h>
 #include <ituGL/shader/Material.h>
+#include <ituGL/shader/ProgramPipeline.h>
 #include <ituGL/geometry/Model.h>
 #include <ituGL/scene/SceneModel.h>
 
@@ -21,7 +21,6 @@
 #include <ituGL/renderer/DeferredRenderPass.h>
 #include <ituGL/renderer/ShadowMapRenderPass.h>
 #include <ituGL/renderer/PostFXRenderPass.h>
-#include <ituGL/scene/RendererSceneVisitor.h>
 
 #include <ituGL/scene/ImGuiSceneVisitor.h>
 #include <imgui.h>
@@ -29,6 +28,8 @@
 PostFXSceneViewerApplication::PostFXSceneViewerApplication()
     : Application(1024, 1024, "Post FX Scene Viewer demo")
     , m_renderer(GetDevice())
+    , m_rendererSceneCollector(m_renderer, m_jobSystem)
+    , m_shaderVariantCache(m_shaderProgramCache)
     , m_sceneFramebuffer(std::make_shared<FramebufferObject>())
     , m_exposure(1.0f)
     , m_contrast(1.0f)
@@ -63,8 +64,7 @@ void PostFXSceneViewerApplication::Update()
     m_cameraController.Update(GetMainWindow(), GetDeltaTime());
 
     // Add the scene nodes to the renderer
-    RendererSceneVisitor rendererSceneVisitor(m_renderer);
-    m_scene.AcceptVisitor(rendererSceneVisitor);
+    m_rendererSceneCollector.Collect(m_scene);
 }
 
 void PostFXSceneViewerApplication::Render()
@@ -130,15 +130,13 @@ void PostFXSceneViewerApplication::InitializeMaterials()
         std::vector<const char*> vertexShaderPaths;
         vertexShaderPaths.push_back("shaders/version330.glsl");
         vertexShaderPaths.push_back("shaders/renderer/empty.vert");
-        Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
         std::vector<const char*> fragmentShaderPaths;
         fragmentShaderPaths.push_back("shaders/version330.glsl");
         fragmentShaderPaths.push_back("shaders/renderer/empty.frag");
-        Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
 
         std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-        shaderProgramPtr->Build(vertexShader, fragmentShader);
+        m_shaderProgramCache.Build(*shaderProgramPtr, vertexShaderPaths, fragmentShaderPaths);
 
         // Get transform related uniform locations
         ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
@@ -167,16 +165,14 @@ void PostFXSceneViewerApplication::InitializeMaterials()
         std::vector<const char*> vertexShaderPaths;
         vertexShaderPaths.push_back("shaders/version330.glsl");
         vertexShaderPaths.push_back("shaders/default.vert");
-        Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
         std::vector<const char*> fragmentShaderPaths;
         fragmentShaderPaths.push_back("shaders/version330.glsl");
         fragmentShaderPaths.push_back("shaders/utils.glsl");
         fragmentShaderPaths.push_back("shaders/default.frag");
-        Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
 
         std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-        shaderProgramPtr->Build(vertexShader, fragmentShader);
+        m_shaderProgramCache.Build(*shaderProgramPtr, vertexShaderPaths, fragmentShaderPaths);
 
         // Get transform related uniform locations
         ShaderProgram::Location worldViewMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewMatrix");
@@ -202,56 +198,13 @@ void PostFXSceneViewerApplication::InitializeMaterials()
         m_defaultMaterial->SetUniformValue("Color", glm::vec3(1.0f));
     }
 
-    // Deferred material
+    // Deferred materials: the main light casts shadows, use the variant that includes them
+    // The other lights use a variant without the shadow code, instead of checking LightShadowEnabled for each pixel
     {
-        std::vector<const char*> vertexShaderPaths;
-        vertexShaderPaths.push_back("shaders/version330.glsl");
-        vertexShaderPaths.push_back("shaders/renderer/deferred.vert");
-        Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
-
-        std::vector<const char*> fragmentShaderPaths;
-        fragmentShaderPaths.push_back("shaders/version330.glsl");
-        fragmentShaderPaths.push_back("shaders/utils.glsl");
-        fragmentShaderPaths.push_back("shaders/lambert-ggx.glsl");
-        fragmentShaderPaths.push_back("shaders/lighting.glsl");
-        fragmentShaderPaths.push_back("shaders/renderer/deferred.frag");
-        Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
-
-        std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-        shaderProgramPtr->Build(vertexShader, fragmentShader);
-
-        // Filter out uniforms that are not material properties
-        ShaderUniformCollection::NameSet filteredUniforms;
-        filteredUniforms.insert("InvViewMatrix");
-        filteredUniforms.insert("InvProjMatrix");
-        filteredUniforms.insert("WorldViewProjMatrix");
-        filteredUniforms.insert("LightIndirect");
-        filteredUniforms.insert("LightColor");
-        filteredUniforms.insert("LightPosition");
-        filteredUniforms.insert("LightDirection");
-        filteredUniforms.insert("LightAttenuation");
-
-        // Get transform related uniform locations
-        ShaderProgram::Location invViewMatrixLocation = shaderProgramPtr->GetUniformLocation("InvViewMatrix");
-        ShaderProgram::Location invProjMatrixLocation = shaderProgramPtr->GetUniformLocation("InvProjMatrix");
-        ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
-
-        // Register shader with renderer
-        m_renderer.RegisterShaderProgram(shaderProgramPtr,
-            [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
-            {
-                if (cameraChanged)
-                {
-                    shaderProgram.SetUniform(invViewMatrixLocation, glm::inverse(camera.GetViewMatrix()));
-                    shaderProgram.SetUniform(invProjMatrixLocation, glm::inverse(camera.GetProjectionMatrix()));
-                }
-                shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
-            },
-            m_renderer.GetDefaultUpdateLightsFunction(*shaderProgramPtr)
-        );
-
-        // Create material
-        m_deferredMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
+        ShaderVariantCache::KeywordSet keywords;
+        keywords.insert("SHADOWS");
+        m_deferredMaterial = CreateDeferredMaterial(keywords);
+        m_deferredNoShadowMaterial = CreateDeferredMaterial(ShaderVariantCache::KeywordSet());
     }
 }
 
@@ -265,8 +218,11 @@ void PostFXSceneViewerApplication::InitializeModels()
     TextureCubemapObject::Unbind();
 
     // Set the environment texture on the deferred material
-    m_deferredMaterial->SetUniformValue("EnvironmentTexture", m_skyboxTexture);
-    m_deferredMaterial->SetUniformValue("EnvironmentMaxLod", maxLod);
+    for (Material* deferredMaterial : { m_deferredMaterial.get(), m_deferredNoShadowMaterial.get() })
+    {
+        deferredMaterial->SetUniformValue("EnvironmentTexture", m_skyboxTexture);
+        deferredMaterial->SetUniformValue("EnvironmentMaxLod", maxLod);
+    }
 
     // Configure loader
     ModelLoader loader(m_defaultMaterial);
@@ -277,6 +233,9 @@ void PostFXSceneViewerApplication::InitializeModels()
     // Flip vertically textures loaded by the model loader
     loader.GetTexture2DLoader().SetFlipVertical(true);
 
+    // Collect the mesh data and decode the textures in the worker threads
+    loader.SetJobSystem(&m_jobSystem);
+
     // Link vertex properties to attributes
     loader.SetMaterialAttribute(VertexAttribute::Semantic::Position, "VertexPosition");
     loader.SetMaterialAttribute(VertexAttribute::Semantic::Normal, "VertexNormal");
@@ -357,18 +316,23 @@ void PostFXSceneViewerApplication::InitializeRenderer()
     {
         std::unique_ptr<GBufferRenderPass> gbufferRenderPass(std::make_unique<GBufferRenderPass>(width, height));
 
-        // Set the g-buffer textures as properties of the deferred material
-        m_deferredMaterial->SetUniformValue("DepthTexture", gbufferRenderPass->GetDepthTexture());
-        m_deferredMaterial->SetUniformValue("AlbedoTexture", gbufferRenderPass->GetAlbedoTexture());
-        m_deferredMaterial->SetUniformValue("NormalTexture", gbufferRenderPass->GetNormalTexture());
-        m_deferredMaterial->SetUniformValue("OthersTexture", gbufferRenderPass->GetOthersTexture());
+        // Set the g-buffer textures as properties of the deferred materials
+        for (Material* deferredMaterial : { m_deferredMaterial.get(), m_deferredNoShadowMaterial.get() })
+        {
+            deferredMaterial->SetUniformValue("DepthTexture", gbufferRenderPass->GetDepthTexture());
+            deferredMaterial->SetUniformValue("AlbedoTexture", gbufferRenderPass->GetAlbedoTexture());
+            deferredMaterial->SetUniformValue("NormalTexture", gbufferRenderPass->GetNormalTexture());
+            deferredMaterial->SetUniformValue("OthersTexture", gbufferRenderPass->GetOthersTexture());
+        }
 
         // Get the depth texture from the gbuffer pass - This could be reworked
         m_depthTexture = gbufferRenderPass->GetDepthTexture();
 
         // Add the render passes
         m_renderer.AddRenderPass(std::move(gbufferRenderPass));
-        m_renderer.AddRenderPass(std::make_unique<DeferredRenderPass>(m_deferredMaterial, m_sceneFramebuffer));
+        std::unique_ptr<DeferredRenderPass> deferredRenderPass(std::make_unique<DeferredRenderPass>(m_deferredMaterial, m_sceneFramebuffer));
+        deferredRenderPass->SetNoShadowMaterial(m_deferredNoShadowMaterial);
+        m_renderer.AddRenderPass(std::move(deferredRenderPass));
     }
 
     // Initialize the framebuffers and the textures they use
@@ -377,20 +341,37 @@ void PostFXSceneViewerApplication::InitializeRenderer()
     // Skybox pass
     m_renderer.AddRenderPass(std::make_unique<SkyboxRenderPass>(m_skyboxTexture));
 
+    // Submit all the post-processing programs at once, so the driver can compile them in parallel
+    // They are separable: the fullscreen vertex stage is linked once, and each pass only links its fragment stage
+    m_shaderProgramCache.BeginBatch();
+    {
+        std::vector<const char*> vertexShaderPaths;
+        vertexShaderPaths.push_back("shaders/version330.glsl");
+        vertexShaderPaths.push_back("shaders/renderer/fullscreen.vert");
+
+        m_fullscreenShaderProgram = std::make_shared<ShaderProgram>();
+        m_shaderProgramCache.BuildSeparable(*m_fullscreenShaderProgram, Shader::VertexShader, vertexShaderPaths);
+    }
+    std::shared_ptr<ShaderProgram> copyShaderProgram = CreatePostFXShaderProgram("shaders/postfx/copy.frag");
+    std::shared_ptr<ShaderProgram> bloomShaderProgram = CreatePostFXShaderProgram("shaders/postfx/bloom.frag");
+    std::shared_ptr<ShaderProgram> blurShaderProgram = CreatePostFXShaderProgram("shaders/postfx/blur.frag");
+    std::shared_ptr<ShaderProgram> composeShaderProgram = CreatePostFXShaderProgram("shaders/postfx/compose.frag");
+    m_shaderProgramCache.EndBatch();
+
     // Create a copy pass from m_sceneTexture to the first temporary texture
-    std::shared_ptr<Material> copyMaterial = CreatePostFXMaterial("shaders/postfx/copy.frag", m_sceneTexture);
+    std::shared_ptr<Material> copyMaterial = CreatePostFXMaterial(copyShaderProgram, m_sceneTexture);
     m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(copyMaterial, m_tempFramebuffers[0]));
 
     // Replace the copy pass with a new bloom pass
-    m_bloomMaterial = CreatePostFXMaterial("shaders/postfx/bloom.frag", m_sceneTexture);
+    m_bloomMaterial = CreatePostFXMaterial(bloomShaderProgram, m_sceneTexture);
     m_bloomMaterial->SetUniformValue("Range", glm::vec2(2.0f, 3.0f));
     m_bloomMaterial->SetUniformValue("Intensity", 1.0f);
     m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(m_bloomMaterial, m_tempFramebuffers[0]));
 
     // Add blur passes
-    std::shared_ptr<Material> blurHorizontalMaterial = CreatePostFXMaterial("shaders/postfx/blur.frag", m_tempTextures[0]);
+    std::shared_ptr<Material> blurHorizontalMaterial = CreatePostFXMaterial(blurShaderProgram, m_tempTextures[0]);
     blurHorizontalMaterial->SetUniformValue("Scale", glm::vec2(1.0f / width, 0.0f));
-    std::shared_ptr<Material> blurVerticalMaterial = CreatePostFXMaterial("shaders/postfx/blur.frag", m_tempTextures[1]);
+    std::shared_ptr<Material> blurVerticalMaterial = CreatePostFXMaterial(blurShaderProgram, m_tempTextures[1]);
     blurVerticalMaterial->SetUniformValue("Scale", glm::vec2(0.0f, 1.0f / height));
     for (int i = 0; i < m_blurIterations; ++i)
     {
@@ -399,7 +380,7 @@ void PostFXSceneViewerApplication::InitializeRenderer()
     }
 
     // Final pass
-    m_composeMaterial = CreatePostFXMaterial("shaders/postfx/compose.frag", m_sceneTexture);
+    m_composeMaterial = CreatePostFXMaterial(composeShaderProgram, m_sceneTexture);
 
     // Set exposure uniform default value
     m_composeMaterial->SetUniformValue("Exposure", m_exposure);
@@ -416,25 +397,78 @@ void PostFXSceneViewerApplication::InitializeRenderer()
     m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(m_composeMaterial, m_renderer.GetDefaultFramebuffer()));
 }
 
-std::shared_ptr<Material> PostFXSceneViewerApplication::CreatePostFXMaterial(const char* fragmentShaderPath, std::shared_ptr<Texture2DObject> sourceTexture)
+std::shared_ptr<Material> PostFXSceneViewerApplication::CreateDeferredMaterial(const ShaderVariantCache::KeywordSet& keywords)
 {
-    // We could keep this vertex shader and reuse it, but it looks simpler this way
     std::vector<const char*> vertexShaderPaths;
     vertexShaderPaths.push_back("shaders/version330.glsl");
-    vertexShaderPaths.push_back("shaders/renderer/fullscreen.vert");
-    Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
+    vertexShaderPaths.push_back("shaders/renderer/deferred.vert");
+
+    std::vector<const char*> fragmentShaderPaths;
+    fragmentShaderPaths.push_back("shaders/version330.glsl");
+    fragmentShaderPaths.push_back("shaders/utils.glsl");
+    fragmentShaderPaths.push_back("shaders/lambert-ggx.glsl");
+    fragmentShaderPaths.push_back("shaders/lighting.glsl");
+    fragmentShaderPaths.push_back("shaders/renderer/deferred.frag");
+
+    std::shared_ptr<ShaderProgram> shaderProgramPtr = m_shaderVariantCache.GetShaderProgram(vertexShaderPaths, fragmentShaderPaths, keywords);
+
+    // Filter out uniforms that are not material properties
+    ShaderUniformCollection::NameSet filteredUniforms;
+    filteredUniforms.insert("InvViewMatrix");
+    filteredUniforms.insert("InvProjMatrix");
+    filteredUniforms.insert("WorldViewProjMatrix");
+    filteredUniforms.insert("LightIndirect");
+    filteredUniforms.insert("LightColor");
+    filteredUniforms.insert("LightPosition");
+    filteredUniforms.insert("LightDirection");
+    filteredUniforms.insert("LightAttenuation");
+
+    // Get transform related uniform locations
+    ShaderProgram::Location invViewMatrixLocation = shaderProgramPtr->GetUniformLocation("InvViewMatrix");
+    ShaderProgram::Location invProjMatrixLocation = shaderProgramPtr->GetUniformLocation("InvProjMatrix");
+    ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
+
+    // Register shader with renderer
+    m_renderer.RegisterShaderProgram(shaderProgramPtr,
+        [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+        {
+            if (cameraChanged)
+            {
+                shaderProgram.SetUniform(invViewMatrixLocation, glm::inverse(camera.GetViewMatrix()));
+                shaderProgram.SetUniform(invProjMatrixLocation, glm::inverse(camera.GetProjectionMatrix()));
+            }
+            shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
+        },
+        m_renderer.GetDefaultUpdateLightsFunction(*shaderProgramPtr)
+    );
 
+    // Create material
+    return std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
+}
+
+std::shared_ptr<ShaderProgram> PostFXSceneViewerApplication::CreatePostFXShaderProgram(const char* fragmentShaderPath)
+{
     std::vector<const char*> fragmentShaderPaths;
     fragmentShaderPaths.push_back("shaders/version330.glsl");
     fragmentShaderPaths.push_back("shaders/utils.glsl");
     fragmentShaderPaths.push_back(fragmentShaderPath);
-    Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
 
     std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-    shaderProgramPtr->Build(vertexShader, fragmentShader);
+    m_shaderProgramCache.BuildSeparable(*shaderProgramPtr, Shader::FragmentShader, fragmentShaderPaths);
+
+    return shaderProgramPtr;
+}
+
+std::shared_ptr<Material> PostFXSceneViewerApplication::CreatePostFXMaterial(std::shared_ptr<ShaderProgram> shaderProgramPtr, std::shared_ptr<Texture2DObject> sourceTexture)
+{
+    // Combine the fragment stage with the shared fullscreen vertex stage
+    std::shared_ptr<ProgramPipeline> programPipeline = std::make_shared<ProgramPipeline>();
+    programPipeline->SetStages(ProgramPipeline::VertexStage, m_fullscreenShaderProgram);
+    programPipeline->SetStages(ProgramPipeline::FragmentStage, shaderProgramPtr);
 
     // Create material
     std::shared_ptr<Material> material = std::make_shared<Material>(shaderProgramPtr);
+    material->SetProgramPipeline(programPipeline);
     material->SetUniformValue("SourceTexture", sourceTexture);
     
     return material;
@@ -5,6 +5,9 @@
 #include <ituGL/scene/Scene.h>
 #include <ituGL/texture/FramebufferObject.h>
 #include <ituGL/renderer/Renderer.h>
+#include <ituGL/core/JobSystem.h>
+#include <ituGL/scene/RendererSceneCollector.h>
+#include <ituGL/asset/ShaderVariantCache.h>
 #include <ituGL/camera/CameraController.h>
 #include <ituGL/utils/DearImGui.h>
 #include <array>
@@ -33,7 +36,10 @@ private:
     void InitializeFramebuffers();
     void InitializeRenderer();
 
-    std::shared_ptr<Material> CreatePostFXMaterial(const char* fragmentShaderPath, std::shared_ptr<Texture2DObject> sourceTexture = nullptr);
+    std::shared_ptr<Material> CreateDeferredMaterial(const ShaderVariantCache::KeywordSet& keywords);
+
+    std::shared_ptr<ShaderProgram> CreatePostFXShaderProgram(const char* fragmentShaderPath);
+    std::shared_ptr<Material> CreatePostFXMaterial(std::shared_ptr<ShaderProgram> shaderProgramPtr, std::shared_ptr<Texture2DObject> sourceTexture = nullptr);
 
     Renderer::UpdateTransformsFunction GetFullscreenTransformFunction(std::shared_ptr<ShaderProgram> shaderProgramPtr) const;
 
@@ -52,6 +58,18 @@ private:
     // Renderer
     Renderer m_renderer;
 
+    // Worker threads, used to load the models and to collect the scene drawcalls
+    JobSystem m_jobSystem;
+
+    // Adds the scene nodes to the renderer
+    RendererSceneCollector m_rendererSceneCollector;
+
+    // Shader programs are loaded from the binaries of previous runs, when the sources didn't change
+    ShaderProgramCache m_shaderProgramCache;
+
+    // Programs built with different keywords, from the same sources
+    ShaderVariantCache m_shaderVariantCache;
+
     // Skybox texture
     std::shared_ptr<TextureCubemapObject> m_skyboxTexture;
 
@@ -61,10 +79,14 @@ private:
     // Materials
     std::shared_ptr<Material> m_defaultMaterial;
     std::shared_ptr<Material> m_deferredMaterial;
+    std::shared_ptr<Material> m_deferredNoShadowMaterial;
     std::shared_ptr<Material> m_shadowMapMaterial;
     std::shared_ptr<Material> m_composeMaterial;
     std::shared_ptr<Material> m_bloomMaterial;
 
+    // Separable vertex stage shared by all the post-processing materials
+    std::shared_ptr<ShaderProgram> m_fullscreenShaderProgram;
+
     // Framebuffers
     std::shared_ptr<FramebufferObject> m_sceneFramebuffer;
     std::shared_ptr<Texture2DObject> m_depthTexture;
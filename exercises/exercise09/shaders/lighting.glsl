@@ -1,3 +1,5 @@
+// Uses GetDirection from utils
+#include "utils.glsl"
 
 uniform bool LightIndirect;
 uniform vec3 LightColor;
@@ -5,10 +7,13 @@ uniform vec3 LightPosition;
 uniform vec3 LightDirection;
 uniform vec4 LightAttenuation;
 
+// Shadow code is only compiled in the SHADOWS variant
+#ifdef SHADOWS
 uniform bool LightShadowEnabled;
 uniform sampler2DShadow LightShadowMap;
 uniform mat4 LightShadowMatrix;
 uniform float LightShadowBias;
+#endif
 
 float ComputeDistanceAttenuation(vec3 position)
 {
@@ -40,6 +45,7 @@ float ComputeAttenuation(vec3 position, vec3 lightDir)
 float ComputeShadow(vec3 position)
 {
 	float shadow = 1.0f;
+#ifdef SHADOWS
 	if (LightShadowEnabled)
 	{
 		// Transform position to light space
@@ -57,6 +63,7 @@ float ComputeShadow(vec3 position)
 		// Sample shadow texture
 		shadow = texture(LightShadowMap, lightSpacePosition.xyz);
 	}
+#endif
 	return shadow;
 }
 
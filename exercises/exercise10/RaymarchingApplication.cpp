@@ -1,6 +1,5 @@
 #include "RaymarchingApplication.h"
 
-#include <ituGL/asset/ShaderLoader.h>
 #include <ituGL/camera/Camera.h>
 #include <ituGL/scene/SceneCamera.h>
 #include <ituGL/lighting/DirectionalLight.h>
@@ -106,7 +105,6 @@ std::shared_ptr<Material> RaymarchingApplication::CreateRaymarchingMaterial(cons
     std::vector<const char*> vertexShaderPaths;
     vertexShaderPaths.push_back("shaders/version330.glsl");
     vertexShaderPaths.push_back("shaders/renderer/fullscreen.vert");
-    Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
     std::vector<const char*> fragmentShaderPaths;
     fragmentShaderPaths.push_back("shaders/version330.glsl");
@@ -115,10 +113,9 @@ std::shared_ptr<Material> RaymarchingApplication::CreateRaymarchingMaterial(cons
     fragmentShaderPaths.push_back("shaders/raymarcher.glsl");
     fragmentShaderPaths.push_back(fragmentShaderPath);
     fragmentShaderPaths.push_back("shaders/raymarching.frag");
-    Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
 
     std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-    shaderProgramPtr->Build(vertexShader, fragmentShader);
+    m_shaderProgramCache.Build(*shaderProgramPtr, vertexShaderPaths, fragmentShaderPaths);
 
     // Create material
     std::shared_ptr<Material> material = std::make_shared<Material>(shaderProgramPtr);
@@ -3,6 +3,7 @@
 #include <ituGL/application/Application.h>
 
 #include <ituGL/renderer/Renderer.h>
+#include <ituGL/asset/ShaderProgramCache.h>
 #include <ituGL/camera/CameraController.h>
 #include <ituGL/utils/DearImGui.h>
 
@@ -38,6 +39,9 @@ private:
     // Renderer
     Renderer m_renderer;
 
+    // Shader programs are loaded from the binaries of previous runs, when the sources didn't change
+    ShaderProgramCache m_shaderProgramCache;
+
     // Materials
     std::shared_ptr<Material> m_material;
 };
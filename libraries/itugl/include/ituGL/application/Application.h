@@ -2,7 +2,10 @@
 
 #include <ituGL/core/DeviceGL.h>
 #include <ituGL/application/Window.h>
+#include <ituGL/application/RenderThread.h>
+#include <ituGL/application/FramePacer.h>
 #include <string>
+#include <memory>
 
 class Application
 {
@@ -33,15 +36,49 @@ protected:
     // Get time in seconds of the current frame
     inline float GetDeltaTime() const { return m_deltaTime; }
 
+    // Run FixedUpdate at a constant rate, independent of the frame rate. 0 disables it
+    // If rendering falls behind, at most maxTicksPerFrame are run each frame, and the remaining time is dropped
+    void SetFixedTickRate(float tickRate, unsigned int maxTicksPerFrame = 5);
+
+    // Check if the fixed update loop is enabled
+    inline bool IsFixedTickEnabled() const { return m_fixedDeltaTime > 0.0f; }
+
+    // Get time in seconds of each fixed tick
+    inline float GetFixedDeltaTime() const { return m_fixedDeltaTime; }
+
+    // Get the simulation time in seconds at the end of the last fixed tick. It only depends on the number of ticks
+    inline float GetSimulationTime() const { return static_cast<float>(m_tickCount * static_cast<double>(m_fixedDeltaTime)); }
+
+    // Fraction [0, 1) of the next tick already elapsed. Use it to interpolate between the last two simulation states when rendering
+    inline float GetInterpolationFactor() const { return IsFixedTickEnabled() ? m_tickAccumulator / m_fixedDeltaTime : 1.0f; }
+
     // Test if the application is currently running
     bool IsRunning() const;
 
+    // Move the GL context to a render thread after Initialize. Call it before Run
+    // Update and Render then run in the main thread, and Render must record the GL work with GetRenderThread().Enqueue()
+    // The render thread executes it and swaps buffers while the main thread updates the next frame
+    // Renderer and DearImGui draw directly and keep state that Update modifies, so they can't be used with it yet (they assert)
+    void EnableRenderThread(unsigned int frameBufferCount = 2);
+
+    // Get the frame pacer, to limit the frames in flight and the frame rate, and read the input latency
+    // Frames in flight are only limited without render thread, as the render thread already bounds the frames queued
+    inline FramePacer& GetFramePacer() { return m_framePacer; }
+    inline const FramePacer& GetFramePacer() const { return m_framePacer; }
+
+    // Get the render thread, null if not enabled
+    inline RenderThread* GetRenderThread() { return m_renderThread.get(); }
+    inline const RenderThread* GetRenderThread() const { return m_renderThread.get(); }
+
     // Request the application to stop running
     inline void Close() { Terminate(0); }
 
     // Load initial resources and initialize data before the main loop
     virtual void Initialize();
 
+    // Update the application logic with a constant time step. Called 0 or more times per frame, before Update
+    virtual void FixedUpdate();
+
     // Update the application logic for the current frame
     virtual void Update();
 
@@ -60,17 +97,35 @@ private:
     // Set the new current time and compute the delta since the last time
     void UpdateTime(float newCurrentTime);
 
+    // Run the fixed ticks that fit in the time accumulated
+    void RunFixedTicks();
+
 private:
     // OpenGL device
     DeviceGL m_device;
     // Main window
     Window m_mainWindow;
 
+    // Frame pacing controller
+    FramePacer m_framePacer;
+
+    // Optional render thread that owns the GL context during the main loop
+    std::unique_ptr<RenderThread> m_renderThread;
+
     // Time in seconds from the start of the application
     float m_currentTime;
     // Time in seconds of the current frame
     float m_deltaTime;
 
+    // Time in seconds of each fixed tick, 0 if disabled
+    float m_fixedDeltaTime;
+    // Max number of fixed ticks in one frame, to avoid falling further behind when the frame is slow
+    unsigned int m_maxTicksPerFrame;
+    // Time accumulated that didn't complete a tick yet
+    float m_tickAccumulator;
+    // Number of fixed ticks run since the start
+    unsigned long long m_tickCount;
+
     // Exit code
     int m_exitCode;
     // Error message to display on exit
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <ituGL/core/GpuFence.h>
+#include <ituGL/core/GpuTimestamp.h>
+#include <chrono>
+#include <deque>
+#include <array>
+
+// Controls the pace of the main loop to reduce input latency and CPU usage
+// - Limits the number of frames queued in the driver, waiting on a fence inserted after each SwapBuffers
+// - Caps the frame rate sleeping, never spinning, until the next frame is due
+// - Measures the input to present latency: from the moment the input is polled until the GPU finishes the frame that used it
+//   The GPU completion time comes from a timestamp query, so it doesn't depend on when the CPU checks the fence
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Latency in seconds, over the last samples
+    struct LatencyStats
+    {
+        float last = 0.0f;
+        float average = 0.0f;
+        float max = 0.0f;
+        unsigned int sampleCount = 0;
+    };
+
+public:
+    FramePacer();
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    void operator = (const FramePacer&) = delete;
+
+    // Max number of frames the GPU can be behind the CPU. 0 means no limit (driver default)
+    inline unsigned int GetMaxFramesInFlight() const { return m_maxFramesInFlight; }
+    inline void SetMaxFramesInFlight(unsigned int maxFramesInFlight) { m_maxFramesInFlight = maxFramesInFlight; }
+
+    // Max frames per second. 0 means no cap
+    inline float GetTargetFrameRate() const { return m_targetFrameRate; }
+    void SetTargetFrameRate(float targetFrameRate);
+
+    // Call right after polling the input that the next frame will use
+    void MarkInputSampled();
+
+    // Call right after SwapBuffers, with the GL context current. Waits if there are too many frames in flight
+    void EndFrame();
+
+    // Sleep until the next frame is due, if the frame rate is capped. Call before polling the input
+    void WaitForNextFrame();
+
+    // Delete the pending fences. The GL context must be current
+    void Reset();
+
+    inline const LatencyStats& GetLatencyStats() const { return m_latencyStats; }
+
+private:
+    // Fence of a submitted frame
+    struct FrameFence
+    {
+        GpuFence fence;
+
+        // GPU time when the frame completed
+        GpuTimestamp completionTimestamp;
+
+        // Same moment in the CPU and GPU clocks, taken when the frame was submitted, to convert GPU times to CPU times
+        Clock::time_point submitTime;
+        GLuint64 gpuSubmitTime;
+
+        Clock::time_point inputTime;
+    };
+
+    // Check the oldest fences. If wait is true, block until the oldest one is signaled
+    void RetireFences(bool wait);
+
+    void AddLatencySample(float latency);
+
+private:
+    unsigned int m_maxFramesInFlight;
+
+    float m_targetFrameRate;
+
+    // Time when the next frame should start, if the frame rate is capped
+    Clock::time_point m_nextFrameTime;
+
+    // Time when the input of the current frame was polled
+    Clock::time_point m_inputTime;
+
+    // Frames submitted to the GPU and not finished yet, oldest first
+    std::deque<FrameFence> m_pendingFrames;
+
+    // Last latency samples, to compute the stats
+    static const unsigned int LatencySampleCount = 128;
+    std::array<float, LatencySampleCount> m_latencySamples;
+    unsigned int m_latencySampleIndex;
+
+    LatencyStats m_latencyStats;
+};
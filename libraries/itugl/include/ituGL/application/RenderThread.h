@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class Window;
+
+// Thread that owns the GL context of a window and executes the GL commands recorded by the update thread
+// Commands are recorded into frame packets. There is a fixed ring of packets: while the render thread executes one,
+// the update thread records the next one, so the update of frame N+1 overlaps the GL submission and SwapBuffers of frame N
+class RenderThread
+{
+public:
+    // Command executed in the render thread, with the GL context current
+    // Capture the frame state by value: the update thread keeps modifying its own copy
+    using Command = std::function<void()>;
+
+public:
+    // frameBufferCount is the number of frame packets: 2 for double buffering (update runs one frame ahead), 3 for triple buffering
+    RenderThread(Window& window, unsigned int frameBufferCount = 2);
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    void operator = (const RenderThread&) = delete;
+
+    // Move the GL context to the render thread and start it. The context must be current in the calling thread
+    void Start();
+
+    // Execute the pending frames, stop the thread and make the context current again in the calling thread
+    void Stop();
+
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    unsigned int GetFrameBufferCount() const { return static_cast<unsigned int>(m_frames.size()); }
+
+    // Record a command in the current frame packet
+    void Enqueue(Command command);
+
+    // Close the current frame packet and send it to the render thread, which will swap buffers after executing it
+    // Blocks if the render thread is already processing all the other packets
+    void SubmitFrame();
+
+    // Wait until all the submitted frames have been executed
+    void Flush();
+
+    // Run a command in the render thread and wait for it. Useful for GL queries and resource creation outside the frame
+    void ExecuteAndWait(Command command);
+
+private:
+    struct FramePacket
+    {
+        std::vector<Command> commands;
+
+        // Swap buffers after the commands. False for the packets used by ExecuteAndWait
+        bool present;
+    };
+
+    void ThreadLoop();
+
+    // Packet being recorded by the update thread
+    FramePacket& GetRecordingFrame();
+
+    void SubmitPacket(bool present);
+
+private:
+    Window& m_window;
+
+    std::thread m_thread;
+
+    // Ring of frame packets
+    std::vector<FramePacket> m_frames;
+
+    // Packets submitted by the update thread and completed by the render thread, always increasing
+    // Packets in [completed, submitted) belong to the render thread, packet (submitted % count) is being recorded
+    unsigned long long m_submittedCount;
+    unsigned long long m_completedCount;
+
+    bool m_stop;
+
+    std::mutex m_mutex;
+
+    // Notified when a packet is submitted, or when stopping
+    std::condition_variable m_submittedCondition;
+
+    // Notified when a packet is completed
+    std::condition_variable m_completedCondition;
+};
@@ -27,6 +27,9 @@ public:
     // Load the asset from a path into the object passed as a parameter
     virtual bool LoadInto(const char* path, T&);
 
+    // Check if the asset was already loaded as shared, and is being kept
+    bool HasShared(const char* path) const;
+
     inline bool GetKeepShared() const { return m_keepShared; }
     inline void SetKeepShared(bool keepShared) { m_keepShared = keepShared; }
 
@@ -87,6 +90,12 @@ std::shared_ptr<T> AssetLoader<T>::LoadShared(const char* path)
     return t;
 }
 
+template <typename T>
+bool AssetLoader<T>::HasShared(const char* path) const
+{
+    return m_sharedAssets.find(std::string(path)) != m_sharedAssets.end();
+}
+
 template <typename T>
 bool AssetLoader<T>::LoadInto(const char* path, T& t)
 {
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <ituGL/asset/ShaderProgramCache.h>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+class ShaderProgram;
+
+// Shader program that is built the first time it is requested, instead of when it is created
+// Programs that are never used, like the ones of a render mode that is not active, are never compiled
+// The build is asynchronous: it is submitted on the first request, and the next requests check it without waiting
+// The cache must outlive the lazy programs created with it
+class LazyShaderProgram
+{
+public:
+    // Build state of the program
+    enum class State
+    {
+        NotRequested,
+        Building,
+        Ready,
+        Failed
+    };
+
+public:
+    // Program with vertex and fragment shaders. The paths and defines are copied
+    LazyShaderProgram(ShaderProgramCache& shaderProgramCache, std::span<const char*> vertexShaderPaths, std::span<const char*> fragmentShaderPaths,
+        std::span<const std::string> defines = {});
+    ~LazyShaderProgram();
+
+    // Not copyable, the cache tracks the program by its address while it is building
+    LazyShaderProgram(const LazyShaderProgram&) = delete;
+    LazyShaderProgram& operator = (const LazyShaderProgram&) = delete;
+
+    // Start building the program the first time it is called, and check if it finished the next times
+    // Returns the program once it is linked, nullptr while it is building or if it failed
+    std::shared_ptr<ShaderProgram> Request();
+
+    inline State GetState() const { return m_state; }
+
+private:
+    // Source files of one stage, stored until the build is submitted
+    struct StageFiles
+    {
+        Shader::Type type;
+        std::vector<std::string> paths;
+    };
+
+private:
+    ShaderProgramCache& m_shaderProgramCache;
+
+    std::vector<StageFiles> m_stages;
+    std::vector<std::string> m_defines;
+
+    std::shared_ptr<ShaderProgram> m_shaderProgram;
+
+    State m_state;
+};
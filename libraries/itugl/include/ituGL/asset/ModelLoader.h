@@ -5,11 +5,14 @@
 #include <ituGL/geometry/Model.h>
 #include <ituGL/geometry/Mesh.h>
 #include <ituGL/asset/Texture2DLoader.h>
+#include <ituGL/geometry/VertexFormat.h>
 #include <vector>
 
+struct aiScene;
 struct aiMesh;
 struct aiMaterial;
-class VertexFormat;
+class JobSystem;
+class SamplerObject;
 
 // Asset loader for Models. Contains a pointer to a reference material for loaded submeshes
 class ModelLoader : public AssetLoader<Model>
@@ -30,6 +33,14 @@ public:
     Texture2DLoader& GetTexture2DLoader();
     const Texture2DLoader& GetTexture2DLoader() const;
 
+    // Optional sampler for all the loaded textures, usually from a SamplerCache. If null, the texture parameters are used
+    std::shared_ptr<const SamplerObject> GetTextureSampler() const { return m_textureSampler; }
+    void SetTextureSampler(std::shared_ptr<const SamplerObject> textureSampler) { m_textureSampler = textureSampler; }
+
+    // Optional job system to build the mesh data and decode the textures in parallel. The GL objects are still created in the calling thread
+    JobSystem* GetJobSystem() const { return m_jobSystem; }
+    void SetJobSystem(JobSystem* jobSystem) { m_jobSystem = jobSystem; }
+
     // Load the model from the path
     Model Load(const char* path) override;
 
@@ -40,16 +51,49 @@ public:
     bool SetMaterialProperty(MaterialProperty materialProperty, const char* uniformName);
 
 private:
-    // Generate a submesh from the loaded mesh data
-    void GenerateSubmesh(Mesh& mesh, const aiMesh& meshData);
-
-    // Generate a material from the loaded material data
+    // CPU data of one submesh, before creating the GL objects
+    struct SubmeshData
+    {
+        VertexFormat vertexFormat;
+        std::vector<GLubyte> vertexData;
+        Data::Type elementType;
+        std::vector<Drawcall::Primitive> primitives;
+        std::vector<int> elementCounts;
+        std::vector<GLubyte> elementData;
+    };
+
+    // Texture of the materials to decode in advance
+    struct TextureRequest
+    {
+        std::string path;
+        TextureObject::Format format;
+        TextureObject::InternalFormat internalFormat;
+        Texture2DLoader::TextureData textureData;
+    };
+
+    // Build the submesh data from the loaded mesh data. Doesn't use GL, so it can run in any thread
+    static void CollectSubmeshData(const aiMesh& meshData, SubmeshData& submeshData);
+
+    // Generate a submesh from the collected data
+    void GenerateSubmesh(Mesh& mesh, const SubmeshData& submeshData);
+
+    // Generate a material instance of the reference material from the loaded material data
     std::shared_ptr<Material> GenerateMaterial(const aiMaterial& materialData);
 
+    // Find the textures used by the meshes that were not loaded yet, once per path
+    void CollectTextureRequests(const aiScene& scene, std::vector<TextureRequest>& textureRequests) const;
+
     // Load a texture of the specific type in the location
     void LoadTexture(const aiMaterial& materialData, int textureType, Material& material, ShaderProgram::Location location,
         TextureObject::Format format, TextureObject::InternalFormat internalFormat) const;
 
+    // Get the full path of the texture of the specific type, if the material has one
+    bool GetTexturePath(const aiMaterial& materialData, int textureType, std::string& texturePath) const;
+
+    // Get the texture type and formats used for a texture property. Returns false if the property is not a texture
+    static bool GetTextureProperty(MaterialProperty materialProperty, int& textureType,
+        TextureObject::Format& format, TextureObject::InternalFormat& internalFormat);
+
     // Build the vertex data from the mesh data
     static std::vector<GLubyte> CollectVertexData(const aiMesh& meshData, VertexFormat& vertexFormat, bool interleaved);
 
@@ -79,11 +123,17 @@ private:
     // Maps material properties to uniforms in the reference material
     std::unordered_map <MaterialProperty, ShaderProgram::Location> m_materialPropertyMap;
 
-    // Should create new materials for each submesh or use the reference material
+    // Should create a material instance for each material in the file or use the reference material
     bool m_createMaterials;
 
     // Texture loader to cache already loaded shared textures
     mutable Texture2DLoader m_textureLoader;
+
+    // Sampler assigned to the loaded textures. Can be null
+    std::shared_ptr<const SamplerObject> m_textureSampler;
+
+    // Job system used to collect the submesh data. Can be null
+    JobSystem* m_jobSystem;
 };
 
 enum class ModelLoader::MaterialProperty
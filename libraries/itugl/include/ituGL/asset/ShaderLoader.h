@@ -1,8 +1,10 @@
 #pragma once
 
 #include <ituGL/asset/AssetLoader.h>
+#include <ituGL/asset/ShaderPreprocessor.h>
 #include <ituGL/shader/Shader.h>
 #include <span>
+#include <string>
 
 class ShaderLoader : AssetLoader<Shader>
 {
@@ -22,8 +24,25 @@ public:
 
     static Shader Load(Shader::Type type, const char* path);
 
-private:
-    void Compile(Shader& shader);
+    // Create and compile a shader from source code already read
+    Shader LoadFromSource(const ShaderPreprocessor::Source& source);
+
+    // Create a shader from source code already read and start compiling it, without waiting for the result
+    // Call CheckCompilation when the shader is needed
+    Shader StartLoadFromSource(const ShaderPreprocessor::Source& source);
+
+    // Wait for the shader to compile and report the errors. Returns true if it compiled successfully
+    // The files are listed with the errors, by the number the errors use for them
+    static bool CheckCompilation(const Shader& shader, std::span<const std::string> files = {});
+
+    // Read and combine the files into one source, resolving their includes, without creating the shader
+    static bool ReadSource(std::span<const char*> paths, ShaderPreprocessor::Source& source);
 
+    // Preprocessor shared by all the loaders, so each file is read from disk only once
+    inline static ShaderPreprocessor& GetPreprocessor() { return s_preprocessor; }
+
+private:
     Shader::Type m_type;
+
+    static ShaderPreprocessor s_preprocessor;
 };
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Combines shader files into a single source, resolving #include "file" directives
+// Each file is included only once per source, so files can include what they use without guards
+// #line directives are added, so compilation errors report the line in the original file
+// The number of the file in the errors is its index in the list of files of the source
+// Files are read from disk only once, and kept in memory for the next sources that use them
+class ShaderPreprocessor
+{
+public:
+    // Preprocessed source code, and the files it includes, by the file number used in the #line directives
+    struct Source
+    {
+        std::string code;
+        std::vector<std::string> files;
+    };
+
+public:
+    ShaderPreprocessor();
+
+    // Combine the files in order, as if they were included one after the other
+    // Returns false if any file, or any file they include, can't be read
+    bool Process(std::span<const char*> paths, Source& source);
+
+    // Forget the files read, so they are read again from disk. Call it after editing the shaders
+    void ClearFileCache();
+
+    // Number of files kept in memory
+    inline unsigned int GetCachedFileCount() const { return static_cast<unsigned int>(m_files.size()); }
+
+private:
+    // Append the file to the source, replacing its includes
+    bool ProcessFile(const std::filesystem::path& path, Source& source, std::unordered_set<std::string>& includedFiles);
+
+    // Contents of the file, read the first time. Returns nullptr if it can't be read
+    const std::string* GetFileContents(const std::string& path);
+
+    // Path of the file of an #include line, relative to the file that includes it
+    // Falls back to the working directory, as paths are usually written when loading
+    static std::filesystem::path ResolveInclude(const std::filesystem::path& includingPath, const std::string& includePath);
+
+    // If the line is an #include, get the path between the quotes
+    static bool ParseInclude(const std::string& line, std::string& includePath);
+
+    // Check if the line starts with a directive, ignoring spaces
+    static bool IsDirective(const std::string& line, const char* directive);
+
+private:
+    // File contents by normalized path
+    std::unordered_map<std::string, std::string> m_files;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <ituGL/asset/ShaderPreprocessor.h>
+#include <ituGL/shader/Shader.h>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+class ShaderProgram;
+
+// Builds shader programs from source files, keeping the linked binaries in a cache directory
+// The next time the same program is built, the binary is loaded and compiling and linking are skipped
+// Binaries are keyed by a hash of the sources and the driver, so editing a shader or updating the driver rebuilds them
+// Programs built inside a batch are submitted without waiting for them, so the driver can compile them in parallel
+// Programs built asynchronously are not waited for at all, they are polled until they finish
+class ShaderProgramCache
+{
+public:
+    // Source files of one stage of the program
+    struct Stage
+    {
+        Shader::Type type;
+        std::span<const char*> paths;
+    };
+
+    // How many programs were loaded from the cache or built from source
+    struct Stats
+    {
+        unsigned int hitCount = 0;
+        unsigned int missCount = 0;
+    };
+
+public:
+    ShaderProgramCache(const std::filesystem::path& directory = "cache/shaders");
+    ~ShaderProgramCache();
+
+    // Build a shader program with a compute shader
+    inline bool Build(ShaderProgram& shaderProgram, std::span<const char*> computeShaderPaths)
+    {
+        Stage stages[] = { { Shader::ComputeShader, computeShaderPaths } };
+        return Build(shaderProgram, stages);
+    }
+
+    // Build a shader program with vertex and fragment shaders
+    inline bool Build(ShaderProgram& shaderProgram, std::span<const char*> vertexShaderPaths, std::span<const char*> fragmentShaderPaths)
+    {
+        Stage stages[] = { { Shader::VertexShader, vertexShaderPaths }, { Shader::FragmentShader, fragmentShaderPaths } };
+        return Build(shaderProgram, stages);
+    }
+
+    // Build a separable shader program with a single stage, to be used in a ProgramPipeline
+    inline bool BuildSeparable(ShaderProgram& shaderProgram, Shader::Type type, std::span<const char*> paths)
+    {
+        Stage stages[] = { { type, paths } };
+        return Build(shaderProgram, stages, std::span<const std::string>(), true);
+    }
+
+    // Build a shader program with any combination of stages
+    // Inside a batch, it returns true if the program was submitted. The result is known in EndBatch
+    inline bool Build(ShaderProgram& shaderProgram, std::span<const Stage> stages)
+    {
+        return Build(shaderProgram, stages, std::span<const std::string>());
+    }
+
+    // Build a shader program with a #define for each of the names, added to all the stages after the #version line
+    // Defines are part of the key, like the rest of the sources. Separable programs are keyed apart too
+    bool Build(ShaderProgram& shaderProgram, std::span<const Stage> stages, std::span<const std::string> defines, bool separable = false);
+
+    // Start a batch. The programs built until EndBatch are compiled and linked without checking the result
+    // The programs must stay alive until EndBatch
+    void BeginBatch();
+
+    // Wait for all the programs of the batch, report the errors and store the binaries. Returns true if all of them linked
+    bool EndBatch();
+
+    inline bool IsBatchOpen() const { return m_batchOpen; }
+
+    // Submit the program and return without waiting for it. Returns false if the sources can't be read
+    // The program must stay alive until PollAsync returns true, or the build is cancelled
+    bool BuildAsync(ShaderProgram& shaderProgram, std::span<const Stage> stages, std::span<const std::string> defines = {}, bool separable = false);
+
+    // Check if an asynchronous build finished, without waiting for it unless parallel compilation is not supported
+    // When it finishes, errors are reported and the binary stored. Check IsLinked to know the result
+    bool PollAsync(ShaderProgram& shaderProgram);
+
+    // Stop tracking an asynchronous build, before destroying the program
+    void CancelAsync(const ShaderProgram& shaderProgram);
+
+    // Enable or disable using the cache. When disabled, programs are always built from source
+    inline bool IsEnabled() const { return m_enabled; }
+    inline void SetEnabled(bool enabled) { m_enabled = enabled; }
+
+    inline const Stats& GetStats() const { return m_stats; }
+
+    // Delete all the binaries stored in the directory
+    void Clear();
+
+private:
+    // Program submitted to the driver, with its shaders and files kept to report compilation errors
+    struct PendingProgram
+    {
+        ShaderProgram* shaderProgram;
+        std::vector<Shader> shaders;
+        std::vector<std::vector<std::string>> files;
+        unsigned long long key;
+        bool saveBinary;
+    };
+
+private:
+    // Read the sources and load the binary, or start building the program if it is not in the cache
+    // Returns false if the sources can't be read. If the binary was loaded, the pending program has no shaders
+    bool Submit(ShaderProgram& shaderProgram, std::span<const Stage> stages, std::span<const std::string> defines, bool separable, PendingProgram& pendingProgram);
+
+    // Hash of the driver and all the sources of the stages
+    unsigned long long ComputeKey(std::span<const Stage> stages, std::span<const ShaderPreprocessor::Source> sources, bool separable) const;
+
+    // File of the binary for this key
+    std::filesystem::path GetBinaryPath(unsigned long long key) const;
+
+    bool LoadBinary(ShaderProgram& shaderProgram, unsigned long long key) const;
+    void SaveBinary(const ShaderProgram& shaderProgram, unsigned long long key) const;
+
+    // Insert the defines after the #version line, or at the beginning if there is none
+    static void InsertDefines(std::string& code, const std::string& defineSource);
+
+    // Start compiling the sources of all the stages and linking them
+    static void StartBuild(PendingProgram& pendingProgram, std::span<const Stage> stages, std::span<const ShaderPreprocessor::Source> sources);
+
+    // Wait for the program to link, report the errors and store the binary
+    bool FinishBuild(PendingProgram& pendingProgram) const;
+
+    // Vendor, renderer and version strings. Read the first time, when the context is already created
+    const std::string& GetDriverString() const;
+
+private:
+    std::filesystem::path m_directory;
+
+    bool m_enabled;
+
+    bool m_batchOpen;
+    std::vector<PendingProgram> m_pendingPrograms;
+
+    // Programs built with BuildAsync that didn't finish yet
+    std::vector<PendingProgram> m_asyncPrograms;
+
+    Stats m_stats;
+
+    mutable std::string m_driverString;
+};
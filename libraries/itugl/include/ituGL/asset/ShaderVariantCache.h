@@ -0,0 +1,47 @@
+#pragma once
+
+#include <ituGL/asset/ShaderProgramCache.h>
+#include <unordered_map>
+#include <memory>
+#include <set>
+#include <string>
+
+// Keeps the variants of shader programs: the same sources built with a different set of keywords
+// Each keyword is added as a #define, so the shaders can use #ifdef to remove the code they don't need,
+// instead of checking a uniform for each pixel
+// The first time a variant is requested it is built through the ShaderProgramCache, then the same program is returned
+class ShaderVariantCache
+{
+public:
+    // Keywords of a variant. Sorted, so the same set always produces the same variant
+    using KeywordSet = std::set<std::string>;
+
+public:
+    ShaderVariantCache(ShaderProgramCache& shaderProgramCache);
+
+    // Get the variant of a program with vertex and fragment shaders
+    inline std::shared_ptr<ShaderProgram> GetShaderProgram(std::span<const char*> vertexShaderPaths, std::span<const char*> fragmentShaderPaths,
+        const KeywordSet& keywords = KeywordSet())
+    {
+        ShaderProgramCache::Stage stages[] = { { Shader::VertexShader, vertexShaderPaths }, { Shader::FragmentShader, fragmentShaderPaths } };
+        return GetShaderProgram(stages, keywords);
+    }
+
+    // Get the variant of a program with any combination of stages. Returns nullptr if it failed to build
+    std::shared_ptr<ShaderProgram> GetShaderProgram(std::span<const ShaderProgramCache::Stage> stages, const KeywordSet& keywords = KeywordSet());
+
+    // Number of different variants built
+    inline unsigned int GetVariantCount() const { return static_cast<unsigned int>(m_variants.size()); }
+
+    // Release the variants. Those still used by materials are deleted when the materials release them
+    void Clear();
+
+private:
+    // Paths of all the stages and the keywords, identifying the variant
+    static std::string GetVariantKey(std::span<const ShaderProgramCache::Stage> stages, const KeywordSet& keywords);
+
+private:
+    ShaderProgramCache& m_shaderProgramCache;
+
+    std::unordered_map<std::string, std::shared_ptr<ShaderProgram>> m_variants;
+};
@@ -2,17 +2,45 @@
 
 #include <ituGL/asset/TextureLoader.h>
 #include <ituGL/texture/Texture2DObject.h>
+#include <unordered_map>
+#include <string>
 
 // Asset loader for Texture2DObject
 class Texture2DLoader : public TextureLoader<Texture2DObject>
 {
+public:
+    // Texture file decoded in memory, before creating the texture object
+    struct TextureData
+    {
+        TextureObject::Format format;
+        TextureObject::InternalFormat internalFormat;
+        int width;
+        int height;
+        Data::Type dataType;
+        std::span<const std::byte> data;
+    };
+
 public:
     Texture2DLoader();
     Texture2DLoader(TextureObject::Format format, TextureObject::InternalFormat internalFormat);
+    ~Texture2DLoader();
+
+    // Non-copyable, the decoded data would be freed twice
+    Texture2DLoader(const Texture2DLoader&) = delete;
+    void operator = (const Texture2DLoader&) = delete;
 
     // Load the texture from the path
     Texture2DObject Load(const char* path) override;
 
+    // Decode the texture file. Doesn't use GL nor modify the loader, so it can run in any thread
+    // Data must be freed with FreeData, unless it is passed to AddDecodedData
+    TextureData LoadData(const char* path, TextureObject::Format format, TextureObject::InternalFormat internalFormat) const;
+    static void FreeData(TextureData& textureData);
+
+    // Keep data decoded in advance, used instead of reading the file the next time the path is loaded with the same format
+    // The loader takes ownership of the data
+    void AddDecodedData(const char* path, const TextureData& textureData);
+
     // Helper to easily load a shared texture
     static std::shared_ptr<Texture2DObject> LoadTextureShared(const char* path,
         TextureObject::Format format, TextureObject::InternalFormat internalFormat,
@@ -25,4 +53,7 @@ private:
     // If true, the texture will be flipped vertically on load
     // This option exists because some systems define the vertical origin as "up", and others as "down"
     bool m_flipVertical;
+
+    // Data decoded in advance, waiting to be loaded
+    std::unordered_map<std::string, TextureData> m_decodedData;
 };
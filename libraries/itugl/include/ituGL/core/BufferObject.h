@@ -13,6 +13,10 @@ public:
         ArrayBuffer = GL_ARRAY_BUFFER,
         // Element Buffer Object
         ElementArrayBuffer = GL_ELEMENT_ARRAY_BUFFER,
+        // Pixel Buffer Object, destination of pixel reads
+        PixelPackBuffer = GL_PIXEL_PACK_BUFFER,
+        // Uniform Buffer Object, storage of uniform blocks
+        UniformBuffer = GL_UNIFORM_BUFFER,
         // TODO: There are more types, add them when they are supported
     };
 
@@ -34,6 +38,23 @@ public:
         StreamDraw = GL_STREAM_DRAW,    StreamRead = GL_STREAM_READ,    StreamCopy = GL_STREAM_COPY
     };
 
+    // Storage flags: What can be done with an immutable storage after it is allocated. Can be combined
+    // Without DynamicStorage, the contents can only be set when allocating, letting the driver place it in the best memory
+    enum StorageFlags : GLbitfield
+    {
+        StorageNone = 0,
+        // The contents can be modified with UpdateData
+        DynamicStorage = GL_DYNAMIC_STORAGE_BIT,
+        // The storage can be mapped for reading / writing
+        MapReadStorage = GL_MAP_READ_BIT,
+        MapWriteStorage = GL_MAP_WRITE_BIT,
+        // The storage can stay mapped while the GPU uses it
+        MapPersistentStorage = GL_MAP_PERSISTENT_BIT,
+        MapCoherentStorage = GL_MAP_COHERENT_BIT,
+        // Hint to place the storage in client memory
+        ClientStorage = GL_CLIENT_STORAGE_BIT
+    };
+
 public:
     BufferObject();
     virtual ~BufferObject();
@@ -55,14 +76,34 @@ public:
     void AllocateData(size_t size, Usage usage);
     void AllocateData(std::span<const std::byte> data, Usage usage);
 
+    // Allocate an immutable storage: the size can't change anymore, but the driver can allocate it optimally
+    // Flags is a combination of StorageFlags. Uses glBufferData as fallback when Direct State Access is not enabled
+    void AllocateStorage(size_t size, GLbitfield flags);
+    void AllocateStorage(std::span<const std::byte> data, GLbitfield flags);
+
     // Modify the contents of the buffer, starting at offset
     void UpdateData(std::span<const std::byte> data, size_t offset = 0);
 
+    // Map a range of the buffer into client memory. Access is a combination of GL_MAP_* bits. Returns null if it fails
+    void* MapRange(size_t offset, size_t size, GLbitfield access);
+
+    // Release the mapped memory. Returns false if the contents got corrupted while mapped, and must be written again
+    bool Unmap();
+
 protected:
     // Bind the specific target. Used by the Bind() method in derived classes
     void Bind(Target target) const;
+
+#ifndef NDEBUG
+    // With Direct State Access enabled, the buffer is edited through its handle and doesn't need to be bound
+    bool IsReadyToEdit() const;
+#endif
     // Unbind the specific target. It is static because we dont need any objects to do it
     static void Unbind(Target target);
+
+private:
+    // Usage hint equivalent to the storage flags, when immutable storage is not available
+    static Usage GetFallbackUsage(GLbitfield flags);
 };
 
 // (C++) 5
@@ -30,9 +30,9 @@ public:
 
     // Templated method to convert from types to the enum Type
     template<typename T>
-    static Type GetType();
+    static constexpr Type GetType();
     template<typename T>
-    static Type GetType(const T&);
+    static constexpr Type GetType(const T&);
 
     // Get size in bytes for each Type
     static unsigned int GetTypeSize(Type type);
@@ -75,13 +75,13 @@ std::span<const std::byte> Data::GetBytes(std::span<const T> data)
 }
 
 template<typename T>
-inline Data::Type Data::GetType(const T&) { return GetType<T>(); }
+constexpr Data::Type Data::GetType(const T&) { return GetType<T>(); }
 
-template<> inline Data::Type Data::GetType<GLfloat>() { return Type::Float; }
-template<> inline Data::Type Data::GetType<GLdouble>() { return Type::Double; }
-template<> inline Data::Type Data::GetType<GLbyte>() { return Type::Byte; }
-template<> inline Data::Type Data::GetType<GLubyte>() { return Type::UByte; }
-template<> inline Data::Type Data::GetType<GLshort>() { return Type::Short; }
-template<> inline Data::Type Data::GetType<GLushort>() { return Type::UShort; }
-template<> inline Data::Type Data::GetType<GLint>() { return Type::Int; }
-template<> inline Data::Type Data::GetType<GLuint>() { return Type::UInt; }
+template<> constexpr Data::Type Data::GetType<GLfloat>() { return Type::Float; }
+template<> constexpr Data::Type Data::GetType<GLdouble>() { return Type::Double; }
+template<> constexpr Data::Type Data::GetType<GLbyte>() { return Type::Byte; }
+template<> constexpr Data::Type Data::GetType<GLubyte>() { return Type::UByte; }
+template<> constexpr Data::Type Data::GetType<GLshort>() { return Type::Short; }
+template<> constexpr Data::Type Data::GetType<GLushort>() { return Type::UShort; }
+template<> constexpr Data::Type Data::GetType<GLint>() { return Type::Int; }
+template<> constexpr Data::Type Data::GetType<GLuint>() { return Type::UInt; }
@@ -2,6 +2,16 @@
 
 #include <ituGL/core/Color.h>
 #include <glad/glad.h>
+#include <atomic>
+#include <array>
+
+// KHR_parallel_shader_compile is not included in the glad build, these are the values from the extension
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
 class Window;
 struct GLFWwindow;
@@ -10,6 +20,22 @@ struct GLFWwindow;
 // Implemented as a Singleton pattern, as there can only be one
 class DeviceGL
 {
+public:
+    // Counters of the texture, sampler and uniform buffer bindings requested, and how many of them were skipped because nothing changed
+    struct BindingStats
+    {
+        unsigned int textureBindCount = 0;
+        unsigned int elidedTextureBindCount = 0;
+        unsigned int activeTextureCount = 0;
+        unsigned int elidedActiveTextureCount = 0;
+        unsigned int samplerBindCount = 0;
+        unsigned int elidedSamplerBindCount = 0;
+        unsigned int samplerUniformCount = 0;
+        unsigned int elidedSamplerUniformCount = 0;
+        unsigned int uniformBufferBindCount = 0;
+        unsigned int elidedUniformBufferBindCount = 0;
+    };
+
 public:
     DeviceGL();
     ~DeviceGL();
@@ -30,6 +56,12 @@ public:
     void GetViewport(GLint& x, GLint& y, GLsizei& width, GLsizei& height) const;
     void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
 
+    // Apply the viewport of a resize that happened while the context was current in another thread (see RenderThread)
+    void ApplyPendingViewport();
+
+    // Check if the calling thread can issue GL commands. False in the update thread while the RenderThread runs
+    static bool IsContextCurrent();
+
     // Poll the events in the window event queue
     void PollEvents();
 
@@ -53,14 +85,97 @@ public:
     // enable / disable v-sync
     void SetVSyncEnabled(bool enabled);
 
+    // Check if the context supports Direct State Access (GL 4.5): editing objects without binding them first
+    bool IsDirectStateAccessSupported() const;
+
+    // Objects use the Direct State Access path if it is enabled. Otherwise, they fall back to bind-to-edit
+    // Enabled by default if supported. Change it only before creating any object: DSA objects are created differently
+    inline static bool IsDirectStateAccessEnabled() { return s_directStateAccessEnabled; }
+    void SetDirectStateAccessEnabled(bool enabled);
+
+    // Check if the driver compiles shaders in background threads (KHR_parallel_shader_compile)
+    // If supported, the completion of compile and link can be queried without waiting for them
+    inline static bool IsParallelShaderCompileSupported() { return s_parallelShaderCompileSupported; }
+
+    // Max number of threads the driver can use to compile shaders. 0 disables them, ~0u lets the driver decide
+    void SetMaxShaderCompilerThreads(GLuint count);
+
+    // Texture units are bound through this cache, that skips the GL calls if the same object is already bound
+    // Set the active texture unit
+    void SetActiveTextureUnit(GLuint textureUnit);
+    // Bind a texture to a texture unit. With Direct State Access, the active texture unit doesn't change
+    void BindTexture(GLuint textureUnit, GLenum target, GLuint texture);
+    // Bind a texture to the active texture unit, to edit it
+    void BindTextureToActiveUnit(GLenum target, GLuint texture);
+    // Bind a sampler to a texture unit
+    void BindSampler(GLuint textureUnit, GLuint sampler);
+    // Bind a range of a buffer to an indexed uniform buffer binding point
+    void BindUniformBufferRange(GLuint bindingIndex, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    // Deleted objects are unbound by OpenGL, and their handles can be reused. Called by the objects when they are deleted
+    void OnTextureDeleted(GLuint texture);
+    void OnSamplerDeleted(GLuint sampler);
+    void OnBufferDeleted(GLuint buffer);
+
+    // Forget the cached bindings. Needed if the textures, samplers or uniform buffers were bound without using the cache
+    void InvalidateBindingCache();
+
+    // Binding counters, accumulated until they are reset (usually each frame)
+    inline const BindingStats& GetBindingStats() const { return m_bindingStats; }
+    inline void ResetBindingStats() { m_bindingStats = BindingStats(); }
+
+    // Count a sampler uniform write. The cache of sampler uniforms is in each ShaderProgram
+    void AddSamplerUniformStats(bool elided);
+
+private:
+    // Index of a texture target in the cache. Returns -1 for unknown targets
+    static int GetTextureTargetIndex(GLenum target);
+
 private:
     // Has a context been loaded? We use the context of the current window
     bool m_contextLoaded;
 
+    // Only the first texture units are cached, the rest are always bound
+    static const unsigned int CachedTextureUnitCount = 32;
+    static const unsigned int CachedTextureTargetCount = 11;
+
+    // Value in the cache when the bound object is not known
+    static const GLuint UnknownBinding = ~0u;
+
+    // Active texture unit, and objects bound to each texture unit, by target
+    GLuint m_activeTextureUnit;
+    std::array<std::array<GLuint, CachedTextureTargetCount>, CachedTextureUnitCount> m_boundTextures;
+    std::array<GLuint, CachedTextureUnitCount> m_boundSamplers;
+
+    // Buffer range bound to each uniform buffer binding point. Only the first ones are cached
+    struct UniformBufferBinding
+    {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+    static const unsigned int CachedUniformBufferCount = 16;
+    std::array<UniformBufferBinding, CachedUniformBufferCount> m_boundUniformBuffers;
+
+    BindingStats m_bindingStats;
+
+    // Framebuffer size waiting to be applied by the thread that owns the context, packed as (width << 32 | height)
+    std::atomic<unsigned long long> m_pendingViewport;
+
 private:
     // Singleton instance
     static DeviceGL* m_instance;
 
+    // If objects should use the Direct State Access path
+    static bool s_directStateAccessEnabled;
+
+    // If the KHR_parallel_shader_compile extension (or the ARB one) is available
+    static bool s_parallelShaderCompileSupported;
+
+    // Function of the extension, loaded when the context is created
+    using MaxShaderCompilerThreadsFunction = void (APIENTRYP)(GLuint count);
+    static MaxShaderCompilerThreadsFunction s_maxShaderCompilerThreads;
+
     // Callback called when the framebuffer changes size
     static void FrameBufferResized(GLFWwindow* window, GLsizei width, GLsizei height);
 };
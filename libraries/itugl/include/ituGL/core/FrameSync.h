@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ituGL/core/GpuFence.h>
+#include <vector>
+
+// Tracks the frames the GPU may still be working on, with one fence per frame
+// Each frame uses one slot, in a ring of framesInFlight slots. When a slot comes back, BeginFrame waits on its fence,
+// so the resources of that slot are not in use by the GPU anymore and can be written without implicit synchronization
+class FrameSync
+{
+public:
+    // 3 slots: the frame being recorded, the one in the GPU, and one queued by the driver
+    FrameSync(unsigned int framesInFlight = 3);
+
+    FrameSync(const FrameSync&) = delete;
+    void operator = (const FrameSync&) = delete;
+
+    // Call before writing the resources of the frame. Waits for the GPU to finish the frame that used the same slot
+    void BeginFrame();
+
+    // Call after submitting the GL commands that use the resources of the frame
+    void EndFrame();
+
+    inline unsigned int GetFramesInFlight() const { return static_cast<unsigned int>(m_fences.size()); }
+
+    // Number of frames started
+    inline unsigned long long GetFrameIndex() const { return m_frameIndex; }
+
+    // Slot used by the current frame, to select the version of the resources
+    inline unsigned int GetSlotIndex() const { return static_cast<unsigned int>(m_frameIndex % m_fences.size()); }
+
+    // Number of times BeginFrame had to block because the GPU was not done with the slot
+    inline unsigned int GetStallCount() const { return m_stallCount; }
+
+private:
+    std::vector<GpuFence> m_fences;
+
+    unsigned long long m_frameIndex;
+
+    unsigned int m_stallCount;
+};
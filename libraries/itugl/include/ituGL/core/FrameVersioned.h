@@ -0,0 +1,33 @@
+#pragma once
+
+#include <ituGL/core/FrameSync.h>
+#include <vector>
+
+// One copy of a dynamic resource (buffer, VAO + VBO, uniform block...) per frame in flight
+// Get() returns the copy of the current frame slot, that the GPU is not reading if FrameSync::BeginFrame was called
+// T must be default constructible. Resources that accumulate changes need to apply them to each copy when it becomes current
+template<typename T>
+class FrameVersioned
+{
+public:
+    FrameVersioned(const FrameSync& frameSync);
+
+    // Copy of the current frame
+    T& Get() { return m_versions[m_frameSync.GetSlotIndex()]; }
+    const T& Get() const { return m_versions[m_frameSync.GetSlotIndex()]; }
+
+    // Access to all the copies, for initialization
+    unsigned int GetVersionCount() const { return static_cast<unsigned int>(m_versions.size()); }
+    T& GetVersion(unsigned int index) { return m_versions[index]; }
+    const T& GetVersion(unsigned int index) const { return m_versions[index]; }
+
+private:
+    const FrameSync& m_frameSync;
+
+    std::vector<T> m_versions;
+};
+
+template<typename T>
+FrameVersioned<T>::FrameVersioned(const FrameSync& frameSync) : m_frameSync(frameSync), m_versions(frameSync.GetFramesInFlight())
+{
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Wrapper over a GL sync object. Once inserted, it is signaled when the GPU completes all the previous commands
+// It is not an Object: sync objects have no GLuint handle and can't be bound
+class GpuFence
+{
+public:
+    // Wait forever
+    static const GLuint64 InfiniteTimeout = ~0ull;
+
+public:
+    GpuFence();
+    ~GpuFence();
+
+    // Non-copyable, otherwise the same sync could be deleted twice
+    GpuFence(const GpuFence&) = delete;
+    void operator = (const GpuFence&) = delete;
+
+    // Move semantics
+    GpuFence(GpuFence&& fence) noexcept;
+    GpuFence& operator = (GpuFence&& fence) noexcept;
+
+    // Insert the fence after the commands submitted so far. Replaces the previous one, if any
+    void Insert();
+
+    // Delete the fence, as if it was never inserted
+    void Reset();
+
+    // Check if the fence has been inserted and not reset
+    inline bool IsInserted() const { return m_sync != nullptr; }
+
+    // Check without blocking if the GPU reached the fence. True if the fence was not inserted
+    bool IsSignaled() const;
+
+    // Block until the GPU reaches the fence, or the timeout (in nanoseconds) expires. Returns false on timeout
+    // True if the fence was not inserted
+    bool Wait(GLuint64 timeout = InfiniteTimeout) const;
+
+private:
+    GLsync m_sync;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Wrapper over a GL timestamp query. Once recorded, it gets the GPU time when all the previous commands completed
+// Like GpuFence, it is not an Object: query objects can't be bound
+class GpuTimestamp
+{
+public:
+    GpuTimestamp();
+    ~GpuTimestamp();
+
+    // Non-copyable, otherwise the same query could be deleted twice
+    GpuTimestamp(const GpuTimestamp&) = delete;
+    void operator = (const GpuTimestamp&) = delete;
+
+    // Move semantics
+    GpuTimestamp(GpuTimestamp&& timestamp) noexcept;
+    GpuTimestamp& operator = (GpuTimestamp&& timestamp) noexcept;
+
+    // Record the time after the commands submitted so far. Replaces the previous one, if any
+    void Record();
+
+    // Delete the query, as if it was never recorded
+    void Reset();
+
+    // Check if the timestamp has been recorded and not reset
+    inline bool IsRecorded() const { return m_query != 0; }
+
+    // Check without blocking if the GPU already wrote the time
+    bool IsAvailable() const;
+
+    // GPU time in nanoseconds. Blocks until it is available
+    GLuint64 GetTime() const;
+
+    // Current GPU time in nanoseconds, when the commands submitted so far reach the GPU, without waiting for them to complete
+    static GLuint64 GetCurrentTime();
+
+private:
+    GLuint m_query;
+};
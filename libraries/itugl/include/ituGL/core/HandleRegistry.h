@@ -0,0 +1,215 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cassert>
+
+// 32-bit handle to an item in a HandleRegistry
+// The lower bits are the slot index, the upper bits the generation of the slot when the item was added.
+// When an item is removed the generation changes, so old handles stop being valid instead of pointing to a new item
+template<typename T>
+class RegistryHandle
+{
+public:
+    inline RegistryHandle() : m_value(InvalidValue) {}
+
+    inline bool IsValid() const { return m_value != InvalidValue; }
+
+    inline unsigned int GetIndex() const { return m_value & IndexMask; }
+    inline unsigned int GetGeneration() const { return m_value >> IndexBits; }
+
+    // Raw value, for sorting or hashing
+    inline unsigned int GetValue() const { return m_value; }
+
+    inline bool operator == (const RegistryHandle& other) const { return m_value == other.m_value; }
+    inline bool operator != (const RegistryHandle& other) const { return m_value != other.m_value; }
+
+public:
+    static constexpr unsigned int IndexBits = 20;
+    static constexpr unsigned int IndexMask = (1u << IndexBits) - 1;
+    static constexpr unsigned int GenerationMask = (1u << (32 - IndexBits)) - 1;
+    static constexpr unsigned int InvalidValue = ~0u;
+
+private:
+    template<typename U>
+    friend class HandleRegistry;
+
+    inline RegistryHandle(unsigned int index, unsigned int generation)
+        : m_value(((generation & GenerationMask) << IndexBits) | index)
+    {
+    }
+
+private:
+    unsigned int m_value;
+};
+
+// Registry that stores items contiguously and gives out generational handles to them
+// Access by handle is two array lookups, without hashing or reference counting
+// Removing an item moves the last one into its place, so the items are always dense
+template<typename T>
+class HandleRegistry
+{
+public:
+    using Handle = RegistryHandle<T>;
+
+public:
+    HandleRegistry();
+
+    // Add a new item and return its handle
+    Handle Add(T&& item);
+    Handle Add(const T& item);
+
+    // Remove the item. Returns false if the handle was not valid
+    bool Remove(Handle handle);
+
+    // Remove all the items. Existing handles become invalid
+    void Clear();
+
+    // Check if the handle points to an item that is still in the registry
+    bool IsValid(Handle handle) const;
+
+    // Get the item of the handle, or nullptr if the handle is not valid
+    T* Get(Handle handle);
+    const T* Get(Handle handle) const;
+
+    // Dense access to all the items. The order changes when items are removed
+    unsigned int GetCount() const { return static_cast<unsigned int>(m_items.size()); }
+    std::span<T> GetItems() { return m_items; }
+    std::span<const T> GetItems() const { return m_items; }
+
+private:
+    struct Slot
+    {
+        // Position of the item in m_items, if the slot is in use
+        unsigned int itemIndex;
+
+        // Increased every time the slot is released
+        unsigned int generation;
+    };
+
+    Handle AddSlot();
+
+private:
+    // Items, stored contiguously
+    std::vector<T> m_items;
+
+    // Slot index of each item, to fix the slot when an item is moved
+    std::vector<unsigned int> m_itemSlots;
+
+    // Indirection from handle index to item
+    std::vector<Slot> m_slots;
+
+    // Slots that can be reused
+    std::vector<unsigned int> m_freeSlots;
+};
+
+template<typename T>
+HandleRegistry<T>::HandleRegistry()
+{
+}
+
+template<typename T>
+typename HandleRegistry<T>::Handle HandleRegistry<T>::Add(T&& item)
+{
+    Handle handle = AddSlot();
+    m_items.push_back(std::move(item));
+    return handle;
+}
+
+template<typename T>
+typename HandleRegistry<T>::Handle HandleRegistry<T>::Add(const T& item)
+{
+    Handle handle = AddSlot();
+    m_items.push_back(item);
+    return handle;
+}
+
+template<typename T>
+typename HandleRegistry<T>::Handle HandleRegistry<T>::AddSlot()
+{
+    unsigned int slotIndex;
+    if (!m_freeSlots.empty())
+    {
+        slotIndex = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slotIndex = static_cast<unsigned int>(m_slots.size());
+        assert(slotIndex < Handle::IndexMask);
+        m_slots.push_back(Slot{ 0, 0 });
+    }
+
+    Slot& slot = m_slots[slotIndex];
+    slot.itemIndex = static_cast<unsigned int>(m_items.size());
+    m_itemSlots.push_back(slotIndex);
+
+    return Handle(slotIndex, slot.generation);
+}
+
+template<typename T>
+bool HandleRegistry<T>::Remove(Handle handle)
+{
+    if (!IsValid(handle))
+    {
+        return false;
+    }
+
+    unsigned int slotIndex = handle.GetIndex();
+    Slot& slot = m_slots[slotIndex];
+    unsigned int itemIndex = slot.itemIndex;
+    unsigned int lastIndex = static_cast<unsigned int>(m_items.size()) - 1;
+
+    // Move the last item into the gap and fix its slot
+    if (itemIndex != lastIndex)
+    {
+        m_items[itemIndex] = std::move(m_items[lastIndex]);
+        m_itemSlots[itemIndex] = m_itemSlots[lastIndex];
+        m_slots[m_itemSlots[itemIndex]].itemIndex = itemIndex;
+    }
+    m_items.pop_back();
+    m_itemSlots.pop_back();
+
+    // Invalidate existing handles to this slot. Skip the generation that would produce the invalid value
+    slot.generation = (slot.generation + 1) & Handle::GenerationMask;
+    if (Handle(slotIndex, slot.generation).GetValue() == Handle::InvalidValue)
+    {
+        slot.generation = 0;
+    }
+    m_freeSlots.push_back(slotIndex);
+
+    return true;
+}
+
+template<typename T>
+void HandleRegistry<T>::Clear()
+{
+    // Release all the slots in use, so old handles are not valid anymore
+    while (!m_items.empty())
+    {
+        unsigned int slotIndex = m_itemSlots.back();
+        Remove(Handle(slotIndex, m_slots[slotIndex].generation));
+    }
+}
+
+template<typename T>
+bool HandleRegistry<T>::IsValid(Handle handle) const
+{
+    unsigned int slotIndex = handle.GetIndex();
+    return handle.IsValid() && slotIndex < m_slots.size()
+        && m_slots[slotIndex].generation == handle.GetGeneration()
+        && m_slots[slotIndex].itemIndex < m_items.size()
+        && m_itemSlots[m_slots[slotIndex].itemIndex] == slotIndex;
+}
+
+template<typename T>
+T* HandleRegistry<T>::Get(Handle handle)
+{
+    return IsValid(handle) ? &m_items[m_slots[handle.GetIndex()].itemIndex] : nullptr;
+}
+
+template<typename T>
+const T* HandleRegistry<T>::Get(Handle handle) const
+{
+    return IsValid(handle) ? &m_items[m_slots[handle.GetIndex()].itemIndex] : nullptr;
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <ituGL/core/WorkStealingQueue.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// Task scheduler shared by all the CPU heavy work (loading, culling, scene collection...)
+// Each worker thread owns a work stealing deque. Idle workers steal from the others.
+// Jobs can depend on other jobs, forming a graph. Jobs with main thread affinity only run inside RunMainThreadJobs (or Wait, on the main thread),
+// so they can use the GL context.
+class JobSystem
+{
+public:
+    enum class Affinity
+    {
+        // Any worker, or the main thread while it waits
+        AnyThread,
+        // Only the main thread (the one that created the job system). Use it for GL calls
+        MainThread
+    };
+
+    using JobFunction = std::function<void()>;
+
+    // Receives a range [begin, end) of the indices
+    using RangeFunction = std::function<void(unsigned int, unsigned int)>;
+
+    // Optional callbacks around each job, for profiling. They receive the job name and the thread index
+    struct ProfilerHooks
+    {
+        std::function<void(const char*, unsigned int)> jobBegin;
+        std::function<void(const char*, unsigned int)> jobEnd;
+    };
+
+    // Internal job data, reference counted
+    struct Job;
+
+    // Reference to a job. Keeps the job data alive, even after it finished
+    class JobHandle
+    {
+    public:
+        JobHandle();
+        ~JobHandle();
+        JobHandle(const JobHandle& other);
+        JobHandle(JobHandle&& other) noexcept;
+        JobHandle& operator = (JobHandle other) noexcept;
+
+        bool IsValid() const { return m_job != nullptr; }
+
+    private:
+        friend class JobSystem;
+        explicit JobHandle(Job* job);
+
+        Job* m_job;
+    };
+
+    // Index of the main thread, as returned by GetCurrentThreadIndex
+    static const unsigned int MainThreadIndex = 0;
+
+    // Index returned for threads that don't belong to the job system
+    static const unsigned int ExternalThreadIndex = ~0u;
+
+public:
+    // Must be created in the main thread. By default, one worker per hardware thread, minus the main thread
+    JobSystem(unsigned int workerCount = GetDefaultWorkerCount());
+
+    // All submitted jobs must be finished before destroying the job system
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    void operator = (const JobSystem&) = delete;
+
+    // Create a job. It will not run until it is submitted
+    JobHandle CreateJob(JobFunction function, const char* name = "Job", Affinity affinity = Affinity::AnyThread);
+
+    // The job will not start until the dependency has finished. Must be called before submitting the job
+    void AddDependency(const JobHandle& job, const JobHandle& dependency);
+
+    // Allow the job to run, as soon as all its dependencies are finished
+    void Submit(const JobHandle& job);
+
+    // Create and submit a job
+    JobHandle Run(JobFunction function, const char* name = "Job", Affinity affinity = Affinity::AnyThread);
+
+    // Check if the job has finished running
+    bool IsDone(const JobHandle& job) const;
+
+    // Wait until the job has finished, running other jobs in the meantime
+    void Wait(const JobHandle& job);
+
+    // Call the function over the range [begin, end) split in chunks, and wait for all of them
+    // If grainSize is 0, the chunk size adapts to the number of threads
+    void ParallelFor(unsigned int begin, unsigned int end, const RangeFunction& function, unsigned int grainSize = 0, const char* name = "ParallelFor");
+
+    // Run the pending main thread jobs. Call it from the main thread, for example once per frame
+    // Returns the number of jobs executed
+    unsigned int RunMainThreadJobs();
+
+    // Set the profiler callbacks. Only while no job is running
+    void SetProfilerHooks(const ProfilerHooks& profilerHooks);
+
+    unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+    bool IsMainThread() const;
+
+    // Index of the calling thread: MainThreadIndex, 1..WorkerCount for the workers, or ExternalThreadIndex
+    unsigned int GetCurrentThreadIndex() const;
+
+    static unsigned int GetDefaultWorkerCount();
+
+private:
+    using JobQueue = WorkStealingQueue<Job*>;
+
+    void WorkerLoop(unsigned int threadIndex);
+
+    // Put a job with all its dependencies finished in a queue
+    void Schedule(Job* job);
+
+    // Find a job and run it. Returns false if there was nothing to run
+    bool TryRunJob(unsigned int threadIndex);
+
+    bool TryGetJob(unsigned int threadIndex, Job*& job);
+
+    void Execute(Job* job, unsigned int threadIndex);
+    void Finish(Job* job);
+
+    static void AddReference(Job* job);
+    static void RemoveReference(Job* job);
+
+private:
+    std::vector<std::thread> m_workers;
+
+    // One deque per thread: main thread first, then the workers
+    std::vector<std::unique_ptr<JobQueue>> m_queues;
+
+    // Jobs submitted from threads without a deque
+    std::mutex m_injectionMutex;
+    std::deque<Job*> m_injectionQueue;
+
+    // Jobs that can only run in the main thread
+    std::mutex m_mainThreadMutex;
+    std::deque<Job*> m_mainThreadQueue;
+
+    // Jobs in any queue except the main thread one, used to put idle workers to sleep
+    std::atomic<int> m_queuedJobCount;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+
+    std::thread::id m_mainThreadId;
+
+    ProfilerHooks m_profilerHooks;
+
+    std::atomic<bool> m_stop;
+};
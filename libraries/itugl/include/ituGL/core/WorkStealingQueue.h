@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+
+// Chase-Lev work stealing deque with a fixed capacity
+// The owner thread pushes and pops at the bottom, other threads steal from the top
+// T must be trivially copyable (usually a pointer)
+template<typename T, unsigned int Capacity = 4096>
+class WorkStealingQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    WorkStealingQueue();
+
+    WorkStealingQueue(const WorkStealingQueue&) = delete;
+    void operator = (const WorkStealingQueue&) = delete;
+
+    // Owner only. Returns false if the queue is full
+    bool Push(T item);
+
+    // Owner only. Returns false if the queue is empty
+    bool Pop(T& item);
+
+    // Any thread. Returns false if the queue is empty or another thread took the item first
+    bool Steal(T& item);
+
+    // Approximate, only for heuristics
+    bool IsEmpty() const;
+
+private:
+    static constexpr std::int64_t Mask = Capacity - 1;
+
+    // Next item to steal
+    alignas(64) std::atomic<std::int64_t> m_top;
+
+    // Next free position for the owner
+    alignas(64) std::atomic<std::int64_t> m_bottom;
+
+    std::array<std::atomic<T>, Capacity> m_items;
+};
+
+template<typename T, unsigned int Capacity>
+WorkStealingQueue<T, Capacity>::WorkStealingQueue() : m_top(0), m_bottom(0)
+{
+}
+
+template<typename T, unsigned int Capacity>
+bool WorkStealingQueue<T, Capacity>::Push(T item)
+{
+    std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    std::int64_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<std::int64_t>(Capacity))
+    {
+        return false;
+    }
+
+    m_items[bottom & Mask].store(item, std::memory_order_relaxed);
+
+    // Release, so thieves that see the new bottom also see the item
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T, unsigned int Capacity>
+bool WorkStealingQueue<T, Capacity>::Pop(T& item)
+{
+    std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_relaxed);
+
+    // Reserve the bottom item before reading top, so thieves see it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        // Empty, restore
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return false;
+    }
+
+    item = m_items[bottom & Mask].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // Last item, race against thieves for it
+        bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return won;
+    }
+    return true;
+}
+
+template<typename T, unsigned int Capacity>
+bool WorkStealingQueue<T, Capacity>::Steal(T& item)
+{
+    std::int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+    {
+        return false;
+    }
+
+    item = m_items[top & Mask].load(std::memory_order_relaxed);
+
+    // Another thief or the owner could have taken it
+    return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+template<typename T, unsigned int Capacity>
+bool WorkStealingQueue<T, Capacity>::IsEmpty() const
+{
+    return m_top.load(std::memory_order_relaxed) >= m_bottom.load(std::memory_order_relaxed);
+}
@@ -19,6 +19,10 @@ public:
     template<typename T>
     inline void AllocateData(std::span<T> data, Usage usage = Usage::StaticDraw) { AllocateData(std::span<const T>(data), usage); }
 
+    // AllocateStorage template method for any type of data span. Type must be one of the supported types
+    template<typename T>
+    void AllocateStorage(std::span<const T> data, GLbitfield flags = StorageFlags::StorageNone);
+
     // UpdateData template method for any type of data span. Type must be one of the supported types
     template<typename T>
     void UpdateData(std::span<const T> data, size_t offsetBytes = 0);
@@ -48,6 +52,14 @@ void ElementBufferObject::AllocateData(std::span<const T> data, Usage usage)
     BufferObject::AllocateData(Data::GetBytes(data), usage);
 }
 
+// Call the base implementation with the span converted to bytes
+template<typename T>
+void ElementBufferObject::AllocateStorage(std::span<const T> data, GLbitfield flags)
+{
+    assert(IsSupportedType(Data::GetType<T>()));
+    BufferObject::AllocateStorage(Data::GetBytes(data), flags);
+}
+
 // Call the base implementation with the span converted to bytes
 template<typename T>
 void ElementBufferObject::UpdateData(std::span<const T> data, size_t offsetBytes)
@@ -4,8 +4,10 @@
 #include <ituGL/geometry/ElementBufferObject.h>
 #include <ituGL/geometry/VertexArrayObject.h>
 #include <ituGL/geometry/VertexAttribute.h>
+#include <ituGL/geometry/VertexLayout.h>
 #include <ituGL/geometry/Drawcall.h>
 #include <ituGL/shader/ShaderProgram.h>
+#include <ituGL/core/DeviceGL.h>
 #include <vector>
 #include <unordered_map>
 
@@ -23,11 +25,11 @@ public:
     // Adds a new VBO with uninitialized data
     unsigned int AddVertexData(size_t size);
 
-    // Adds a new VBO and initializes it with data
+    // Adds a new VBO and initializes it with data. The data can't be modified later
     template<typename T>
     unsigned int AddVertexData(std::span<const T> vertices);
 
-    // Adds a new VBO and initializes it with data
+    // Adds a new EBO and initializes it with data. The data can't be modified later
     template<typename T>
     unsigned int AddElementData(std::span<const T> elements);
 
@@ -40,6 +42,10 @@ public:
     template<typename TIterator>
     unsigned int AddVertexArray(unsigned int vboIndex, TIterator& it, const TIterator itEnd, const SemanticMap& locations = SemanticMap());
 
+    // Adds a new VAO, with data stored in a single VBO inside the mesh, and all the attribute layouts at once, like a VertexLayout
+    // Interleaved layouts use a single buffer binding point with Direct State Access
+    unsigned int AddVertexArray(unsigned int vboIndex, std::span<const VertexAttribute::Layout> layouts, const SemanticMap& locations = SemanticMap());
+
     // (C++) 7
     // Adds a new VAO, with data stored in several VBOs inside the mesh, and an iterator for the attributes
     // vboIndices are the indices inside m_vbos of the VBOs to be used
@@ -100,6 +106,19 @@ public:
         std::span<const TVertex> vertices, std::span<const TElement> elements,
         TIterator it, const TIterator itEnd, const SemanticMap& locations = SemanticMap());
 
+    // Adds a new submesh, adding a new VAO and a new VBO initialized with the vertex data, using the layout of the vertex struct
+    template<typename TVertex, std::size_t N>
+    unsigned int AddSubmesh(Drawcall::Primitive primitive,
+        std::span<const TVertex> vertices,
+        const VertexLayout<TVertex, N>& layout, const SemanticMap& locations = SemanticMap());
+
+    // Adds a new submesh, adding a new VAO, a new VBO initialized with the vertex data and an EBO initialized with the element data,
+    // using the layout of the vertex struct
+    template<typename TVertex, typename TElement, std::size_t N>
+    unsigned int AddSubmesh(Drawcall::Primitive primitive,
+        std::span<const TVertex> vertices, std::span<const TElement> elements,
+        const VertexLayout<TVertex, N>& layout, const SemanticMap& locations = SemanticMap());
+
     inline unsigned int GetVertexBufferCount() const { return static_cast<unsigned int>(m_vbos.size()); }
     inline const VertexBufferObject& GetVertexBuffer(unsigned int vboIndex) const { return m_vbos[vboIndex]; }
 
@@ -136,8 +155,11 @@ private:
     inline const Submesh& GetSubmesh(unsigned int submeshIndex) const { return m_submeshes[submeshIndex]; }
     inline Submesh& GetSubmesh(unsigned int submeshIndex) { return m_submeshes[submeshIndex]; }
 
-    // Set a vertex attribute in a VAO, using the specified layout, and increases the location index according to the size of the attribute
-    void SetupVertexAttribute(VertexArrayObject& vao, const VertexAttribute::Layout& attributeLayout, GLuint& location, const SemanticMap& locations);
+    // Set a vertex attribute in a VAO, reading from the VBO with the specified layout, and increases the location index according to the size of the attribute
+    void SetupVertexAttribute(VertexArrayObject& vao, const VertexBufferObject& vbo, const VertexAttribute::Layout& attributeLayout, GLuint& location, const SemanticMap& locations);
+
+    // Attach an EBO to a VAO
+    void SetupElementBuffer(VertexArrayObject& vao, const ElementBufferObject& ebo);
 
 private:
     // All the VBOs used in this mesh
@@ -158,9 +180,17 @@ unsigned int Mesh::AddVertexData(std::span<const T> vertices)
 {
     unsigned int vboIndex = GetVertexBufferCount();
     VertexBufferObject& vbo = m_vbos.emplace_back();
-    vbo.Bind();
-    vbo.AllocateData<T>(vertices);
-    vbo.Unbind();
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        // No need to bind it
+        vbo.AllocateStorage<T>(vertices);
+    }
+    else
+    {
+        vbo.Bind();
+        vbo.AllocateStorage<T>(vertices);
+        vbo.Unbind();
+    }
     return vboIndex;
 }
 
@@ -169,9 +199,17 @@ unsigned int Mesh::AddElementData(std::span<const T> elements)
 {
     unsigned int index = GetElementBufferCount();
     ElementBufferObject& ebo = m_ebos.emplace_back();
-    ebo.Bind();
-    ebo.AllocateData(elements);
-    ebo.Unbind();
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        // No need to bind it
+        ebo.AllocateStorage(elements);
+    }
+    else
+    {
+        ebo.Bind();
+        ebo.AllocateStorage(elements);
+        ebo.Unbind();
+    }
     return index;
 }
 
@@ -180,20 +218,28 @@ unsigned int Mesh::AddVertexArray(unsigned int vboIndex, TIterator& it, const TI
 {
     unsigned int vaoIndex = AddVertexArray();
 
+    // With Direct State Access, the attributes are set without binding anything
+    bool bindToEdit = !DeviceGL::IsDirectStateAccessEnabled();
+
     VertexArrayObject& vao = GetVertexArray(vaoIndex);
-    vao.Bind();
+    if (bindToEdit)
+    {
+        vao.Bind();
+    }
 
     GLuint location = 0;
     const VertexBufferObject& vbo = GetVertexBuffer(vboIndex);
-    vbo.Bind();
     while (it != itEnd)
     {
-        SetupVertexAttribute(vao, *it, location, locations);
+        SetupVertexAttribute(vao, vbo, *it, location, locations);
         it++;
     }
 
-    VertexBufferObject::Unbind();
-    VertexArrayObject::Unbind();
+    if (bindToEdit)
+    {
+        VertexBufferObject::Unbind();
+        VertexArrayObject::Unbind();
+    }
 
     return vaoIndex;
 }
@@ -203,8 +249,14 @@ unsigned int Mesh::AddVertexArray(std::span<unsigned int> vboIndices, TIterator&
 {
     unsigned int vaoIndex = AddVertexArray();
 
-    const VertexArrayObject& vao = GetVertexArray(vaoIndex);
-    vao.Bind();
+    // With Direct State Access, the attributes are set without binding anything
+    bool bindToEdit = !DeviceGL::IsDirectStateAccessEnabled();
+
+    VertexArrayObject& vao = GetVertexArray(vaoIndex);
+    if (bindToEdit)
+    {
+        vao.Bind();
+    }
 
     GLuint location = 0;
     int i = 0;
@@ -214,16 +266,17 @@ unsigned int Mesh::AddVertexArray(std::span<unsigned int> vboIndices, TIterator&
         if (i < vboIndices.size() && vboIndex != vboIndices[i])
         {
             vboIndex = vboIndices[i];
-            VertexBufferObject& vbo = m_vbos[vboIndex];
-            vbo.Bind();
             i++;
         }
-        SetupVertexAttribute(vao, *it, location, locations);
+        SetupVertexAttribute(vao, m_vbos[vboIndex], *it, location, locations);
         it++;
     }
 
-    VertexBufferObject::Unbind();
-    VertexArrayObject::Unbind();
+    if (bindToEdit)
+    {
+        VertexBufferObject::Unbind();
+        VertexArrayObject::Unbind();
+    }
 
     return vaoIndex;
 }
@@ -253,14 +306,7 @@ unsigned int Mesh::AddSubmesh(Drawcall::Primitive primitive, int firstElement, i
 {
     unsigned int vaoIndex = AddVertexArray(vboIndex, it, itEnd, locations);
 
-    VertexArrayObject& vao = GetVertexArray(vaoIndex);
-    vao.Bind();
-
-    const ElementBufferObject& ebo = GetElementBuffer(eboIndex);
-    ebo.Bind();
-
-    VertexArrayObject::Unbind();
-    ElementBufferObject::Unbind();
+    SetupElementBuffer(GetVertexArray(vaoIndex), GetElementBuffer(eboIndex));
 
     return AddSubmesh(vaoIndex, primitive, firstElement, elementCount, elementType);
 }
@@ -272,14 +318,7 @@ unsigned int Mesh::AddSubmesh(Drawcall::Primitive primitive, int firstElement, i
 {
     unsigned int vaoIndex = AddVertexArray(vboIndices, it, itEnd, locations);
 
-    VertexArrayObject& vao = m_vaos[vaoIndex];
-    vao.Bind();
-
-    ElementBufferObject& ebo = m_ebos[eboIndex];
-    ebo.Bind();
-
-    VertexArrayObject::Unbind();
-    ElementBufferObject::Unbind();
+    SetupElementBuffer(GetVertexArray(vaoIndex), GetElementBuffer(eboIndex));
 
     return AddSubmesh(vaoIndex, primitive, firstElement, elementCount, elementType);
 }
@@ -303,3 +342,26 @@ unsigned int Mesh::AddSubmesh(Drawcall::Primitive primitive,
     return AddSubmesh(primitive, 0, static_cast<int>(elements.size()), Data::GetType<TElement>(), vboIndex, eboIndex, it, itEnd, locations);
 }
 
+template<typename TVertex, std::size_t N>
+unsigned int Mesh::AddSubmesh(Drawcall::Primitive primitive,
+    std::span<const TVertex> vertices,
+    const VertexLayout<TVertex, N>& layout, const SemanticMap& locations)
+{
+    unsigned int vboIndex = AddVertexData(vertices);
+    unsigned int vaoIndex = AddVertexArray(vboIndex, layout, locations);
+    return AddSubmesh(vaoIndex, primitive, 0, static_cast<int>(vertices.size()), Data::Type::None);
+}
+
+template<typename TVertex, typename TElement, std::size_t N>
+unsigned int Mesh::AddSubmesh(Drawcall::Primitive primitive,
+    std::span<const TVertex> vertices, std::span<const TElement> elements,
+    const VertexLayout<TVertex, N>& layout, const SemanticMap& locations)
+{
+    unsigned int vboIndex = AddVertexData(vertices);
+    unsigned int eboIndex = AddElementData(elements);
+    unsigned int vaoIndex = AddVertexArray(vboIndex, layout, locations);
+
+    SetupElementBuffer(GetVertexArray(vaoIndex), GetElementBuffer(eboIndex));
+
+    return AddSubmesh(vaoIndex, primitive, 0, static_cast<int>(elements.size()), Data::GetType<TElement>());
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ituGL/renderer/RenderLayer.h>
 #include <memory>
 #include <vector>
 
@@ -33,6 +34,11 @@ public:
     // Clear the list of materials
     void ClearMaterials();
 
+    // Render layers this model is allowed in, combined with the layers of each material. Default: All
+    // For example, remove ShadowCaster to keep the model out of the shadow maps
+    RenderLayerMask GetLayerMask() const;
+    void SetLayerMask(RenderLayerMask layerMask);
+
     // Draw all the submeshes of the mesh, each one with a material on the list
     void Draw();
 
@@ -42,4 +48,7 @@ private:
 
     // List of material pointers, one for each submesh
     std::vector<std::shared_ptr<Material>> m_materials;
+
+    // Render layers of the model, masking the layers of the materials
+    RenderLayerMask m_layerMask;
 };
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <ituGL/core/Object.h>
+#include <ituGL/geometry/VertexAttribute.h>
+#include <span>
 
-class VertexAttribute;
+class VertexBufferObject;
+class ElementBufferObject;
 
 // Vertex Array Object (VAO) is an OpenGL Object that stores all of the state needed to supply vertex data
 // Data is provided as a set of VertexAttributes
@@ -27,6 +30,20 @@ public:
     // stride: how far each element is from the previous one. Default value 0 will use the attribute size
     void SetAttribute(GLuint location, const VertexAttribute& attribute, GLint offset, GLsizei stride = 0);
 
+    // Same as above, but reading from the specified VertexBufferObject instead of the bound one
+    // With Direct State Access enabled, neither this VertexArrayObject nor the VertexBufferObject need to be bound
+    void SetAttribute(const VertexBufferObject& vbo, GLuint location, const VertexAttribute& attribute, GLint offset, GLsizei stride = 0);
+
+    // Sets all the attributes of a layout, like a VertexLayout, in consecutive locations starting at firstLocation
+    // With Direct State Access, interleaved attributes share a single buffer binding point. Without it, this VertexArrayObject must be bound
+    void SetAttributes(const VertexBufferObject& vbo, std::span<const VertexAttribute::Layout> layouts, GLuint firstLocation = 0);
+
+    // Same as above, with the location of each attribute, for example from a Mesh::SemanticMap
+    void SetAttributes(const VertexBufferObject& vbo, std::span<const VertexAttribute::Layout> layouts, std::span<const GLuint> locations);
+
+    // Sets the ElementBufferObject used by the drawcalls. Without Direct State Access, this VertexArrayObject must be bound
+    void SetElementBuffer(const ElementBufferObject& ebo);
+
 #ifndef NDEBUG
     // Check if there is any VertexArrayObject currently bound
     inline static bool IsAnyBound() { return s_boundHandle != Object::NullHandle; }
@@ -23,8 +23,14 @@ public:
     };
 
 public:
-    VertexAttribute(Data::Type type, int components, Semantic semantic = Semantic::Unknown);
-    VertexAttribute(Data::Type type, int components, bool normalized, Semantic semantic = Semantic::Unknown);
+    constexpr VertexAttribute(Data::Type type, int components, Semantic semantic = Semantic::Unknown)
+        : VertexAttribute(type, components, false, semantic)
+    {
+    }
+    constexpr VertexAttribute(Data::Type type, int components, bool normalized, Semantic semantic = Semantic::Unknown)
+        : m_type(type), m_components(components), m_normalized(normalized), m_semantic(semantic)
+    {
+    }
 
     inline Data::Type GetType() const { return m_type; }
     inline int GetComponents() const { return m_components; }
@@ -53,7 +59,10 @@ private:
 class VertexAttribute::Layout
 {
 public:
-    Layout(const VertexAttribute& attribute, GLint offset, GLsizei stride);
+    constexpr Layout(const VertexAttribute& attribute, GLint offset, GLsizei stride)
+        : m_attribute(attribute), m_offset(offset), m_stride(stride)
+    {
+    }
 
     inline const VertexAttribute& GetAttribute() const { return m_attribute; }
     inline GLint GetOffset() const { return m_offset; }
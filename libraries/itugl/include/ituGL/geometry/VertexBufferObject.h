@@ -21,6 +21,12 @@ public:
     template<typename T>
     inline void AllocateData(std::span<T> data, Usage usage = Usage::StaticDraw) { AllocateData(std::span<const T>(data), usage); }
 
+    // Use the same AllocateStorage methods from the base class
+    using BufferObject::AllocateStorage;
+    // Additionally, provide AllocateStorage template method for any type of data span. By default, the contents can't be updated
+    template<typename T>
+    void AllocateStorage(std::span<const T> data, GLbitfield flags = StorageFlags::StorageNone);
+
     // (C++) 3
     // Use the same UpdateData methods from the base class
     using BufferObject::UpdateData;
@@ -39,6 +45,13 @@ void VertexBufferObject::AllocateData(std::span<const T> data, Usage usage)
     AllocateData(Data::GetBytes(data), usage);
 }
 
+// Call the base implementation with the span converted to bytes
+template<typename T>
+void VertexBufferObject::AllocateStorage(std::span<const T> data, GLbitfield flags)
+{
+    AllocateStorage(Data::GetBytes(data), flags);
+}
+
 // Call the base implementation with the span converted to bytes
 template<typename T>
 void VertexBufferObject::UpdateData(std::span<const T> data, size_t offsetBytes)
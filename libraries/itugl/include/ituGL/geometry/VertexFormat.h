@@ -36,10 +36,10 @@ public:
     void AddVertexAttribute(Data::Type type, int components, bool normalized, VertexAttribute::Semantic semantic);
 
     // Iterator at the first attribute, can be interleaved or contiguous
-    LayoutIterator LayoutBegin(int vertexCount, bool interleaved);
+    LayoutIterator LayoutBegin(int vertexCount, bool interleaved) const;
 
     // Iterator at the end of all attributes
-    LayoutIterator LayoutEnd();
+    LayoutIterator LayoutEnd() const;
 
 private:
     std::vector<VertexAttribute> m_attributes;
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <ituGL/geometry/VertexAttribute.h>
+#include <ituGL/core/Color.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <array>
+#include <algorithm>
+#include <span>
+#include <cstddef>
+#include <cassert>
+#include <type_traits>
+
+// Data type and number of components of the C++ types that can be used as vertex attributes
+// Specialize it to use other types in vertex structs
+template<typename T>
+struct VertexAttributeTraits;
+
+// Scalars
+template<typename T> requires std::is_arithmetic_v<T>
+struct VertexAttributeTraits<T>
+{
+    using ComponentType = T;
+    static constexpr Data::Type type = Data::GetType<T>();
+    static constexpr int components = 1;
+};
+
+// glm vectors, including the small integer ones (u8vec4, i16vec2...) used to pack attributes
+template<glm::length_t N, typename T, glm::qualifier Q>
+struct VertexAttributeTraits<glm::vec<N, T, Q>>
+{
+    using ComponentType = T;
+    static constexpr Data::Type type = VertexAttributeTraits<T>::type;
+    static constexpr int components = N;
+};
+
+// Color is stored as 4 floats
+template<>
+struct VertexAttributeTraits<Color>
+{
+    using ComponentType = float;
+    static constexpr Data::Type type = Data::Type::Float;
+    static constexpr int components = 4;
+};
+
+// Member of a vertex struct used as an attribute, with the semantic used to find its location
+// Integer members can be normalized, so the shader reads them as floats in [0, 1] or [-1, 1]. Useful to pack colors or normals
+template<typename TVertex, typename T>
+struct VertexMember
+{
+    constexpr VertexMember(T TVertex::* member, VertexAttribute::Semantic semantic = VertexAttribute::Semantic::Unknown, bool normalized = false)
+        : member(member), semantic(semantic), normalized(normalized)
+    {
+    }
+
+    T TVertex::* member;
+    VertexAttribute::Semantic semantic;
+    bool normalized;
+};
+
+// Layout of the attributes of a vertex struct, interleaved in a single VBO
+// Created with MakeVertexLayout at compile time, so it replaces a VertexFormat and its LayoutIterator
+// It can be passed to Mesh::AddSubmesh, or to VertexArrayObject::SetAttributes as a span of layouts
+template<typename TVertex, std::size_t N>
+class VertexLayout
+{
+public:
+    constexpr VertexLayout(const std::array<VertexAttribute::Layout, N>& attributes) : m_attributes(attributes)
+    {
+    }
+
+    // Distance between the attributes of consecutive vertices
+    static constexpr GLsizei GetStride() { return static_cast<GLsizei>(sizeof(TVertex)); }
+
+    static constexpr std::size_t GetAttributeCount() { return N; }
+    inline constexpr const VertexAttribute::Layout& GetAttribute(std::size_t index) const { return m_attributes[index]; }
+
+    // Same as the iterators of VertexFormat, to use with the Mesh methods that take them
+    inline constexpr const VertexAttribute::Layout* begin() const { return m_attributes.data(); }
+    inline constexpr const VertexAttribute::Layout* end() const { return m_attributes.data() + N; }
+
+    inline constexpr operator std::span<const VertexAttribute::Layout>() const { return m_attributes; }
+
+private:
+    std::array<VertexAttribute::Layout, N> m_attributes;
+};
+
+// Helpers for MakeVertexLayout, not relevant to the course
+namespace VertexLayoutDetail
+{
+    // Move the offset to the next multiple of the alignment of T
+    template<typename T>
+    constexpr std::size_t AlignOffset(std::size_t offset)
+    {
+        return (offset + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    // Size of a struct with members of these types, in this order, following the C++ layout rules
+    template<typename... T>
+    constexpr std::size_t GetStructSize()
+    {
+        std::size_t offset = 0;
+        std::size_t alignment = 1;
+        ((offset = AlignOffset<T>(offset) + sizeof(T), alignment = std::max(alignment, alignof(T))), ...);
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    // Check that the members are listed in the order they are declared. With that and the size check, the offsets computed from the types
+    // are the offsets of the members. The offsets can't be read from the member pointers at compile time, but their addresses can be compared
+    template<typename TVertex, typename... T>
+    consteval bool AreMembersInDeclarationOrder(const VertexMember<TVertex, T>&... members)
+    {
+        // Only the addresses are needed, the vertex is never constructed
+        union Storage
+        {
+            constexpr Storage() : unused() {}
+            char unused;
+            TVertex vertex;
+        };
+        Storage storage;
+
+        const void* addresses[] = { static_cast<const void*>(&(storage.vertex.*members.member))... };
+        for (std::size_t i = 1; i < sizeof...(T); ++i)
+        {
+            // Also fails if the same member is listed twice
+            if (!(addresses[i - 1] < addresses[i]))
+                return false;
+        }
+        return true;
+    }
+
+    // Not constexpr: calling it stops the compilation of MakeVertexLayout
+    void VertexMembersNotInDeclarationOrder();
+
+    // Layout of one member, placed after the previous ones. Advances the offset past it
+    template<typename TVertex, typename T>
+    constexpr VertexAttribute::Layout MakeAttributeLayout(const VertexMember<TVertex, T>& member, std::size_t& offset)
+    {
+        using Traits = VertexAttributeTraits<T>;
+        static_assert(sizeof(T) == sizeof(typename Traits::ComponentType) * Traits::components, "Attribute type must only contain its components");
+
+        // Floating point values can't be normalized
+        assert(!member.normalized || (Traits::type != Data::Type::Float && Traits::type != Data::Type::Double && Traits::type != Data::Type::Half));
+
+        offset = AlignOffset<T>(offset);
+        VertexAttribute attribute(Traits::type, Traits::components, member.normalized, member.semantic);
+        VertexAttribute::Layout layout(attribute, static_cast<GLint>(offset), static_cast<GLsizei>(sizeof(TVertex)));
+        offset += sizeof(T);
+        return layout;
+    }
+}
+
+// Create the layout of a vertex struct from its members, computing the offsets and the stride at compile time
+// The members must be listed in the order they are declared, and all of them, so the offsets match the struct. Both are checked
+// Example: constexpr auto layout = MakeVertexLayout(VertexMember(&Vertex::position, VertexAttribute::Semantic::Position), ...);
+template<typename TVertex, typename... T>
+consteval VertexLayout<TVertex, sizeof...(T)> MakeVertexLayout(const VertexMember<TVertex, T>&... members)
+{
+    static_assert(std::is_standard_layout_v<TVertex>, "Vertex struct must have standard layout to compute the offsets");
+    static_assert(VertexLayoutDetail::GetStructSize<T...>() == sizeof(TVertex), "Vertex members don't match the size of the vertex struct");
+
+    // Swapped members of the same size would pass the size check, but get each other's offset
+    if (!VertexLayoutDetail::AreMembersInDeclarationOrder(members...))
+    {
+        VertexLayoutDetail::VertexMembersNotInDeclarationOrder();
+    }
+
+    // Elements of a braced list are evaluated in order, so each member is placed after the previous one
+    std::size_t offset = 0;
+    return VertexLayout<TVertex, sizeof...(T)>({ VertexLayoutDetail::MakeAttributeLayout(members, offset)... });
+}
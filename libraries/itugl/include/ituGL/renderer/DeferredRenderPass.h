@@ -14,6 +14,10 @@ class DeferredRenderPass: public RenderPass
 public:
     DeferredRenderPass(std::shared_ptr<Material> material, std::shared_ptr<const FramebufferObject> targetFramebuffer = nullptr);
 
+    // Material used for the lights without a shadow map, usually a variant built without the shadow code
+    // If not set, the main material is used for all the lights
+    inline void SetNoShadowMaterial(std::shared_ptr<Material> material) { m_noShadowMaterial = material; }
+
     void Render() override;
 
 private:
@@ -21,4 +25,5 @@ private:
 
 private:
     std::shared_ptr<Material> m_material;
+    std::shared_ptr<Material> m_noShadowMaterial;
 };
@@ -1,15 +1,20 @@
 #pragma once
 
 #include <ituGL/renderer/RenderPass.h>
+#include <ituGL/renderer/RenderLayer.h>
+#include <ituGL/renderer/RenderCommandList.h>
 
 class ForwardRenderPass : public RenderPass
 {
 public:
-    ForwardRenderPass();
-    ForwardRenderPass(int drawcallCollectionIndex);
+    ForwardRenderPass(RenderLayerMask layerMask = RenderLayer::Opaque | RenderLayer::Transparent);
 
     void Render() override;
 
 private:
-    int m_drawcallCollectionIndex;
+    // Only drawcalls in these layers are rendered
+    RenderLayerMask m_layerMask;
+
+    // Commands recorded every frame, kept to reuse the memory
+    RenderCommandList m_commandList;
 };
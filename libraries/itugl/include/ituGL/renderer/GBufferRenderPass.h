@@ -1,13 +1,15 @@
 #pragma once
 
 #include <ituGL/renderer/RenderPass.h>
+#include <ituGL/renderer/RenderLayer.h>
+#include <ituGL/renderer/RenderCommandList.h>
 
 class Texture2DObject;
 
 class GBufferRenderPass : public RenderPass
 {
 public:
-    GBufferRenderPass(int width, int height, int drawcallCollectionIndex = 0);
+    GBufferRenderPass(int width, int height, RenderLayerMask layerMask = RenderLayer::Opaque);
 
     void Render() override;
 
@@ -21,7 +23,11 @@ private:
     void InitFramebuffer();
 
 private:
-    int m_drawcallCollectionIndex;
+    // Only drawcalls in these layers are rendered. They can't use blending
+    RenderLayerMask m_layerMask;
+
+    // Commands recorded every frame, kept to reuse the memory
+    RenderCommandList m_commandList;
 
     std::shared_ptr<Texture2DObject> m_depthTexture;
     std::shared_ptr<Texture2DObject> m_albedoTexture;
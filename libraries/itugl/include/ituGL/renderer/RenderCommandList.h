@@ -0,0 +1,87 @@
+#pragma once
+
+#include <ituGL/renderer/Renderer.h>
+#include <ituGL/geometry/Drawcall.h>
+#include <vector>
+#include <unordered_map>
+#include <span>
+
+class Material;
+class ShaderUniformCollection;
+class VertexArrayObject;
+
+// Compact list of draw commands recorded from the renderer drawcalls
+// Recording only reads the drawcalls, so it can be done in any thread. Once recorded, it can be submitted many times
+class RenderCommandList
+{
+public:
+    // Plain command, small enough to keep the submit loop cache friendly
+    struct Command
+    {
+        // Index of the material in the material table of the list
+        unsigned int materialIndex;
+
+        // Index of the VAO in the VAO table of the list
+        unsigned int vaoIndex;
+
+        // Index of the instance data (world matrix) in the renderer
+        unsigned int worldMatrixIndex;
+
+        // Copy of the drawcall parameters
+        Drawcall drawcall;
+    };
+
+public:
+    RenderCommandList();
+
+    // Remove all the commands and tables
+    void Clear();
+
+    // Add one command for each drawcall of the renderer in the layers of the mask
+    void Record(const Renderer& renderer, RenderLayerMask layerMask);
+
+    // Add a single command. The renderer is used to resolve the handle of the shader program
+    void Add(const Renderer& renderer, const Renderer::DrawcallInfo& drawcallInfo);
+
+    // Sort the commands by material and VAO, to reduce state changes on submit
+    // Instances of the same material are kept together, switching between them is cheap
+    void SortByState();
+
+    std::span<const Command> GetCommands() const { return m_commands; }
+    bool IsEmpty() const { return m_commands.empty(); }
+
+    // Draw once per command, using the material of each command
+    void Submit(Renderer& renderer) const;
+
+    // Draw once per command and light, using the material of each command
+    void SubmitLit(Renderer& renderer) const;
+
+    // Draw once per command, using the same material for all the commands (for example, shadow maps)
+    void Submit(Renderer& renderer, const Material& overrideMaterial) const;
+
+private:
+    // Entry of the material table, with the program resolved when recording
+    // It stores the material that is rendered, the placeholder if the material of the drawcall is not ready
+    struct MaterialEntry
+    {
+        const Material* material;
+        Renderer::ShaderProgramHandle shaderProgram;
+        // Index of the first material recorded with the same parent. Same as the material index if it has no parent
+        unsigned int batchIndex;
+    };
+
+    unsigned int GetMaterialIndex(const Renderer& renderer, const Material& drawcallMaterial);
+    unsigned int GetVaoIndex(const VertexArrayObject& vao);
+
+private:
+    std::vector<Command> m_commands;
+
+    // Tables of the objects referenced by the commands
+    std::vector<MaterialEntry> m_materials;
+    std::vector<const VertexArrayObject*> m_vaos;
+
+    // Reverse lookup of the tables, only used while recording
+    std::unordered_map<const Material*, unsigned int> m_materialIndices;
+    std::unordered_map<const ShaderUniformCollection*, unsigned int> m_batchIndices;
+    std::unordered_map<const VertexArrayObject*, unsigned int> m_vaoIndices;
+};
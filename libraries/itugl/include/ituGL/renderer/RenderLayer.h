@@ -0,0 +1,25 @@
+#pragma once
+
+// Bit mask with the render layers a drawcall belongs to, or the layers that a render pass draws
+using RenderLayerMask = unsigned int;
+
+// Render layers. A drawcall can belong to several layers, for example opaque and shadow caster
+namespace RenderLayer
+{
+    enum Flags : RenderLayerMask
+    {
+        None = 0,
+        Opaque = 1 << 0,
+        Transparent = 1 << 1,
+        ShadowCaster = 1 << 2,
+        Skybox = 1 << 3,
+
+        // Free layers for application specific passes
+        Custom0 = 1 << 8,
+        Custom1 = 1 << 9,
+        Custom2 = 1 << 10,
+        Custom3 = 1 << 11,
+
+        All = ~0u
+    };
+}
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <ituGL/core/DeviceGL.h>
+#include <ituGL/core/HandleRegistry.h>
 #include <ituGL/renderer/RenderPass.h>
+#include <ituGL/renderer/RenderLayer.h>
+#include <ituGL/renderer/ShaderBindingTable.h>
 #include <ituGL/geometry/Drawcall.h>
 #include <ituGL/geometry/Mesh.h>
 #include <glm/mat4x4.hpp>
@@ -25,22 +28,42 @@ class Renderer
 public:
     struct DrawcallInfo
     {
-        DrawcallInfo(const Material& material, unsigned int worldMatrixIndex, const VertexArrayObject& vao, const Drawcall& drawcall)
-            : material(material), worldMatrixIndex(worldMatrixIndex), vao(vao), drawcall(drawcall)
+        DrawcallInfo(const Material& material, unsigned int worldMatrixIndex, const VertexArrayObject& vao, const Drawcall& drawcall, RenderLayerMask layerMask)
+            : material(material), worldMatrixIndex(worldMatrixIndex), vao(vao), drawcall(drawcall), layerMask(layerMask)
         {
         }
 
+        // If the drawcall belongs to any of the layers in the mask
+        bool IsInLayers(RenderLayerMask mask) const { return (layerMask & mask) != 0; }
+
         const Material& material;
         unsigned int worldMatrixIndex;
         const VertexArrayObject& vao;
         const Drawcall& drawcall;
+        RenderLayerMask layerMask;
     };
 
-    using DrawcallCollection = std::vector<DrawcallInfo>;
-
     using UpdateTransformsFunction = std::function<void(const ShaderProgram&, const glm::mat4&, const Camera&, bool)>;
     using UpdateLightsFunction = std::function<bool(const ShaderProgram&, std::span<const Light* const>, unsigned int&)>;
 
+    // Registered shader program, with the binding table or the functions to update its transforms and lights
+    // If a function is registered, it is used instead of the binding table
+    struct ShaderProgramInfo
+    {
+        std::shared_ptr<const ShaderProgram> shaderProgram;
+        ShaderBindingTable bindingTable;
+        UpdateTransformsFunction updateTransformsFunction;
+        UpdateLightsFunction updateLightsFunction;
+
+        bool HasTransforms() const { return updateTransformsFunction || bindingTable.HasTransforms(); }
+        bool HasLights() const { return updateLightsFunction || bindingTable.HasLights(); }
+
+        void UpdateTransforms(const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged) const;
+        bool UpdateLights(std::span<const Light* const> lights, unsigned int& lightIndex) const;
+    };
+
+    using ShaderProgramHandle = HandleRegistry<ShaderProgramInfo>::Handle;
+
 public:
     Renderer(DeviceGL& device);
 
@@ -60,20 +83,45 @@ public:
     std::span<const Light* const> GetLights() const;
     void AddLight(const Light& light);
 
-    std::span<const DrawcallInfo> GetDrawcalls(unsigned int collectionIndex) const;
+    // All the drawcalls added this frame. Passes skip the ones that are not in their layers
+    std::span<const DrawcallInfo> GetDrawcalls() const;
     void AddModel(const Model& model, const glm::mat4& worldMatrix);
 
+    // Add world matrices and drawcalls collected outside of the renderer, for example in worker threads
+    // The world matrix indices of the drawcalls are relative to the worldMatrices span
+    void AddDrawcalls(std::span<const glm::mat4> worldMatrices, std::span<const DrawcallInfo> drawcalls);
+
+    // Append the drawcalls of the model that belong to any layer. Doesn't access the renderer, so it can run in any thread
+    static void AppendModelDrawcalls(const Model& model, unsigned int worldMatrixIndex, std::vector<DrawcallInfo>& drawcalls);
+
+    const glm::mat4& GetWorldMatrix(unsigned int worldMatrixIndex) const;
+
     const Mesh& GetFullscreenMesh() const;
 
-    void RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr,
+    // Register the shader program, or update the functions if it was already registered (null functions are ignored)
+    // The renderer keeps a reference to the program until it is unregistered
+    ShaderProgramHandle RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr,
         const UpdateTransformsFunction& updateTransformFunction,
         const UpdateLightsFunction& updateLightsFunction);
 
-    void UpdateTransforms(std::shared_ptr<const ShaderProgram> shaderProgramPtr, const glm::mat4& worldMatrix, bool cameraChanged = true) const;
-    void UpdateTransforms(std::shared_ptr<const ShaderProgram> shaderProgramPtr, unsigned int worldMatrixIndex, bool cameraChanged = true) const;
+    // Register the shader program with a binding table, resolved once. Replaces any previous binding table
+    ShaderProgramHandle RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr,
+        const ShaderBindingTable& bindingTable);
+
+    void UnregisterShaderProgram(ShaderProgramHandle handle);
+
+    // Handle of a registered shader program, or an invalid handle if it is not registered
+    ShaderProgramHandle GetShaderProgramHandle(const ShaderProgram& shaderProgram) const;
+
+    // Info of a registered shader program, or nullptr if the handle is not valid anymore
+    const ShaderProgramInfo* GetShaderProgramInfo(ShaderProgramHandle handle) const;
+
+    // Only by handle: resolve it with GetShaderProgramHandle when the material changes, not for every call
+    void UpdateTransforms(ShaderProgramHandle handle, const glm::mat4& worldMatrix, bool cameraChanged = true) const;
+    void UpdateTransforms(ShaderProgramHandle handle, unsigned int worldMatrixIndex, bool cameraChanged = true) const;
 
     UpdateLightsFunction GetDefaultUpdateLightsFunction(const ShaderProgram& shaderProgram);
-    bool UpdateLights(std::shared_ptr<const ShaderProgram> shaderProgramPtr, std::span<const Light* const> lights, unsigned int& lightIndex) const;
+    bool UpdateLights(ShaderProgramHandle handle, std::span<const Light* const> lights, unsigned int& lightIndex) const;
 
     void PrepareDrawcall(const DrawcallInfo& drawcallInfo);
 
@@ -86,6 +134,9 @@ private:
 
     void InitializeFullscreenMesh();
 
+    // Add the shader program to the registry, if it is not there yet
+    ShaderProgramHandle RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr);
+
 private:
     DeviceGL& m_device;
 
@@ -100,10 +151,15 @@ private:
 
     std::vector<glm::mat4> m_worldMatrices;
 
-    std::vector<DrawcallCollection> m_drawcallCollections;
+    std::vector<DrawcallInfo> m_drawcalls;
+
+    // Registered shader programs, stored contiguously and accessed by handle
+    // Only programs use handles: textures are bound through a plain pointer from the material, without refcount changes,
+    // and a handle would only add a lookup there until something else than the materials owns them
+    HandleRegistry<ShaderProgramInfo> m_shaderPrograms;
 
-    std::unordered_map<std::shared_ptr<const ShaderProgram>, UpdateTransformsFunction> m_updateTransformsFunctions;
-    std::unordered_map<std::shared_ptr<const ShaderProgram>, UpdateLightsFunction> m_updateLightsFunctions;
+    // Handle of each registered program. Only used to resolve handles, not on every drawcall
+    std::unordered_map<const ShaderProgram*, ShaderProgramHandle> m_shaderProgramHandles;
 
     Mesh m_fullscreenMesh;
 
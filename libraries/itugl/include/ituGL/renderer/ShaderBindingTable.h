@@ -0,0 +1,107 @@
+#pragma once
+
+#include <ituGL/shader/ShaderProgram.h>
+#include <ituGL/shader/ShaderUniformCollection.h>
+#include <glm/mat4x4.hpp>
+#include <array>
+#include <span>
+
+class Camera;
+class Light;
+
+// Table that maps the uniforms that the renderer knows how to set (transforms, lights) to locations in a shader program
+// The locations are resolved once, and the values are only uploaded when they change
+class ShaderBindingTable
+{
+public:
+    // Well-known values that the renderer can provide
+    enum class Semantic
+    {
+        // Transforms
+        WorldMatrix,
+        ViewMatrix,
+        ProjMatrix,
+        ViewProjMatrix,
+        WorldViewMatrix,
+        WorldViewProjMatrix,
+        InvViewMatrix,
+        InvProjMatrix,
+        InvViewProjMatrix,
+        CameraPosition,
+
+        // Lights
+        LightIndirect,
+        LightColor,
+        LightPosition,
+        LightDirection,
+        LightAttenuation,
+        LightShadowEnabled,
+        LightShadowMap,
+        LightShadowMatrix,
+        LightShadowBias,
+
+        Count
+    };
+
+    // Texture unit used by the shadow map
+    static const GLint ShadowMapTextureUnit = 8;
+
+public:
+    // Empty table, nothing is bound
+    ShaderBindingTable();
+
+    // Bind all the semantics with uniforms that use the default names ("WorldMatrix", "LightColor"...) in the shader program
+    ShaderBindingTable(const ShaderProgram& shaderProgram);
+
+    // Name of the uniform that is bound to the semantic by default
+    static const char* GetDefaultName(Semantic semantic);
+
+    // Bind the semantic to a location. Use -1 to unbind it
+    ShaderProgram::Location GetLocation(Semantic semantic) const;
+    void SetLocation(Semantic semantic, ShaderProgram::Location location);
+
+    // Bind the semantic to the uniform with this name, if it exists in the shader program
+    void SetLocation(Semantic semantic, const ShaderProgram& shaderProgram, const char* uniformName);
+
+    // Check if any of the transform or light semantics is bound
+    inline bool HasTransforms() const { return m_hasTransforms; }
+    inline bool HasLights() const { return m_hasLights; }
+
+    // Add the names of the bound uniforms, so they can be filtered out of the materials
+    void AddDefaultNames(ShaderUniformCollection::NameSet& names) const;
+
+    // Set the transform uniforms. Camera values are only computed if cameraChanged is true
+    void UpdateTransforms(const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged) const;
+
+    // Set the light uniforms for the light in lightIndex and advance to the next one. Same behavior as Renderer::UpdateLightsFunction
+    bool UpdateLights(const ShaderProgram& shaderProgram, std::span<const Light* const> lights, unsigned int& lightIndex) const;
+
+    // Forget the uploaded values, so the next update sets all of them. Needed if the uniforms are modified elsewhere
+    void Invalidate() const;
+
+private:
+    inline bool IsBound(Semantic semantic) const { return m_locations[static_cast<int>(semantic)] >= 0; }
+
+    // Upload the value only if it is different from the last one uploaded
+    template<typename T>
+    void Upload(const ShaderProgram& shaderProgram, Semantic semantic, const T& value) const;
+
+private:
+    static const int SemanticCount = static_cast<int>(Semantic::Count);
+
+    // Location of each semantic, -1 if not bound
+    std::array<ShaderProgram::Location, SemanticCount> m_locations;
+
+    // Last value uploaded for each semantic, big enough for a mat4
+    using CachedValue = std::array<float, 16>;
+    mutable std::array<CachedValue, SemanticCount> m_cachedValues;
+
+    // Bit set for each semantic with a value in the cache
+    mutable unsigned int m_cachedMask;
+
+    // If any transform or light semantic is bound, updated when a location changes
+    bool m_hasTransforms;
+    bool m_hasLights;
+
+    static_assert(SemanticCount <= 32, "Cached mask can't hold all the semantics");
+};
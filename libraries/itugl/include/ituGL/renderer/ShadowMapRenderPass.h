@@ -1,6 +1,8 @@
 #pragma once
 
 #include <ituGL/renderer/RenderPass.h>
+#include <ituGL/renderer/RenderLayer.h>
+#include <ituGL/renderer/RenderCommandList.h>
 
 #include <glm/vec3.hpp>
 
@@ -11,7 +13,7 @@ class Material;
 class ShadowMapRenderPass : public RenderPass
 {
 public:
-    ShadowMapRenderPass(std::shared_ptr<Light> light, std::shared_ptr<const Material> material, int drawcallCollectionIndex = 0);
+    ShadowMapRenderPass(std::shared_ptr<Light> light, std::shared_ptr<const Material> material, RenderLayerMask layerMask = RenderLayer::ShadowCaster);
 
     void SetVolume(glm::vec3 volumeCenter, glm::vec3 volumeSize);
 
@@ -26,7 +28,11 @@ private:
 
     std::shared_ptr<const Material> m_material;
 
-    int m_drawcallCollectionIndex;
+    // Only drawcalls in these layers are rendered
+    RenderLayerMask m_layerMask;
+
+    // Commands recorded every frame, kept to reuse the memory
+    RenderCommandList m_commandList;
 
     glm::vec3 m_volumeCenter;
     glm::vec3 m_volumeSize;
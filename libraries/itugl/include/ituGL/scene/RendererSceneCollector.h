@@ -0,0 +1,64 @@
+#pragma once
+
+#include <ituGL/renderer/Renderer.h>
+#include <glm/mat4x4.hpp>
+#include <vector>
+#include <functional>
+
+class Scene;
+class SceneModel;
+class JobSystem;
+
+// Parallel version of RendererSceneVisitor
+// Cameras and lights are added in the calling thread, and the dirty world matrices of the models are refreshed there too,
+// so their cache is never written from several threads. Then the models are split in chunks, and the workers cull them
+// and emit the drawcalls into one bucket per chunk.
+// Buckets are merged in chunk order, so the result is the same as the serial visitor, regardless of the number of threads
+class RendererSceneCollector
+{
+public:
+    // Return false to skip the model. Called from worker threads
+    using CullFunction = std::function<bool(const SceneModel&, const glm::mat4& worldMatrix)>;
+
+public:
+    RendererSceneCollector(Renderer& renderer, JobSystem& jobSystem);
+
+    // Optional culling, none by default
+    void SetCullFunction(const CullFunction& cullFunction);
+
+    // Number of models in each chunk of work
+    unsigned int GetChunkSize() const { return m_chunkSize; }
+    void SetChunkSize(unsigned int chunkSize);
+
+    // Add the scene cameras, lights and models to the renderer
+    // The scene can't be modified while collecting
+    void Collect(Scene& scene);
+
+private:
+    // Results of one chunk
+    struct Bucket
+    {
+        std::vector<glm::mat4> worldMatrices;
+        std::vector<Renderer::DrawcallInfo> drawcalls;
+    };
+
+    void CollectChunk(unsigned int chunkIndex);
+
+private:
+    Renderer& m_renderer;
+
+    JobSystem& m_jobSystem;
+
+    CullFunction m_cullFunction;
+
+    unsigned int m_chunkSize;
+
+    // Models found in the scene, in visiting order
+    std::vector<SceneModel*> m_models;
+
+    // World matrix of each model, refreshed before the parallel phase
+    std::vector<glm::mat4> m_worldMatrices;
+
+    // One bucket per chunk, kept between frames to reuse the memory
+    std::vector<Bucket> m_buckets;
+};
@@ -25,10 +25,16 @@ public:
     glm::mat4 GetRotationMatrix() const;
     glm::mat4 GetScaleMatrix() const;
 
+    // Updates the cached matrix, and the ones of the parents, if they are dirty
+    // Not thread-safe when dirty: refresh the caches in one thread before reading them from others
     glm::mat4 GetTransformMatrix() const;
 
     bool IsDirty() const;
 
+    // Blend two transform matrices: translation and scale are interpolated linearly, rotation spherically
+    // Used to render between two fixed ticks of the simulation
+    static glm::mat4 Interpolate(const glm::mat4& from, const glm::mat4& to, float t);
+
 private:
     glm::vec3 m_translation;
     glm::vec3 m_rotation;
@@ -39,4 +45,11 @@ private:
     // Cached matrix
     mutable glm::mat4 m_matrix;
     mutable bool m_dirty;
+
+    // Incremented every time the cached matrix changes
+    mutable unsigned int m_version;
+
+    // Version of the parent matrix used for the cached matrix. If the parent changed since, the cache is dirty
+    // Otherwise, once a sibling refreshed the parent, the other children would keep a stale matrix
+    mutable unsigned int m_parentVersion;
 };
@@ -2,10 +2,13 @@
 
 #include <ituGL/shader/ShaderUniformCollection.h>
 
+#include <ituGL/renderer/RenderLayer.h>
 #include <ituGL/core/Color.h>
 #include <functional>
 #include <array>
 
+class ProgramPipeline;
+
 // Class to group all the properties that may affect the look of a rendered geometry
 class Material : public ShaderUniformCollection
 {
@@ -39,15 +42,50 @@ public:
     // Function pointer to prepare the shader used by the material that is being rendered
     using ShaderSetupFunction = std::function<void(ShaderProgram&)>;
 
+    // Function that returns the shader program once it is ready, or nullptr while it is not
+    using ShaderProgramProvider = std::function<std::shared_ptr<ShaderProgram>()>;
+
+    // Function to set up the properties of the material, once its shader program is ready
+    using MaterialSetupFunction = std::function<void(Material&)>;
+
 public:
     Material();
     // Initialize with the shader program, will extract all the properties. Skip the names in filtered uniforms
     Material(std::shared_ptr<ShaderProgram> shaderProgram, const NameSet& filteredUniforms = NameSet());
 
+    // Initialize without shader program. The provider is checked in UpdateShaderProgram,
+    // and the placeholder material is rendered instead until it returns the program
+    // Then the properties are extracted, and the setup function is called to set their values
+    // Instances can only be created once the shader program is ready
+    Material(ShaderProgramProvider shaderProgramProvider, std::shared_ptr<const Material> placeholderMaterial,
+        const NameSet& filteredUniforms = NameSet(), MaterialSetupFunction materialSetupFunction = nullptr);
+
+protected:
+    // Initialize as an instance of the parent material, used by MaterialInstance. The render states are copied from the parent
+    Material(std::shared_ptr<const Material> parent);
+
+public:
 
     // The function that will be executed for additional shader program setup
     void SetShaderSetupFunction(ShaderSetupFunction shaderSetupFunction);
 
+    // Pipeline bound instead of the shader program, when the program is a separable stage of it
+    // The uniforms are still the ones of the shader program. The other stages are set up by their owners
+    std::shared_ptr<const ProgramPipeline> GetProgramPipeline() const;
+    void SetProgramPipeline(std::shared_ptr<const ProgramPipeline> programPipeline);
+
+    // If the shader program is available. Only false for materials with a provider that didn't return it yet
+    bool IsShaderProgramReady() const;
+
+    // Check the provider. Once it returns the shader program, extract the properties and call the setup function
+    // Call it before rendering, for example once per frame. Render passes call it for their own materials
+    // Returns true if the shader program is ready
+    bool UpdateShaderProgram();
+
+    // Material to render: this one, or the placeholder while the shader program is not ready
+    // It doesn't check the provider, so the same material is rendered until the next UpdateShaderProgram
+    const Material& GetRenderMaterial() const;
+
 
     // The test function for the depth test, if depth test is enabled
     TestFunction GetDepthTestFunction() const;
@@ -109,11 +147,19 @@ public:
     CullMode GetCullMode() const;
     void SetCullMode(CullMode cullmode);
 
+    // Render layers this material belongs to. Default: Opaque | ShadowCaster
+    // Materials with blending should use Transparent instead of Opaque
+    RenderLayerMask GetLayerMask() const;
+    void SetLayerMask(RenderLayerMask layerMask);
+
     // Use the shader program, set all uniforms, set depth properties, stencil properties, and blending
     // You can skip depth, stencil or blending using the override flags
     void Use(OverrideFlags overrideFlags = OverrideFlags::NoOverride) const;
 
 private:
+    // Extract the properties of the shader program returned by the provider, and release the provider
+    void InitializeShaderProgram(std::shared_ptr<ShaderProgram> shaderProgram);
+
     // Set all the properties relative to depth
     void UseDepthTest() const;
 
@@ -130,6 +176,19 @@ private:
     // Function pointer to prepare the shader used by the material
     ShaderSetupFunction m_shaderSetupFunction;
 
+    // Provider of the shader program, while it is not ready. Default: nullptr
+    ShaderProgramProvider m_shaderProgramProvider;
+
+    // Material rendered while the shader program is not ready
+    std::shared_ptr<const Material> m_placeholderMaterial;
+
+    // Uniforms to skip and function to set up the properties, when the shader program is ready
+    NameSet m_filteredUniforms;
+    MaterialSetupFunction m_materialSetupFunction;
+
+    // Pipeline to bind, if the shader program is a separable stage. Default: nullptr
+    std::shared_ptr<const ProgramPipeline> m_programPipeline;
+
     // Test function for depth. Default: Less
     TestFunction m_depthTestFunction;
 
@@ -166,6 +225,9 @@ private:
 
     // Blend color to use with ConstantColor or ConstantAlpha parameters. Default: white
     Color m_blendColor;
+
+    // Render layers, used by the render passes to select the drawcalls. Default: Opaque | ShadowCaster
+    RenderLayerMask m_layerMask;
 };
 
 // Different conditions for depth and stencil tests
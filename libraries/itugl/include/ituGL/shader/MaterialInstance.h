@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ituGL/shader/Material.h>
+
+// Material that shares the uniform values of a parent material, and only stores the ones it overrides
+// Values are copied from the parent the first time they are set, the rest follow the parent if it changes
+// Render states (depth, stencil, blending, culling, layers) are copied from the parent when the instance is created
+// Instances of the same parent are sorted together, and switching between them only uploads their overrides
+class MaterialInstance : public Material
+{
+public:
+    // The parent can't be an instance itself
+    MaterialInstance(std::shared_ptr<const Material> parent);
+
+    // Get the parent material
+    const Material& GetParentMaterial() const;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <ituGL/core/Object.h>
+
+#include <array>
+#include <memory>
+#include <span>
+
+class ShaderProgram;
+
+// Program Pipeline is an OpenGL Object that combines the stages of several separable shader programs
+// A separable program can be linked with a single stage, and then shared by many pipelines without linking it again
+// For example, a fullscreen vertex program used with the fragment programs of all the post-processing passes
+class ProgramPipeline : public Object
+{
+public:
+    // Stages that a program can provide to the pipeline. They can be combined as a mask
+    enum Stage : GLbitfield
+    {
+        VertexStage = GL_VERTEX_SHADER_BIT,
+        TesselationControlStage = GL_TESS_CONTROL_SHADER_BIT,
+        TesselationEvaluationStage = GL_TESS_EVALUATION_SHADER_BIT,
+        GeometryStage = GL_GEOMETRY_SHADER_BIT,
+        FragmentStage = GL_FRAGMENT_SHADER_BIT,
+        ComputeStage = GL_COMPUTE_SHADER_BIT
+    };
+
+public:
+    ProgramPipeline();
+    virtual ~ProgramPipeline();
+
+    // (C++) 8
+    // Move semantics
+    ProgramPipeline(ProgramPipeline&& programPipeline) noexcept;
+    ProgramPipeline& operator = (ProgramPipeline&& programPipeline) noexcept;
+
+    // Set the pipeline as the active one to be used for rendering
+    // Programs in use take priority over pipelines, so no program is in use after this call
+    void Bind() const override;
+
+    // Unbind the pipeline
+    static void Unbind();
+
+    // Use the stages of a separable program. Pass nullptr to remove the stages
+    // The pipeline keeps a reference to the program while it is used
+    void SetStages(GLbitfield stageMask, std::shared_ptr<const ShaderProgram> shaderProgram);
+
+    // Get the program that provides one stage, nullptr if none
+    std::shared_ptr<const ShaderProgram> GetStageProgram(Stage stage) const;
+
+    // Check if the stages can be used together: interfaces between the stages must match
+    bool Validate() const;
+
+    // Get a string with validation error messages
+    // The max length of the string returned is determined by the capacity of the span
+    void GetValidationErrors(std::span<char> errors) const;
+
+private:
+    // Index of the stage in the array of programs
+    static unsigned int GetStageIndex(Stage stage);
+
+private:
+    static const unsigned int StageCount = 6;
+
+    // Programs used by each stage
+    std::array<std::shared_ptr<const ShaderProgram>, StageCount> m_stagePrograms;
+};
@@ -47,7 +47,15 @@ public:
     // Compile the shader source code
     bool Compile();
 
-    // Check if the shader has been successfully compiled
+    // Start compiling the shader source code, without waiting for the result
+    // The driver can compile it in the background while other shaders are submitted
+    void StartCompile();
+
+    // Check if the compilation finished, so IsCompiled doesn't have to wait for it
+    // Always true if the driver doesn't support parallel shader compile
+    bool IsCompileCompleted() const;
+
+    // Check if the shader has been successfully compiled. Waits for the compilation to finish
     bool IsCompiled() const;
 
     // Get compilation error messages in case of a failure
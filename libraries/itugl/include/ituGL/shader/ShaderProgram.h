@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ituGL/core/Object.h>
+#include <ituGL/shader/UniformName.h>
 
 // Include the glm types for vectors and matrices
 #include <glm/vec2.hpp>
@@ -17,6 +18,10 @@
 #include <glm/mat4x4.hpp>
 
 #include <span>
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <cstddef>
 
 class Shader;
 class TextureObject;
@@ -29,6 +34,18 @@ public:
     // Declare the type used for uniform locations
     using Location = GLint;
 
+    // Record of the uniform values applied to this program by a ShaderUniformCollection
+    // Versions are unique across collections, so a collection can tell if the program still holds its values
+    struct AppliedUniforms
+    {
+        // Version of the collection last applied. 0 if unknown
+        unsigned long long version = 0;
+        // Version of the instance whose overrides were applied on top, 0 if none
+        unsigned long long overrideVersion = 0;
+        // Locations written by the overrides, that no longer hold the values of the collection
+        std::vector<Location> overrideLocations;
+    };
+
 public:
     ShaderProgram();
     virtual ~ShaderProgram();
@@ -71,9 +88,35 @@ public:
         return Build(vertexShader, fragmentShader, tesselationControlShader, &tesselationEvaluationShader, &geometryShader);
     }
 
-    // Check if shaders have been linked to create a valid program
+    // Build (Attach and link) a separable shader program with a single shader of any type
+    // Separable programs are combined with others in a ProgramPipeline
+    bool BuildSeparable(const Shader& shader);
+
+    // Mark the program as separable, so it can be used in a ProgramPipeline. Must be set before linking
+    void SetSeparable(bool separable);
+    bool IsSeparable() const;
+
+    // Attach and start linking the shaders, without waiting for them to compile or for the link to finish
+    // Useful to submit several programs at once, and check them later with IsLinkCompleted / IsLinked
+    void StartBuild(std::span<const Shader> shaders);
+
+    // Check if the link finished, so IsLinked doesn't have to wait for it
+    // Always true if the driver doesn't support parallel shader compile
+    bool IsLinkCompleted() const;
+
+    // Check if shaders have been linked to create a valid program. Waits for the link to finish
     bool IsLinked() const;
 
+    // Ask the driver to keep the linked binary, so it can be retrieved with GetBinary. Must be set before linking
+    void SetBinaryRetrievable(bool retrievable);
+
+    // Get the binary of the linked program, in a driver specific format. Returns false if not available
+    bool GetBinary(GLenum& binaryFormat, std::vector<std::byte>& binary) const;
+
+    // Load a binary returned by GetBinary, instead of building the program
+    // Returns false if the driver rejects it (different driver or GPU), then the program must be built from source
+    bool LoadBinary(GLenum binaryFormat, std::span<const std::byte> binary);
+
     // Get a string with linking error messages
     // The max length of the string returned is determined by the capacity of the span
     void GetLinkingErrors(std::span<char> errors) const;
@@ -81,8 +124,9 @@ public:
     // Find an attribute location by name
     Location GetAttributeLocation(const char* name) const;
 
-    // Find a uniform location by name
-    Location GetUniformLocation(const char *name) const;
+    // Find a uniform location by name. Locations are looked up in a table by the hash of the name
+    // The table is filled with the active uniforms the first time, other names are asked to the driver once
+    Location GetUniformLocation(UniformName name) const;
 
     // Get how many uniforms exist in this shader program
     unsigned int GetUniformCount() const;
@@ -90,6 +134,21 @@ public:
     // Get information about a specific uniform
     void GetUniformInfo(unsigned int index, int& size, GLenum& glType, std::span<char> uniformName) const;
 
+    // Get a parameter (GL_UNIFORM_BLOCK_INDEX, GL_UNIFORM_OFFSET...) of several uniforms, by uniform index
+    void GetUniformsParameter(std::span<const GLuint> indices, GLenum pname, std::span<GLint> params) const;
+
+    // Find a uniform block index by name. Returns GL_INVALID_INDEX if not found
+    GLuint GetUniformBlockIndex(const char* name) const;
+
+    // Get the size in bytes of the data of a uniform block
+    GLint GetUniformBlockSize(GLuint blockIndex) const;
+
+    // Get the indices of the uniforms that belong to a uniform block
+    void GetUniformBlockUniforms(GLuint blockIndex, std::vector<GLuint>& indices) const;
+
+    // Assign the uniform buffer binding point that a uniform block reads from. Linking resets it
+    void SetUniformBlockBinding(GLuint blockIndex, GLuint bindingIndex) const;
+
     // Template method combinations to simplify getting uniforms
     template<typename T>
     void GetUniform(Location location, T& value) const;
@@ -116,6 +175,13 @@ public:
     // Set the shader program as the active one to be used for rendering
     void Use() const;
 
+    // Uniform values last applied to this program. Only used and updated by ShaderUniformCollection
+    inline AppliedUniforms& GetAppliedUniforms() const { return m_appliedUniforms; }
+
+    // Forget the applied uniforms, so the next collection uploads all its values
+    // Call it after setting directly a uniform that belongs to a ShaderUniformCollection
+    inline void InvalidateAppliedUniforms() const { m_appliedUniforms = AppliedUniforms(); }
+
 private:
     // Build (Attach and link) all shaders provided for the rasterization pipeline
     bool Build(const Shader& vertexShader, const Shader& fragmentShader,
@@ -128,6 +194,12 @@ private:
     // Link currently attached shaders
     bool Link();
 
+    // Forget the uniform values and locations after the program is linked or loaded
+    void OnLinked();
+
+    // Add the locations of the active uniforms to the table
+    void FillUniformLocations() const;
+
     // Helper template method for getting uniforms
     template<typename T>
     void GetUniform(Location location, std::span<T> value) const;
@@ -138,7 +210,31 @@ private:
     template<typename T, int C, int R>
     void SetUniforms(Location location, const T* values, GLsizei count) const;
 
+    // Forget which texture unit was assigned to each sampler uniform, so SetTexture sets them again
+    void InvalidateTextureUnits() const;
+
 private:
+    // Texture unit last assigned to each sampler uniform, by location. -1 if unknown
+    // Sampler uniforms almost never change, SetTexture skips setting them again
+    mutable std::vector<GLint> m_textureUnits;
+
+    // Uniform values last applied by a ShaderUniformCollection
+    mutable AppliedUniforms m_appliedUniforms;
+
+    // Location of a uniform in the table
+    struct UniformLocationEntry
+    {
+        Location location;
+#ifndef NDEBUG
+        // To detect different names with the same hash
+        std::string name;
+#endif
+    };
+
+    // Uniform locations by name hash. Filled on the first lookup, the link may still be running before that
+    mutable std::unordered_map<UniformName::Hash, UniformLocationEntry> m_uniformLocations;
+    mutable bool m_uniformLocationsFilled;
+
 #ifndef NDEBUG
     inline bool IsUsed() const { return s_usedHandle == GetHandle(); }
     static Handle s_usedHandle;
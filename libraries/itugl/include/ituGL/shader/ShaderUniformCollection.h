@@ -2,12 +2,15 @@
 
 #include <ituGL/shader/ShaderProgram.h>
 #include <ituGL/texture/TextureObject.h>
+#include <ituGL/texture/SamplerObject.h>
+#include <ituGL/shader/UniformBufferArena.h>
 #include <ituGL/core/Data.h>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
 #include <memory>
+#include <cstring>
 
 class ShaderUniformCollection
 {
@@ -31,45 +34,66 @@ public:
     ShaderProgram::Location GetAttributeLocation(const char* name) const;
 
     // Get the shader uniform location by name
-    ShaderProgram::Location GetUniformLocation(const char* name) const;
+    // Uniforms in the uniform block don't have a location in the program, they get one from the collection
+    ShaderProgram::Location GetUniformLocation(UniformName name) const;
+
+    // Store the data uniforms of a uniform block in a range of the arena, instead of setting them one by one
+    // The block is bound to bindingIndex, so using the collection only binds its range. Returns false if the block is not found
+    // or is larger than the arena. Only one block per collection, and the program must not be linked again
+    bool SetUniformBlock(const char* blockName, GLuint bindingIndex, std::shared_ptr<UniformBufferArena> arena);
 
     // Get uniform value for different types, using the name or the uniform location
     template<typename T>
-    T GetUniformValue(const char* name) const;
+    T GetUniformValue(UniformName name) const;
     template<typename T>
     T GetUniformValue(ShaderProgram::Location location) const;
     template<typename T>
-    void GetUniformValue(const char* name, T& value) const;
+    void GetUniformValue(UniformName name, T& value) const;
     template<typename T>
     void GetUniformValue(ShaderProgram::Location location, T& value) const;
     template<typename T>
     void GetUniformValue(ShaderProgram::Location location, std::shared_ptr<T>& value) const;
     template<typename T>
-    void GetUniformValues(const char* name, std::span<T> value) const;
+    void GetUniformValues(UniformName name, std::span<T> value) const;
     template<typename T>
     void GetUniformValues(ShaderProgram::Location location, std::span<T> value) const;
 
     // Set uniform value for different types, using the name or the uniform location
     template<typename T>
-    void SetUniformValue(const char* name, const T& value);
+    void SetUniformValue(UniformName name, const T& value);
     template<typename T>
     void SetUniformValue(ShaderProgram::Location location, const T& value);
     template<typename T>
     void SetUniformValue(ShaderProgram::Location location, const std::shared_ptr<T>& value);
     template<typename T>
-    void SetUniformValues(const char* name, std::span<const T> value);
+    void SetUniformValues(UniformName name, std::span<const T> value);
     template<typename T>
     void SetUniformValues(ShaderProgram::Location location, std::span<const T> value);
 
+    // Get / set the sampler used with a texture uniform. If null, the sampling parameters of the texture are used
+    std::shared_ptr<const SamplerObject> GetTextureSampler(UniformName name) const;
+    std::shared_ptr<const SamplerObject> GetTextureSampler(ShaderProgram::Location location) const;
+    void SetTextureSampler(UniformName name, std::shared_ptr<const SamplerObject> sampler);
+    void SetTextureSampler(ShaderProgram::Location location, std::shared_ptr<const SamplerObject> sampler);
+
     // Get the pointer to the uniform data
     template<typename T>
-    T* GetDataUniformPointer(const char* name);
+    T* GetDataUniformPointer(UniformName name);
     template<typename T>
     T* GetDataUniformPointer(ShaderProgram::Location location);
 
-    // Set all the properties to the shader. Requires the shader program to be in use
+    // Set all the properties to the shader
+    // Data uniforms are only uploaded if they changed since this collection was last applied to the program
     void SetUniforms() const;
 
+    // Collection this one overrides, or null if it stores all its values
+    inline const ShaderUniformCollection* GetParent() const { return m_parent.get(); }
+
+protected:
+    // Initialize as an instance of the parent. It only stores the values that are overridden, the rest are read from the parent
+    // Values are copied from the parent the first time they are set. The parent can't be an instance itself
+    ShaderUniformCollection(std::shared_ptr<const ShaderUniformCollection> parent);
+
 private:
     // Different dimensions of the properties
     enum class UniformDimension
@@ -96,6 +120,13 @@ private:
         unsigned int count;
         // Index in the data buffer
         int index;
+        // If the value changed since it was last uploaded
+        mutable bool dirty;
+        // Offset in the uniform block, or -1 if it is not in the block
+        int blockOffset;
+        // Distance between the elements of an array and between the columns of a matrix, in the block
+        int arrayStride;
+        int matrixStride;
     };
 
     // Struct to store a texture property
@@ -105,19 +136,48 @@ private:
         ShaderProgram::Location location;
         // Texture subtype
         TextureObject::Target target;
-        // Shared pointer to the texture object
+        // Shared pointer to the texture object. It keeps the texture alive; binding only dereferences it, without copies
         std::shared_ptr<const TextureObject> texture;
+        // Shared pointer to the sampler object, usually from a SamplerCache. Optional
+        std::shared_ptr<const SamplerObject> sampler;
+        // Texture unit assigned to the uniform
+        GLint unit;
+    };
+
+    // Struct to store the uniform block
+    struct UniformBlock
+    {
+        // Uniform buffer binding point the block reads from
+        GLuint bindingIndex = 0;
+        // Range of the arena where the values of the block are stored
+        UniformBufferAllocation allocation;
+        // Values packed with the layout of the block, ready to upload
+        std::vector<std::byte> data;
     };
 
 private:
-    // Get a data uniform
+    // Get a data uniform. In an instance, the const version returns the one of the parent if not overridden,
+    // and the non const version overrides it
     DataUniform& GetDataUniform(ShaderProgram::Location location);
     const DataUniform& GetDataUniform(ShaderProgram::Location location) const;
 
-    // Get a texture uniform
+    // Get a texture uniform. Same as data uniforms for instances
     TextureUniform& GetTextureUniform(ShaderProgram::Location location);
     const TextureUniform& GetTextureUniform(ShaderProgram::Location location) const;
 
+    // Find a uniform stored in this collection. Returns null if not found
+    const DataUniform* FindDataUniform(ShaderProgram::Location location) const;
+    const TextureUniform* FindTextureUniform(ShaderProgram::Location location) const;
+
+    // Get the collection that stores the values of a data uniform: this one, or the parent if not overridden
+    const ShaderUniformCollection& GetDataOwner(ShaderProgram::Location location) const;
+
+    // Add a copy of a uniform of the parent, with the same values
+    DataUniform& OverrideUniform(const DataUniform& parentUniform);
+    template<typename T>
+    DataUniform& OverrideUniform(const DataUniform& parentUniform);
+    TextureUniform& OverrideUniform(const TextureUniform& parentUniform);
+
     // Read all the uniforms in the shader and store them as properties
     // Can skip by name those in the filteredUniforms
     void ExtractUniforms(const NameSet& filteredUniforms = NameSet());
@@ -140,6 +200,23 @@ private:
     void UseUniform(const DataUniform& uniform) const;
     void UseUniform(const TextureUniform& uniform) const;
 
+    // Upload the data uniforms that changed since the collection was last applied to the program
+    void UseDataUniforms() const;
+
+    // Bind all the textures. In an instance, those of the parent that are not overridden
+    void UseTextureUniforms() const;
+
+    // Upload the overridden data uniforms of an instance, on top of the values of the parent
+    void UseOverrideUniforms() const;
+
+    // Pack the data uniforms of the block that changed and upload them. Instances pack their overrides on top of the parent block
+    void UpdateUniformBlock() const;
+
+    // Copy the values of a data uniform to the block data, with the block layout
+    void PackUniform(const DataUniform& uniform) const;
+    template<typename T>
+    void PackUniform(const DataUniform& uniform) const;
+
     // Get the buffer where data values are stored for a certain type
     template<typename T>
     std::vector<T>& GetDataValues();
@@ -163,6 +240,12 @@ private:
     // Get the size of a data property
     int GetDataUniformSize(const DataUniform& uniform) const;
 
+    // Get the number of columns and rows of each element. Vectors have 1 column
+    static void GetDimensionSize(UniformDimension dimension, int& columns, int& rows);
+
+    // Flag the uniform to be uploaded and move the collection to a new version
+    void SetDirty(DataUniform& uniform);
+
     // Delete all the properties and set the shader program to null
     void Reset();
 
@@ -179,15 +262,35 @@ protected:
     std::shared_ptr<ShaderProgram> m_shaderProgram;
 
 private:
+    // Collection that stores the values that are not overridden. Null if this is not an instance
+    std::shared_ptr<const ShaderUniformCollection> m_parent;
+
     // The list of data properties
     std::vector<DataUniform> m_dataUniforms;
     // The list of texture properties
     std::vector<TextureUniform> m_textureUniforms;
 
-    // Map to find data properties in the data list
-    std::unordered_map<ShaderProgram::Location, int> m_locationDataIndex;
-    // Map to find texture properties in the texture list
-    std::unordered_map<ShaderProgram::Location, int> m_locationTextureIndex;
+    // Index of the data property in the data list, by location. -1 if it is not a data property
+    std::vector<int> m_locationDataIndex;
+    // Index of the texture property in the texture list, by location. -1 if it is not a texture property
+    std::vector<int> m_locationTextureIndex;
+
+    // The uniform block, if any. Mutable because the contents are uploaded when used
+    mutable UniformBlock m_uniformBlock;
+    // Locations given to the uniforms of the block, by name
+    std::unordered_map<UniformName::Hash, ShaderProgram::Location> m_blockUniformLocations;
+    // Locations of the uniforms of the block start after all the locations of the program
+    ShaderProgram::Location m_firstBlockLocation;
+    // In an instance, version of the parent when the block was packed
+    mutable unsigned long long m_packedParentVersion;
+
+    // Version of the values, changes every time a data property is modified
+    unsigned long long m_version;
+    // Version of the values the last time they were uploaded to the program
+    mutable unsigned long long m_uploadedVersion;
+
+    // Last version given to any collection. Versions are never repeated, so different collections can't be confused
+    static unsigned long long s_lastVersion;
 
     // Buffers that store the values for data properties
     std::vector<int> m_intDataValues;
@@ -198,7 +301,7 @@ private:
 
 
 template<typename T>
-inline T ShaderUniformCollection::GetUniformValue(const char* name) const
+inline T ShaderUniformCollection::GetUniformValue(UniformName name) const
 {
     T value;
     GetUniformValue(name, value);
@@ -214,7 +317,7 @@ inline T ShaderUniformCollection::GetUniformValue(ShaderProgram::Location locati
 }
 
 template<typename T>
-inline void ShaderUniformCollection::GetUniformValue(const char* name, T& value) const
+inline void ShaderUniformCollection::GetUniformValue(UniformName name, T& value) const
 {
     ShaderProgram::Location location = GetUniformLocation(name);
     assert(location >= 0);
@@ -239,7 +342,7 @@ template<>
 void ShaderUniformCollection::GetUniformValue(ShaderProgram::Location location, std::shared_ptr<const TextureObject>& value) const;
 
 template<typename T>
-inline void ShaderUniformCollection::GetUniformValues(const char* name, std::span<T> values) const
+inline void ShaderUniformCollection::GetUniformValues(UniformName name, std::span<T> values) const
 {
     ShaderProgram::Location location = GetUniformLocation(name);
     assert(location >= 0);
@@ -256,7 +359,7 @@ void ShaderUniformCollection::GetUniformValues(ShaderProgram::Location location,
 }
 
 template<typename T>
-inline void ShaderUniformCollection::SetUniformValue(const char* name, const T& value)
+inline void ShaderUniformCollection::SetUniformValue(UniformName name, const T& value)
 {
     ShaderProgram::Location location = GetUniformLocation(name);
     //assert(location >= 0);
@@ -283,7 +386,7 @@ template<>
 void ShaderUniformCollection::SetUniformValue(ShaderProgram::Location location, const std::shared_ptr<const TextureObject>& value);
 
 template<typename T>
-inline void ShaderUniformCollection::SetUniformValues(const char* name, std::span<const T> values)
+inline void ShaderUniformCollection::SetUniformValues(UniformName name, std::span<const T> values)
 {
     ShaderProgram::Location location = GetUniformLocation(name);
     assert(location >= 0);
@@ -293,10 +396,19 @@ inline void ShaderUniformCollection::SetUniformValues(const char* name, std::spa
 template<typename T>
 void ShaderUniformCollection::SetUniformValues(ShaderProgram::Location location, std::span<const T> values)
 {
-    std::span<T> storedValues;
-    GetDataValues(location, storedValues);
-    assert(values.size() == storedValues.size());
-    std::memcpy(storedValues.data(), values.data(), values.size_bytes());
+    std::span<const T> currentValues;
+    const_cast<const ShaderUniformCollection*>(this)->GetDataValues(location, currentValues);
+    assert(values.size() == currentValues.size());
+
+    // Only flag the uniform if the value is actually different. Instances don't override a value equal to the parent
+    if (std::memcmp(currentValues.data(), values.data(), values.size_bytes()) != 0)
+    {
+        DataUniform& uniform = GetDataUniform(location);
+        std::span<T> storedValues;
+        GetDataValues(location, storedValues);
+        std::memcpy(storedValues.data(), values.data(), values.size_bytes());
+        SetDirty(uniform);
+    }
 }
 
 template<typename T>
@@ -336,10 +448,11 @@ void ShaderUniformCollection::GetDataValues(ShaderProgram::Location location, st
 template<typename T>
 void ShaderUniformCollection::GetDataValues(ShaderProgram::Location location, std::span<const T>& values) const
 {
-    const DataUniform& uniform = GetDataUniform(location);
+    const ShaderUniformCollection& owner = GetDataOwner(location);
+    const DataUniform& uniform = owner.GetDataUniform(location);
     assert(uniform.type == Data::GetType<T>());
     assert(IsScalar(uniform.dimension));
-    const std::vector<T>& allValues = GetDataValues<T>();
+    const std::vector<T>& allValues = owner.GetDataValues<T>();
     auto dataPtr = &allValues[uniform.index];
     values = std::span(dataPtr, uniform.count);
 }
@@ -347,11 +460,12 @@ void ShaderUniformCollection::GetDataValues(ShaderProgram::Location location, st
 template<typename T, int N>
 void ShaderUniformCollection::GetDataValues(ShaderProgram::Location location, std::span<const glm::vec<N, T>>& values) const
 {
-    const DataUniform& uniform = GetDataUniform(location);
+    const ShaderUniformCollection& owner = GetDataOwner(location);
+    const DataUniform& uniform = owner.GetDataUniform(location);
     assert(uniform.type == Data::GetType<T>());
     assert(IsVector(uniform.dimension));
     assert(IsVectorSize(uniform.dimension, N));
-    const std::vector<T>& allValues = GetDataValues<T>();
+    const std::vector<T>& allValues = owner.GetDataValues<T>();
     auto dataPtr = reinterpret_cast<const glm::vec<N, T>*>(&allValues[uniform.index]);
     values = std::span(dataPtr, uniform.count);
 }
@@ -359,17 +473,18 @@ void ShaderUniformCollection::GetDataValues(ShaderProgram::Location location, st
 template<typename T, int C, int R>
 void ShaderUniformCollection::GetDataValues(ShaderProgram::Location location, std::span<const glm::mat<C, R, T>>& values) const
 {
-    const DataUniform& uniform = GetDataUniform(location);
+    const ShaderUniformCollection& owner = GetDataOwner(location);
+    const DataUniform& uniform = owner.GetDataUniform(location);
     assert(uniform.type == Data::GetType<T>());
     assert(IsMatrix(uniform.dimension));
     assert(IsMatrixSize(uniform.dimension, C, R));
-    const std::vector<T>& allValues = GetDataValues<T>();
+    const std::vector<T>& allValues = owner.GetDataValues<T>();
     auto dataPtr = reinterpret_cast<const glm::mat<C, R, T>*>(&allValues[uniform.index]);
     values = std::span(dataPtr, uniform.count);
 }
 
 template<typename T>
-T* ShaderUniformCollection::GetDataUniformPointer(const char* name)
+T* ShaderUniformCollection::GetDataUniformPointer(UniformName name)
 {
     ShaderProgram::Location location = GetUniformLocation(name);
     assert(location >= 0);
@@ -379,7 +494,9 @@ T* ShaderUniformCollection::GetDataUniformPointer(const char* name)
 template<typename T>
 T* ShaderUniformCollection::GetDataUniformPointer(ShaderProgram::Location location)
 {
-    const DataUniform& uniform = GetDataUniform(location);
+    // The value can be modified through the pointer, assume it will be
+    DataUniform& uniform = GetDataUniform(location);
+    SetDirty(uniform);
     std::vector<T>& allValues = GetDataValues<T>();
     return &allValues[uniform.index];
 }
@@ -387,8 +504,13 @@ T* ShaderUniformCollection::GetDataUniformPointer(ShaderProgram::Location locati
 template<typename T>
 void ShaderUniformCollection::AddUniform(const DataUniform& uniform)
 {
-    m_locationDataIndex.insert(std::make_pair(uniform.location, static_cast<int>(m_dataUniforms.size())));
+    if (uniform.location >= static_cast<ShaderProgram::Location>(m_locationDataIndex.size()))
+    {
+        m_locationDataIndex.resize(uniform.location + 1, -1);
+    }
+    m_locationDataIndex[uniform.location] = static_cast<int>(m_dataUniforms.size());
     m_dataUniforms.push_back(uniform);
+    m_dataUniforms.back().dirty = true;
 
     std::vector<T>& values = GetDataValues<T>();
     m_dataUniforms.back().index = static_cast<int>(values.size());
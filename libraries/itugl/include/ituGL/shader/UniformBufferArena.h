@@ -0,0 +1,106 @@
+#pragma once
+
+#include <ituGL/shader/UniformBufferObject.h>
+#include <vector>
+#include <memory>
+
+// One big uniform buffer shared by many uniform blocks, each of them in its own range
+// Switching between blocks is only binding a different range, instead of setting each uniform
+class UniformBufferArena
+{
+public:
+    // Range of the buffer, in bytes
+    struct Range
+    {
+        GLintptr offset = 0;
+        GLsizeiptr size = 0;
+    };
+
+public:
+    // Allocates the whole buffer. The GL context must be current
+    UniformBufferArena(GLsizeiptr capacity = 64 * 1024);
+
+    // Reserve a range with the offset aligned for binding. Returns false if there is not enough space
+    bool Allocate(GLsizeiptr size, Range& range);
+
+    // Release a range, so it can be reused by other blocks
+    void Free(const Range& range);
+
+    // Write the contents of a range
+    void UpdateData(const Range& range, std::span<const std::byte> data);
+
+    // Bind a range to a uniform buffer binding point
+    void BindRange(GLuint bindingIndex, const Range& range) const;
+
+    // Arena used when this one is full. Created the first time it is needed, with the same capacity
+    std::shared_ptr<UniformBufferArena> GetNextArena();
+
+    inline GLsizeiptr GetCapacity() const { return m_capacity; }
+    inline GLsizeiptr GetUsedSize() const { return m_usedSize; }
+
+private:
+    UniformBufferObject m_buffer;
+
+    GLsizeiptr m_capacity;
+
+    // Alignment of the offsets of the ranges
+    GLsizeiptr m_alignment;
+
+    // Start of the part of the buffer that was never allocated
+    GLintptr m_top;
+
+    // Bytes currently allocated
+    GLsizeiptr m_usedSize;
+
+    // Ranges released, to be reused before growing the top. Sorted by offset, neighbours are merged
+    std::vector<Range> m_freeRanges;
+
+    // Next arena of the chain, if this one was filled
+    std::shared_ptr<UniformBufferArena> m_nextArena;
+};
+
+// Range of a UniformBufferArena owned by one uniform block
+// If the arena is full, the range is allocated in the next arena of its chain
+// Copies allocate their own range, that must be uploaded again. The range is released when destroyed
+class UniformBufferAllocation
+{
+public:
+    UniformBufferAllocation();
+    UniformBufferAllocation(std::shared_ptr<UniformBufferArena> arena, GLsizeiptr size);
+    ~UniformBufferAllocation();
+
+    UniformBufferAllocation(const UniformBufferAllocation& allocation);
+    UniformBufferAllocation& operator = (const UniformBufferAllocation& allocation);
+
+    // Moving keeps the same range, and the contents
+    UniformBufferAllocation(UniformBufferAllocation&& allocation) noexcept;
+    UniformBufferAllocation& operator = (UniformBufferAllocation&& allocation) noexcept;
+
+    // If the range was allocated
+    inline bool IsValid() const { return m_range.size > 0; }
+
+    // If the contents were written since the range was allocated
+    inline bool IsUploaded() const { return m_uploaded; }
+
+    inline const UniformBufferArena::Range& GetRange() const { return m_range; }
+
+    // Write the contents of the range
+    void UpdateData(std::span<const std::byte> data);
+
+    // Bind the range to a uniform buffer binding point
+    void BindRange(GLuint bindingIndex) const;
+
+private:
+    // Allocate a range of the size in the arena, or in the next ones of the chain if it is full
+    void Allocate(std::shared_ptr<UniformBufferArena> arena, GLsizeiptr size);
+
+    // Release the range, if any
+    void Free();
+
+private:
+    std::shared_ptr<UniformBufferArena> m_arena;
+
+    UniformBufferArena::Range m_range;
+
+    bool m_uploaded;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ituGL/core/BufferObject.h>
+
+// Uniform Buffer Object (UBO) is a BufferObject that stores the values of uniform blocks
+// Ranges of the buffer are bound to indexed binding points, and the uniform blocks read from the binding point they are assigned
+class UniformBufferObject : public BufferObjectBase<BufferObject::UniformBuffer>
+{
+public:
+    UniformBufferObject();
+
+    // Bind a range of the buffer to an indexed binding point. The offset must be a multiple of GetOffsetAlignment()
+    void BindRange(GLuint bindingIndex, GLintptr offset, GLsizeiptr size) const;
+
+    // Alignment required for the offsets of the ranges, queried from the context
+    static GLint GetOffsetAlignment();
+};
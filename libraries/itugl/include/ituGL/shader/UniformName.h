@@ -0,0 +1,52 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+
+// Name of a shader uniform, together with a hash of the name
+// Built from a string literal, the hash is computed at compile time. Built from a char pointer, it is computed at runtime
+// Programs keep a table from hashes to locations, so finding a uniform by name doesn't ask the driver
+class UniformName
+{
+public:
+    // 32 bits are enough for the few uniforms of a program. Collisions are checked in debug builds
+    using Hash = unsigned int;
+
+public:
+    // From a string literal
+    template<std::size_t N>
+    consteval UniformName(const char (&name)[N]) : m_name(name), m_hash(ComputeHash(name))
+    {
+    }
+
+    // From a char array filled at runtime, like the names returned by the driver
+    template<std::size_t N>
+    constexpr UniformName(char (&name)[N]) : m_name(name), m_hash(ComputeHash(name))
+    {
+    }
+
+    // From a string that is only known at runtime
+    template<typename T> requires std::same_as<T, const char*> || std::same_as<T, char*>
+    constexpr UniformName(T name) : m_name(name), m_hash(ComputeHash(name))
+    {
+    }
+
+    inline constexpr const char* GetName() const { return m_name; }
+    inline constexpr Hash GetHash() const { return m_hash; }
+
+    // FNV-1a 32 bits hash of a null terminated string
+    static constexpr Hash ComputeHash(const char* name)
+    {
+        Hash hash = 2166136261u;
+        for (; *name; ++name)
+        {
+            hash ^= static_cast<unsigned char>(*name);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+private:
+    const char* m_name;
+    Hash m_hash;
+};
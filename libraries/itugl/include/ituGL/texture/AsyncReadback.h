@@ -0,0 +1,58 @@
+#pragma once
+
+#include <ituGL/texture/PixelPackBufferObject.h>
+#include <ituGL/core/GpuFence.h>
+#include <span>
+
+// Result of a pixel read that is still traveling from the GPU (see FramebufferObject::ReadPixelsAsync and TextureObject::ReadAsync)
+// The pixels are copied into a PBO and a fence is inserted after the copy. Poll IsReady() in later frames,
+// and when it is ready, GetData() maps the PBO without stalling
+class AsyncReadback
+{
+public:
+    // Create a readback of rowPitch * height bytes. Used by the ReadAsync methods, before issuing the copy
+    AsyncReadback(int width, int height, size_t rowPitch);
+    ~AsyncReadback();
+
+    // Move semantics
+    AsyncReadback(AsyncReadback&& readback) noexcept;
+    AsyncReadback& operator = (AsyncReadback&& readback) noexcept;
+
+    inline int GetWidth() const { return m_width; }
+    inline int GetHeight() const { return m_height; }
+
+    // Bytes between the start of two rows, rows are aligned to the GL_PACK_ALIGNMENT (4 bytes)
+    inline size_t GetRowPitch() const { return m_rowPitch; }
+
+    // Check without blocking if the copy has finished
+    bool IsReady() const;
+
+    // Block until the copy has finished
+    void Wait() const;
+
+    // Map the pixels, blocking if the copy didn't finish yet. Rows go from bottom to top, as in GL
+    // The span is valid until Unmap is called, or the readback is destroyed
+    std::span<const std::byte> GetData();
+
+    // Release the mapped data, if any
+    void Unmap();
+
+    // Used by the ReadAsync methods: Bind the PBO as destination, and fence the copy when done
+    void BeginCopy();
+    void EndCopy();
+
+    // Row pitch for a row of pixels with the default pack alignment
+    static size_t ComputeRowPitch(int width, size_t pixelSize);
+
+private:
+    PixelPackBufferObject m_buffer;
+
+    GpuFence m_fence;
+
+    int m_width;
+    int m_height;
+    size_t m_rowPitch;
+
+    // Mapped pixels, null if not mapped
+    const std::byte* m_mappedData;
+};
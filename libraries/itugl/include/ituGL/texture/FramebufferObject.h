@@ -1,10 +1,12 @@
 #pragma once
 
 #include <ituGL/core/Object.h>
+#include <ituGL/core/Data.h>
+#include <ituGL/texture/TextureObject.h>
+#include <ituGL/texture/AsyncReadback.h>
 #include <span>
 #include <memory>
 
-class TextureObject;
 class Texture2DObject;
 
 // Abstract OpenGL object that encapsulates a Framebuffer
@@ -33,6 +35,10 @@ public:
 
     void SetDrawBuffers(std::span<const Attachment> attachments);
 
+    // Copy a rectangle of the attachment into a PBO, without waiting for the GPU. Poll the result in later frames
+    // The framebuffer must be bound for reading. In the default framebuffer, the current read buffer is used
+    AsyncReadback ReadPixelsAsync(Attachment attachment, int x, int y, int width, int height, TextureObject::Format format, Data::Type type) const;
+
     static std::shared_ptr<const FramebufferObject> GetDefault();
 
 private:
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <ituGL/core/BufferObject.h>
+
+// Pixel Pack Buffer Object (PBO) is a BufferObject used as destination of glReadPixels and glGetTexImage
+// The copy happens in the GPU timeline, so the CPU doesn't need to wait for the rendering to finish
+class PixelPackBufferObject : public BufferObjectBase<BufferObject::PixelPackBuffer>
+{
+public:
+    PixelPackBufferObject();
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ituGL/texture/SamplerObject.h>
+#include <unordered_map>
+#include <memory>
+
+// Keeps one SamplerObject for each different sampler state
+// Materials asking for the same state share the same sampler, so there are only a few of them and binding is cheap
+class SamplerCache
+{
+public:
+    SamplerCache();
+
+    // Get the sampler with this state, creating it the first time. The GL context must be current
+    std::shared_ptr<const SamplerObject> GetSampler(const SamplerObject::State& state);
+
+    // Number of different samplers created
+    inline unsigned int GetSamplerCount() const { return static_cast<unsigned int>(m_samplers.size()); }
+
+    // Release the samplers. Those still used by materials are deleted when the materials release them
+    void Clear();
+
+private:
+    // Hash of all the parameters of the state
+    struct StateHash
+    {
+        size_t operator()(const SamplerObject::State& state) const;
+    };
+
+private:
+    std::unordered_map<SamplerObject::State, std::shared_ptr<const SamplerObject>, StateHash> m_samplers;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <ituGL/core/Object.h>
+#include <ituGL/texture/TextureObject.h>
+#include <array>
+
+// Sampler Object is an OpenGL Object that stores how a texture is sampled: filtering, wrapping and level of detail
+// When bound to a texture unit, it overrides the sampling parameters of the texture bound to the same unit
+// This way, the same texture can be sampled in different ways without duplicating it
+class SamplerObject : public Object
+{
+public:
+    // All the sampling parameters. Default values are the same as OpenGL defaults
+    struct State
+    {
+        GLenum minFilter = GL_NEAREST_MIPMAP_LINEAR;
+        GLenum magFilter = GL_LINEAR;
+        GLenum wrapS = GL_REPEAT;
+        GLenum wrapT = GL_REPEAT;
+        GLenum wrapR = GL_REPEAT;
+        GLfloat minLod = -1000.0f;
+        GLfloat maxLod = 1000.0f;
+        GLfloat lodBias = 0.0f;
+        std::array<GLfloat, 4> borderColor = {};
+
+        bool operator == (const State& other) const = default;
+    };
+
+public:
+    SamplerObject();
+    virtual ~SamplerObject();
+
+    // (C++) 8
+    // Move semantics
+    SamplerObject(SamplerObject&& samplerObject) noexcept;
+    SamplerObject& operator = (SamplerObject&& samplerObject) noexcept;
+
+    // Implements the Bind required by Object. Samplers are bound to a texture unit, use Bind(textureUnit)
+    void Bind() const override;
+
+    // Bind the sampler to a texture unit
+    void Bind(GLuint textureUnit) const;
+
+    // Unbind the sampler of a texture unit, so the parameters of the texture are used again
+    static void Unbind(GLuint textureUnit);
+
+    // Set all the parameters at once
+    void SetState(const State& state);
+
+    // Get / set value of the sampler parameter of type float (MinLod, MaxLod, LodBias)
+    void GetParameter(TextureObject::ParameterFloat pname, GLfloat& param) const;
+    void SetParameter(TextureObject::ParameterFloat pname, GLfloat param);
+
+    // Get / set value of the sampler parameter of type enum (filters and wrap modes)
+    void GetParameter(TextureObject::ParameterEnum pname, GLenum& param) const;
+    void SetParameter(TextureObject::ParameterEnum pname, GLenum param);
+
+    // Get / set value of the sampler parameter of type color (BorderColor)
+    void GetParameter(TextureObject::ParameterColor pname, std::span<GLfloat, 4> params) const;
+    void SetParameter(TextureObject::ParameterColor pname, std::span<const GLfloat, 4> params);
+
+private:
+#ifndef NDEBUG
+    // Swizzle and depth stencil mode belong to the texture, not to the sampler
+    static bool IsSamplerParameter(TextureObject::ParameterEnum pname);
+#endif
+};
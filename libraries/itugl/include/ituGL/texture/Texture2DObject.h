@@ -20,12 +20,26 @@ public:
         GLsizei width, GLsizei height,
         Format format, InternalFormat internalFormat,
         std::span<const T> data, Data::Type type = Data::Type::None);
+
+    // Allocate immutable storage for all the mipmap levels at once. The size and format can't change anymore, use SetSubImage to fill it
+    // Without Direct State Access, it is emulated with SetImage on each level
+    void SetStorage(GLsizei levels, GLsizei width, GLsizei height, InternalFormat internalFormat);
+
+    // Replace the data of a region of a mipmap level
+    template <typename T>
+    void SetSubImage(GLint level, GLint x, GLint y,
+        GLsizei width, GLsizei height, Format format,
+        std::span<const T> data, Data::Type type = Data::Type::None);
 };
 
 // Set image with data in bytes
 template <>
 void Texture2DObject::SetImage<std::byte>(GLint level, GLsizei width, GLsizei height, Format format, InternalFormat internalFormat, std::span<const std::byte> data, Data::Type type);
 
+// Set subimage with data in bytes
+template <>
+void Texture2DObject::SetSubImage<std::byte>(GLint level, GLint x, GLint y, GLsizei width, GLsizei height, Format format, std::span<const std::byte> data, Data::Type type);
+
 // Template method to set image with any kind of data
 template <typename T>
 inline void Texture2DObject::SetImage(GLint level, GLsizei width, GLsizei height,
@@ -38,3 +52,14 @@ inline void Texture2DObject::SetImage(GLint level, GLsizei width, GLsizei height
     SetImage(level, width, height, format, internalFormat, Data::GetBytes(data), type);
 }
 
+// Template method to set subimage with any kind of data
+template <typename T>
+inline void Texture2DObject::SetSubImage(GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+    Format format, std::span<const T> data, Data::Type type)
+{
+    if (type == Data::Type::None)
+    {
+        type = Data::GetType<T>();
+    }
+    SetSubImage(level, x, y, width, height, format, Data::GetBytes(data), type);
+}
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <ituGL/core/Object.h>
+#include <ituGL/core/Data.h>
 #include <span>
 
+class AsyncReadback;
+
 // Abstract OpenGL object that encapsulates a Texture
 // There are different subtypes depending on the target
 class TextureObject : public Object
@@ -25,7 +28,8 @@ public:
     enum class ParameterColor : GLenum;
 
 public:
-    TextureObject();
+    // The target is needed to create the texture with Direct State Access
+    TextureObject(Target target);
     virtual ~TextureObject();
 
     // (C++) 8
@@ -69,12 +73,25 @@ public:
     // Set value of the texture parameter of type color
     void SetParameter(ParameterColor pname, std::span<const GLfloat, 4> params);
 
+    // Copy the image of a mipmap level into a PBO, without waiting for the GPU. Poll the result in later frames
+    // For 3D textures and arrays, the layers are stacked as extra rows. Cubemaps are not supported
+    AsyncReadback ReadAsync(int level, Format format, Data::Type type) const;
+
     // Get number of componentes (1-4) of a specific texture format)
     static int GetComponentCount(Format format);
 
     // Get number of components of the data type of the texture (packed components count as 1)
     static int GetDataComponentCount(InternalFormat internalFormat);
 
+    // Get the Format with the same components as the InternalFormat
+    static Format GetFormat(InternalFormat internalFormat);
+
+    // Get a sized InternalFormat equivalent to a base or generic compressed one. Immutable storage requires sized formats
+    static InternalFormat GetSizedInternalFormat(InternalFormat internalFormat);
+
+    // Get the number of mipmap levels of a full mipmap chain, down to 1x1
+    static int GetMipmapLevelCount(GLsizei width, GLsizei height = 1, GLsizei depth = 1);
+
     // Set active texture unit
     static void SetActiveTexture(GLint textureUnit);
 
@@ -85,6 +102,9 @@ protected:
     static void Unbind(Target target);
 
 #ifndef NDEBUG
+    // With Direct State Access enabled, the texture is edited through its handle and doesn't need to be bound
+    bool IsReadyToEdit() const;
+
     // Get active texture unit
     static GLint GetActiveTexture();
 
@@ -101,7 +121,7 @@ template<TextureObject::Target T>
 class TextureObjectBase : public TextureObject
 {
 public:
-    inline TextureObjectBase() {}
+    inline TextureObjectBase() : TextureObject(T) {}
 
     // Return the templated enum value T
     inline Target GetTarget() const override { return T; }
@@ -4,12 +4,17 @@
 #include <cassert>
 // For accurate application time
 #include <chrono>
+// For fmod
+#include <cmath>
 // For error messages
 #include <iostream>
 
 // DeviceGL and main Window are constructed in the correct order because they were declared like that!
 Application::Application(int width, int height, const char* title)
-    : m_mainWindow(width, height, title), m_exitCode(0)
+    : m_mainWindow(width, height, title)
+    , m_currentTime(0.0f), m_deltaTime(0.0f)
+    , m_fixedDeltaTime(0.0f), m_maxTicksPerFrame(0), m_tickAccumulator(0.0f), m_tickCount(0)
+    , m_exitCode(0)
 {
     // If the main window is not valid, exit with error
     if (!m_mainWindow.IsValid())
@@ -44,6 +49,14 @@ int Application::Run()
     {
         Initialize();
 
+        // From here, the GL context belongs to the render thread
+        if (m_renderThread)
+        {
+            m_renderThread->Start();
+        }
+
+        m_framePacer.MarkInputSampled();
+
         // current time when the application started
         auto startTime = std::chrono::steady_clock::now();
 
@@ -54,14 +67,36 @@ int Application::Run()
             std::chrono::duration<float> duration = std::chrono::steady_clock::now() - startTime;
             UpdateTime(duration.count());
 
+            RunFixedTicks();
+
             Update();
 
             Render();
 
             // Swap buffers and poll events at the end of the frame
-            m_mainWindow.SwapBuffers();
+            if (m_renderThread)
+            {
+                // The render thread swaps buffers after executing the frame
+                m_renderThread->SubmitFrame();
+            }
+            else
+            {
+                m_mainWindow.SwapBuffers();
+                m_framePacer.EndFrame();
+            }
+
+            // Sleep before polling, so the input is as recent as possible when the next frame starts
+            m_framePacer.WaitForNextFrame();
             m_device.PollEvents();
+            m_framePacer.MarkInputSampled();
+        }
+
+        // Get the GL context back to release the resources
+        if (m_renderThread)
+        {
+            m_renderThread->Stop();
         }
+        m_framePacer.Reset();
 
         Cleanup();
     }
@@ -74,6 +109,10 @@ void Application::Initialize()
 {
 }
 
+void Application::FixedUpdate()
+{
+}
+
 void Application::Update()
 {
     if (m_mainWindow.IsKeyPressed(GLFW_KEY_ESCAPE))
@@ -116,6 +155,46 @@ void Application::UpdateTime(float newCurrentTime)
     m_currentTime = newCurrentTime;
 }
 
+void Application::EnableRenderThread(unsigned int frameBufferCount)
+{
+    assert(!m_renderThread);
+    m_renderThread = std::make_unique<RenderThread>(m_mainWindow, frameBufferCount);
+}
+
+void Application::SetFixedTickRate(float tickRate, unsigned int maxTicksPerFrame)
+{
+    assert(tickRate >= 0.0f);
+    assert(maxTicksPerFrame > 0);
+    m_fixedDeltaTime = tickRate > 0.0f ? 1.0f / tickRate : 0.0f;
+    m_maxTicksPerFrame = maxTicksPerFrame;
+    m_tickAccumulator = 0.0f;
+}
+
+void Application::RunFixedTicks()
+{
+    if (!IsFixedTickEnabled())
+    {
+        return;
+    }
+
+    m_tickAccumulator += m_deltaTime;
+
+    unsigned int tickCount = 0;
+    while (m_tickAccumulator >= m_fixedDeltaTime && tickCount < m_maxTicksPerFrame)
+    {
+        FixedUpdate();
+        m_tickAccumulator -= m_fixedDeltaTime;
+        m_tickCount++;
+        tickCount++;
+    }
+
+    // Too far behind, drop the whole ticks left. The simulation slows down instead of spiralling
+    if (m_tickAccumulator >= m_fixedDeltaTime)
+    {
+        m_tickAccumulator = std::fmod(m_tickAccumulator, m_fixedDeltaTime);
+    }
+}
+
 bool Application::IsRunning() const
 {
     // Run while the window is valid and it has not been requested to close
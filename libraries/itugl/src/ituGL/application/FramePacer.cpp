@@ -0,0 +1,127 @@
+#include <ituGL/application/FramePacer.h>
+
+#include <algorithm>
+#include <thread>
+#include <cstdint>
+#include <cassert>
+
+FramePacer::FramePacer()
+    : m_maxFramesInFlight(0)
+    , m_targetFrameRate(0.0f)
+    , m_nextFrameTime(Clock::now())
+    , m_inputTime(Clock::now())
+    , m_latencySamples{}
+    , m_latencySampleIndex(0)
+{
+}
+
+FramePacer::~FramePacer()
+{
+    // Fences must be deleted with the context current, call Reset before
+    assert(m_pendingFrames.empty());
+}
+
+void FramePacer::SetTargetFrameRate(float targetFrameRate)
+{
+    assert(targetFrameRate >= 0.0f);
+    m_targetFrameRate = targetFrameRate;
+    m_nextFrameTime = Clock::now();
+}
+
+void FramePacer::MarkInputSampled()
+{
+    m_inputTime = Clock::now();
+}
+
+void FramePacer::EndFrame()
+{
+    // Signaled when the GPU finishes all the commands of this frame, including the present
+    // The timestamp goes before the fence, so it is written once the fence is signaled
+    FrameFence& frameFence = m_pendingFrames.emplace_back();
+    frameFence.completionTimestamp.Record();
+    frameFence.fence.Insert();
+    frameFence.gpuSubmitTime = GpuTimestamp::GetCurrentTime();
+    frameFence.submitTime = Clock::now();
+    frameFence.inputTime = m_inputTime;
+
+    // Collect the frames that already finished, without blocking
+    RetireFences(false);
+
+    // Too many frames queued, wait for the oldest ones. Waiting here, before polling the input, keeps the latency low
+    while (m_maxFramesInFlight > 0 && m_pendingFrames.size() > m_maxFramesInFlight)
+    {
+        RetireFences(true);
+    }
+}
+
+void FramePacer::WaitForNextFrame()
+{
+    if (m_targetFrameRate <= 0.0f)
+    {
+        return;
+    }
+
+    Clock::duration framePeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetFrameRate));
+    m_nextFrameTime += framePeriod;
+
+    Clock::time_point now = Clock::now();
+    if (m_nextFrameTime > now)
+    {
+        // Sleep instead of spinning. It can oversleep a bit, but it is corrected by advancing from the expected time, not from now
+        std::this_thread::sleep_until(m_nextFrameTime);
+    }
+    else if (now - m_nextFrameTime > framePeriod)
+    {
+        // More than a frame late, don't try to catch up with faster frames
+        m_nextFrameTime = now;
+    }
+}
+
+void FramePacer::Reset()
+{
+    m_pendingFrames.clear();
+}
+
+void FramePacer::RetireFences(bool wait)
+{
+    while (!m_pendingFrames.empty())
+    {
+        FrameFence& frameFence = m_pendingFrames.front();
+
+        // Only block for the oldest frame
+        bool signaled = wait ? frameFence.fence.Wait() : frameFence.fence.IsSignaled();
+        if (!signaled)
+        {
+            break;
+        }
+
+        // Completion time in the CPU clock. The GPU can finish before the submit time is read, so the offset is signed
+        std::int64_t completionOffset = static_cast<std::int64_t>(frameFence.completionTimestamp.GetTime() - frameFence.gpuSubmitTime);
+        Clock::time_point completionTime = frameFence.submitTime + std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(completionOffset));
+
+        std::chrono::duration<float> latency = completionTime - frameFence.inputTime;
+        AddLatencySample(latency.count());
+        m_pendingFrames.pop_front();
+
+        wait = false;
+    }
+}
+
+void FramePacer::AddLatencySample(float latency)
+{
+    m_latencySamples[m_latencySampleIndex] = latency;
+    m_latencySampleIndex = (m_latencySampleIndex + 1) % LatencySampleCount;
+
+    m_latencyStats.last = latency;
+    m_latencyStats.sampleCount = std::min(m_latencyStats.sampleCount + 1, LatencySampleCount);
+
+    float sum = 0.0f;
+    float max = 0.0f;
+    for (unsigned int i = 0; i < m_latencyStats.sampleCount; ++i)
+    {
+        sum += m_latencySamples[i];
+        max = std::max(max, m_latencySamples[i]);
+    }
+    m_latencyStats.average = sum / m_latencyStats.sampleCount;
+    m_latencyStats.max = max;
+}
@@ -0,0 +1,141 @@
+#include <ituGL/application/RenderThread.h>
+
+#include <ituGL/core/DeviceGL.h>
+#include <ituGL/application/Window.h>
+#include <cassert>
+
+RenderThread::RenderThread(Window& window, unsigned int frameBufferCount)
+    : m_window(window)
+    , m_frames(frameBufferCount)
+    , m_submittedCount(0)
+    , m_completedCount(0)
+    , m_stop(false)
+{
+    // With a single packet, the update thread could never record while the render thread executes
+    assert(frameBufferCount >= 2);
+}
+
+RenderThread::~RenderThread()
+{
+    if (IsRunning())
+    {
+        Stop();
+    }
+}
+
+void RenderThread::Start()
+{
+    assert(!IsRunning());
+    assert(glfwGetCurrentContext() == m_window.GetInternalWindow());
+
+    m_stop = false;
+
+    // A context can only be current in one thread at a time
+    glfwMakeContextCurrent(nullptr);
+    m_thread = std::thread(&RenderThread::ThreadLoop, this);
+}
+
+void RenderThread::Stop()
+{
+    assert(IsRunning());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_submittedCondition.notify_one();
+    m_thread.join();
+
+    glfwMakeContextCurrent(m_window.GetInternalWindow());
+
+    // Commands recorded after the last submit are lost
+    GetRecordingFrame().commands.clear();
+}
+
+void RenderThread::Enqueue(Command command)
+{
+    GetRecordingFrame().commands.push_back(std::move(command));
+}
+
+void RenderThread::SubmitFrame()
+{
+    SubmitPacket(true);
+}
+
+void RenderThread::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_completedCondition.wait(lock, [this] { return m_completedCount == m_submittedCount; });
+}
+
+void RenderThread::ExecuteAndWait(Command command)
+{
+    assert(IsRunning());
+
+    // Send the commands recorded so far without presenting, followed by this one
+    Enqueue(std::move(command));
+    SubmitPacket(false);
+    Flush();
+}
+
+RenderThread::FramePacket& RenderThread::GetRecordingFrame()
+{
+    // Only the update thread changes the submitted count, no need to lock to read it
+    return m_frames[m_submittedCount % m_frames.size()];
+}
+
+void RenderThread::SubmitPacket(bool present)
+{
+    GetRecordingFrame().present = present;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_submittedCount++;
+    m_submittedCondition.notify_one();
+
+    // Wait until the next packet to record is not used by the render thread anymore
+    unsigned long long frameBufferCount = m_frames.size();
+    m_completedCondition.wait(lock, [&] { return m_submittedCount - m_completedCount < frameBufferCount; });
+}
+
+void RenderThread::ThreadLoop()
+{
+    glfwMakeContextCurrent(m_window.GetInternalWindow());
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_submittedCondition.wait(lock, [this] { return m_stop || m_completedCount < m_submittedCount; });
+
+        // Finish the submitted packets before stopping
+        if (m_completedCount == m_submittedCount)
+        {
+            break;
+        }
+
+        FramePacket& frame = m_frames[m_completedCount % m_frames.size()];
+        lock.unlock();
+
+        // Viewport changes requested from the event thread
+        DeviceGL::GetInstance().ApplyPendingViewport();
+
+        for (Command& command : frame.commands)
+        {
+            command();
+        }
+
+        // Release the captured state now, but keep the memory for the next time
+        frame.commands.clear();
+
+        if (frame.present)
+        {
+            m_window.SwapBuffers();
+        }
+
+        lock.lock();
+        m_completedCount++;
+        m_completedCondition.notify_all();
+    }
+    lock.unlock();
+
+    glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,63 @@
+#include <ituGL/asset/LazyShaderProgram.h>
+
+#include <ituGL/shader/ShaderProgram.h>
+
+LazyShaderProgram::LazyShaderProgram(ShaderProgramCache& shaderProgramCache, std::span<const char*> vertexShaderPaths, std::span<const char*> fragmentShaderPaths,
+    std::span<const std::string> defines)
+    : m_shaderProgramCache(shaderProgramCache)
+    , m_stages{ { Shader::VertexShader, { vertexShaderPaths.begin(), vertexShaderPaths.end() } },
+                { Shader::FragmentShader, { fragmentShaderPaths.begin(), fragmentShaderPaths.end() } } }
+    , m_defines(defines.begin(), defines.end())
+    , m_state(State::NotRequested)
+{
+}
+
+LazyShaderProgram::~LazyShaderProgram()
+{
+    if (m_state == State::Building)
+    {
+        m_shaderProgramCache.CancelAsync(*m_shaderProgram);
+    }
+}
+
+std::shared_ptr<ShaderProgram> LazyShaderProgram::Request()
+{
+    switch (m_state)
+    {
+    case State::NotRequested:
+    {
+        // The cache takes the paths as C strings
+        std::vector<std::vector<const char*>> paths(m_stages.size());
+        std::vector<ShaderProgramCache::Stage> stages;
+        for (size_t i = 0; i < m_stages.size(); ++i)
+        {
+            for (const std::string& path : m_stages[i].paths)
+            {
+                paths[i].push_back(path.c_str());
+            }
+            stages.push_back({ m_stages[i].type, paths[i] });
+        }
+
+        m_shaderProgram = std::make_shared<ShaderProgram>();
+        if (!m_shaderProgramCache.BuildAsync(*m_shaderProgram, stages, m_defines))
+        {
+            m_state = State::Failed;
+            break;
+        }
+
+        // Not checked in the same request, so the driver has at least one frame to compile it
+        m_state = State::Building;
+        break;
+    }
+    case State::Building:
+        if (m_shaderProgramCache.PollAsync(*m_shaderProgram))
+        {
+            m_state = m_shaderProgram->IsLinked() ? State::Ready : State::Failed;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return m_state == State::Ready ? m_shaderProgram : nullptr;
+}
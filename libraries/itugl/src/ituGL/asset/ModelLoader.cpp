@@ -1,16 +1,18 @@
 #include <ituGL/asset/ModelLoader.h>
 
-#include <ituGL/geometry/VertexFormat.h>
-#include <ituGL/shader/Material.h>
+#include <ituGL/core/JobSystem.h>
+#include <ituGL/shader/MaterialInstance.h>
 #include <ituGL/asset/Texture2DLoader.h>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <algorithm>
 #include <iostream>
 
 ModelLoader::ModelLoader(std::shared_ptr<Material> referenceMaterial)
     : m_referenceMaterial(referenceMaterial)
     , m_createMaterials(false)
+    , m_jobSystem(nullptr)
 {
     m_textureLoader.SetGenerateMipmap(true);
 }
@@ -87,18 +89,67 @@ Model ModelLoader::Load(const char* path)
     // If the file was loaded, load all the meshes as submeshes
     if (scene)
     {
+        // Decode the textures in jobs, while the submesh data is collected
+        std::vector<TextureRequest> textureRequests;
+        std::vector<JobSystem::JobHandle> textureJobs;
+        if (m_jobSystem && m_createMaterials)
+        {
+            CollectTextureRequests(*scene, textureRequests);
+            for (TextureRequest& textureRequest : textureRequests)
+            {
+                textureJobs.push_back(m_jobSystem->Run([this, &textureRequest]
+                    {
+                        textureRequest.textureData = m_textureLoader.LoadData(textureRequest.path.c_str(), textureRequest.format, textureRequest.internalFormat);
+                    }, "DecodeTexture"));
+            }
+        }
+
+        // Pack the vertex and element data of all the meshes, in parallel if we have a job system
+        std::vector<SubmeshData> submeshes(scene->mNumMeshes);
+        auto collectSubmeshes = [&](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int meshIndex = begin; meshIndex < end; ++meshIndex)
+            {
+                CollectSubmeshData(*scene->mMeshes[meshIndex], submeshes[meshIndex]);
+            }
+        };
+        if (m_jobSystem)
+        {
+            m_jobSystem->ParallelFor(0, scene->mNumMeshes, collectSubmeshes, 1, "CollectSubmeshData");
+        }
+        else
+        {
+            collectSubmeshes(0, scene->mNumMeshes);
+        }
+
+        // The texture loader creates the texture objects from the decoded data, when the materials are generated
+        for (size_t i = 0; i < textureRequests.size(); ++i)
+        {
+            m_jobSystem->Wait(textureJobs[i]);
+            m_textureLoader.AddDecodedData(textureRequests[i].path.c_str(), textureRequests[i].textureData);
+        }
+
+        // Materials generated for each material of the file, shared by all the meshes that use it
+        std::vector<std::shared_ptr<Material>> materials(scene->mNumMaterials);
+
+        // Create the GL objects in this thread
         model.SetMesh(std::make_shared<Mesh>());
         Mesh& mesh = model.GetMesh();
         for (unsigned int meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
         {
             aiMesh& meshData = *scene->mMeshes[meshIndex];
-            GenerateSubmesh(mesh, meshData);
+            GenerateSubmesh(mesh, submeshes[meshIndex]);
 
             std::shared_ptr<Material> material = m_referenceMaterial;
             if (m_createMaterials)
             {
-                // Create a new material with the material data
-                material = GenerateMaterial(*scene->mMaterials[meshData.mMaterialIndex]);
+                // Create a new material with the material data, the first time it is used
+                std::shared_ptr<Material>& generatedMaterial = materials[meshData.mMaterialIndex];
+                if (!generatedMaterial)
+                {
+                    generatedMaterial = GenerateMaterial(*scene->mMaterials[meshData.mMaterialIndex]);
+                }
+                material = generatedMaterial;
             }
             model.AddMaterial(material);
         }
@@ -107,36 +158,40 @@ Model ModelLoader::Load(const char* path)
     return model;
 }
 
-void ModelLoader::GenerateSubmesh(Mesh& mesh, const aiMesh& meshData)
+void ModelLoader::CollectSubmeshData(const aiMesh& meshData, SubmeshData& submeshData)
 {
     // Collect vertex data
-    VertexFormat vertexFormat;
     bool interleaved = true;
-    std::vector<GLubyte> vertexData = CollectVertexData(meshData, vertexFormat, interleaved);
-    int vboIndex = mesh.AddVertexData<GLubyte>(vertexData);
+    submeshData.vertexData = CollectVertexData(meshData, submeshData.vertexFormat, interleaved);
 
     // Collect element data
-    Data::Type elementType;
-    std::vector<Drawcall::Primitive> primitives;
-    std::vector<int> elementCounts;
-    std::vector<GLubyte> elementData = CollectElementData(meshData, elementType, primitives, elementCounts);
-    int eboIndex = mesh.AddElementData<GLubyte>(elementData);
+    submeshData.elementData = CollectElementData(meshData, submeshData.elementType, submeshData.primitives, submeshData.elementCounts);
+}
+
+void ModelLoader::GenerateSubmesh(Mesh& mesh, const SubmeshData& submeshData)
+{
+    bool interleaved = true;
+    const VertexFormat& vertexFormat = submeshData.vertexFormat;
+    int vboIndex = mesh.AddVertexData<GLubyte>(submeshData.vertexData);
+    int eboIndex = mesh.AddElementData<GLubyte>(submeshData.elementData);
 
     // Add submeshes
     int start = 0;
-    assert(primitives.size() == elementCounts.size());
-    for (int i = 0; i < primitives.size(); ++i)
+    assert(submeshData.primitives.size() == submeshData.elementCounts.size());
+    for (int i = 0; i < submeshData.primitives.size(); ++i)
     {
-        Drawcall::Primitive primitive = primitives[i];
-        int end = elementCounts[i];
-        mesh.AddSubmesh(primitive, start, end - start, elementType, eboIndex, vboIndex, vertexFormat.LayoutBegin(static_cast<int>(vertexData.size()), interleaved), vertexFormat.LayoutEnd(), m_materialAttributeMap);
+        Drawcall::Primitive primitive = submeshData.primitives[i];
+        int end = submeshData.elementCounts[i];
+        mesh.AddSubmesh(primitive, start, end - start, submeshData.elementType, eboIndex, vboIndex,
+            vertexFormat.LayoutBegin(static_cast<int>(submeshData.vertexData.size()), interleaved), vertexFormat.LayoutEnd(), m_materialAttributeMap);
         start = end;
     }
 }
 
 std::shared_ptr<Material> ModelLoader::GenerateMaterial(const aiMaterial& materialData)
 {
-    std::shared_ptr<Material> material = std::make_shared<Material>(*m_referenceMaterial);
+    // Instance of the reference material, it only stores the properties found in the material data
+    std::shared_ptr<Material> material = std::make_shared<MaterialInstance>(m_referenceMaterial);
     float value;
     for (auto& materialPropertyPair : m_materialPropertyMap)
     {
@@ -170,36 +225,107 @@ std::shared_ptr<Material> ModelLoader::GenerateMaterial(const aiMaterial& materi
             }
             break;
         case MaterialProperty::DiffuseTexture:
-            LoadTexture(materialData, aiTextureType_DIFFUSE, *material, location, TextureObject::FormatRGB, TextureObject::InternalFormatSRGB8);
-            break;
         case MaterialProperty::NormalTexture:
-            LoadTexture(materialData, aiTextureType_NORMALS, *material, location, TextureObject::FormatRGB, TextureObject::InternalFormatRGB8);
-            break;
         case MaterialProperty::SpecularTexture:
-            LoadTexture(materialData, aiTextureType_SHININESS, *material, location, TextureObject::FormatRGB, TextureObject::InternalFormatSRGB8);
+            {
+                int textureType;
+                TextureObject::Format format;
+                TextureObject::InternalFormat internalFormat;
+                GetTextureProperty(materialProperty, textureType, format, internalFormat);
+                LoadTexture(materialData, textureType, *material, location, format, internalFormat);
+            }
             break;
         }
     }
     return material;
 }
 
-void ModelLoader::LoadTexture(const aiMaterial& materialData, int textureTypeValue, Material& material, ShaderProgram::Location location,
+void ModelLoader::CollectTextureRequests(const aiScene& scene, std::vector<TextureRequest>& textureRequests) const
+{
+    // Only the materials used by some mesh
+    std::vector<bool> usedMaterials(scene.mNumMaterials, false);
+    for (unsigned int meshIndex = 0; meshIndex < scene.mNumMeshes; ++meshIndex)
+    {
+        usedMaterials[scene.mMeshes[meshIndex]->mMaterialIndex] = true;
+    }
+
+    for (unsigned int materialIndex = 0; materialIndex < scene.mNumMaterials; ++materialIndex)
+    {
+        if (!usedMaterials[materialIndex])
+            continue;
+
+        for (auto& materialPropertyPair : m_materialPropertyMap)
+        {
+            TextureRequest textureRequest;
+            int textureType;
+            if (!GetTextureProperty(materialPropertyPair.first, textureType, textureRequest.format, textureRequest.internalFormat) ||
+                !GetTexturePath(*scene.mMaterials[materialIndex], textureType, textureRequest.path) ||
+                m_textureLoader.HasShared(textureRequest.path.c_str()))
+                continue;
+
+            auto itTextureRequest = std::find_if(textureRequests.begin(), textureRequests.end(),
+                [&](const TextureRequest& other) { return other.path == textureRequest.path; });
+            if (itTextureRequest == textureRequests.end())
+            {
+                textureRequests.push_back(textureRequest);
+            }
+        }
+    }
+}
+
+void ModelLoader::LoadTexture(const aiMaterial& materialData, int textureType, Material& material, ShaderProgram::Location location,
     TextureObject::Format format, TextureObject::InternalFormat internalFormat) const
+{
+    std::string texturePath;
+    if (GetTexturePath(materialData, textureType, texturePath))
+    {
+        m_textureLoader.SetFormat(format);
+        m_textureLoader.SetInternalFormat(internalFormat);
+        std::shared_ptr<Texture2DObject> texture = m_textureLoader.LoadShared(texturePath.c_str());
+        material.SetUniformValue(location, texture);
+        material.SetTextureSampler(location, m_textureSampler);
+    }
+}
+
+bool ModelLoader::GetTexturePath(const aiMaterial& materialData, int textureTypeValue, std::string& texturePath) const
 {
     aiTextureType textureType = static_cast<aiTextureType>(textureTypeValue);
     if (materialData.GetTextureCount(textureType) > 0)
     {
         assert(materialData.GetTextureCount(textureType) == 1);
-        aiString texturePath;
-        if (materialData.GetTexture(textureType, 0, &texturePath) == aiReturn_SUCCESS)
+        aiString textureFile;
+        if (materialData.GetTexture(textureType, 0, &textureFile) == aiReturn_SUCCESS)
         {
-            texturePath = m_baseFolder + texturePath.C_Str();
-            m_textureLoader.SetFormat(format);
-            m_textureLoader.SetInternalFormat(internalFormat);
-            std::shared_ptr<Texture2DObject> texture = m_textureLoader.LoadShared(texturePath.C_Str());
-            material.SetUniformValue(location, texture);
+            texturePath = m_baseFolder + textureFile.C_Str();
+            return true;
         }
     }
+    return false;
+}
+
+bool ModelLoader::GetTextureProperty(MaterialProperty materialProperty, int& textureType,
+    TextureObject::Format& format, TextureObject::InternalFormat& internalFormat)
+{
+    switch (materialProperty)
+    {
+    case MaterialProperty::DiffuseTexture:
+        textureType = aiTextureType_DIFFUSE;
+        format = TextureObject::FormatRGB;
+        internalFormat = TextureObject::InternalFormatSRGB8;
+        return true;
+    case MaterialProperty::NormalTexture:
+        textureType = aiTextureType_NORMALS;
+        format = TextureObject::FormatRGB;
+        internalFormat = TextureObject::InternalFormatRGB8;
+        return true;
+    case MaterialProperty::SpecularTexture:
+        textureType = aiTextureType_SHININESS;
+        format = TextureObject::FormatRGB;
+        internalFormat = TextureObject::InternalFormatSRGB8;
+        return true;
+    default:
+        return false;
+    }
 }
 
 std::vector<GLubyte> ModelLoader::CollectVertexData(const aiMesh& meshData, VertexFormat& vertexFormat, bool interleaved)
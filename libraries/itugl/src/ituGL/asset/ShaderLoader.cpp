@@ -1,13 +1,12 @@
 #include <ituGL/asset/ShaderLoader.h>
 
-#include <fstream>
-#include <sstream>
-#include <vector>
 #include <array>
 #include <cassert>
 
 #include <iostream>
 
+ShaderPreprocessor ShaderLoader::s_preprocessor;
+
 ShaderLoader::ShaderLoader(Shader::Type type) : m_type(type)
 {
 }
@@ -22,37 +21,40 @@ bool ShaderLoader::IsValid(std::span<const char*> paths)
     return valid;
 }
 
+// Single file is loaded as a list of one file
 Shader ShaderLoader::Load(const char* path)
 {
-    Shader shader(m_type);
-    std::ifstream file(path);
-    assert(file.is_open());
-    std::stringstream stringStream;
-    stringStream << file.rdbuf() << '\0';
-    shader.SetSource(stringStream.str().c_str());
-    Compile(shader);
-    return shader;
+    return Load(std::span(&path, 1));
 }
 
 Shader ShaderLoader::Load(std::span<const char*> paths)
+{
+    ShaderPreprocessor::Source source;
+    [[maybe_unused]] bool read = ReadSource(paths, source);
+    assert(read);
+    return LoadFromSource(source);
+}
+
+Shader ShaderLoader::LoadFromSource(const ShaderPreprocessor::Source& source)
+{
+    Shader shader = StartLoadFromSource(source);
+    CheckCompilation(shader, source.files);
+    return shader;
+}
+
+Shader ShaderLoader::StartLoadFromSource(const ShaderPreprocessor::Source& source)
 {
     Shader shader(m_type);
-    std::vector<std::stringstream> stringStreams(paths.size());
-    std::vector<std::string> sourceCodeStrings(paths.size());
-    std::vector<const char*> sourceCode(paths.size());
-    for (int i = 0; i < paths.size(); ++i)
-    {
-        std::ifstream file(paths[i]);
-        assert(file.is_open());
-        stringStreams[i] << file.rdbuf() << '\0';
-        sourceCodeStrings[i] = stringStreams[i].str();
-        sourceCode[i] = sourceCodeStrings[i].c_str();
-    }
-    shader.SetSource(sourceCode);
-    Compile(shader);
+    shader.SetSource(source.code.c_str());
+    shader.StartCompile();
     return shader;
 }
 
+bool ShaderLoader::ReadSource(std::span<const char*> paths, ShaderPreprocessor::Source& source)
+{
+    return s_preprocessor.Process(paths, source);
+}
+
 Shader* ShaderLoader::LoadNew(std::span<const char*> paths)
 {
     Shader* shader = nullptr;
@@ -73,9 +75,10 @@ bool ShaderLoader::LoadInto(Shader& shader, std::span<const char*> paths)
     return valid;
 }
 
-void ShaderLoader::Compile(Shader& shader)
+bool ShaderLoader::CheckCompilation(const Shader& shader, std::span<const std::string> files)
 {
-    if (!shader.Compile())
+    bool compiled = shader.IsCompiled();
+    if (!compiled)
     {
         std::array<char, 512> infoLog;
         shader.GetCompilationErrors(infoLog);
@@ -103,7 +106,14 @@ void ShaderLoader::Compile(Shader& shader)
             break;
         }
         std::cout << "ERROR::SHADER::" << typeName << "::COMPILATION_FAILED\n" << infoLog.data() << std::endl;
+
+        // Errors refer to the files by number, set by the #line directives of the preprocessor
+        for (int i = 0; i < files.size(); ++i)
+        {
+            std::cout << i << ": " << files[i] << std::endl;
+        }
     }
+    return compiled;
 }
 
 Shader ShaderLoader::Load(Shader::Type type, const char* path)
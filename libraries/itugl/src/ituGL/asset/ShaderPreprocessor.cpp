@@ -0,0 +1,155 @@
+#include <ituGL/asset/ShaderPreprocessor.h>
+
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include <cstring>
+
+#include <iostream>
+
+ShaderPreprocessor::ShaderPreprocessor()
+{
+}
+
+bool ShaderPreprocessor::Process(std::span<const char*> paths, Source& source)
+{
+    source.code.clear();
+    source.files.clear();
+
+    std::unordered_set<std::string> includedFiles;
+    for (const char* path : paths)
+    {
+        std::string normalizedPath = std::filesystem::path(path).lexically_normal().generic_string();
+        if (includedFiles.insert(normalizedPath).second)
+        {
+            if (!ProcessFile(normalizedPath, source, includedFiles))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ShaderPreprocessor::ClearFileCache()
+{
+    m_files.clear();
+}
+
+bool ShaderPreprocessor::ProcessFile(const std::filesystem::path& path, Source& source, std::unordered_set<std::string>& includedFiles)
+{
+    const std::string* contents = GetFileContents(path.generic_string());
+    if (!contents)
+    {
+        std::cout << "ERROR::SHADER::FILE_NOT_FOUND\n" << path.generic_string() << std::endl;
+        return false;
+    }
+
+    // Number of this file in the #line directives
+    unsigned int fileNumber = static_cast<unsigned int>(source.files.size());
+    source.files.push_back(path.generic_string());
+
+    // Nothing but comments can go before #version, so the first #line is added after it
+    bool needsLine = contents->find("#version") == std::string::npos;
+
+    std::istringstream stream(*contents);
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(stream, line))
+    {
+        ++lineNumber;
+
+        std::string includePath;
+        if (IsDirective(line, "#version"))
+        {
+            source.code += line;
+            source.code += '\n';
+            needsLine = true;
+        }
+        else if (IsDirective(line, "#pragma once"))
+        {
+            // All files are included once already
+            source.code += '\n';
+        }
+        else if (ParseInclude(line, includePath))
+        {
+            std::filesystem::path resolvedPath = ResolveInclude(path, includePath);
+            if (includedFiles.insert(resolvedPath.generic_string()).second)
+            {
+                if (!ProcessFile(resolvedPath, source, includedFiles))
+                {
+                    return false;
+                }
+            }
+            // Line numbers continue from the next line
+            needsLine = true;
+        }
+        else
+        {
+            if (needsLine)
+            {
+                source.code += "#line " + std::to_string(lineNumber) + " " + std::to_string(fileNumber) + "\n";
+                needsLine = false;
+            }
+            source.code += line;
+            source.code += '\n';
+        }
+    }
+    return true;
+}
+
+const std::string* ShaderPreprocessor::GetFileContents(const std::string& path)
+{
+    auto itFile = m_files.find(path);
+    if (itFile != m_files.end())
+    {
+        return &itFile->second;
+    }
+
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        return nullptr;
+    }
+    std::stringstream stringStream;
+    stringStream << file.rdbuf();
+    return &m_files.emplace(path, stringStream.str()).first->second;
+}
+
+std::filesystem::path ShaderPreprocessor::ResolveInclude(const std::filesystem::path& includingPath, const std::string& includePath)
+{
+    std::filesystem::path relativePath = (includingPath.parent_path() / includePath).lexically_normal();
+    std::error_code error;
+    if (std::filesystem::exists(relativePath, error))
+    {
+        return relativePath;
+    }
+    return std::filesystem::path(includePath).lexically_normal();
+}
+
+bool ShaderPreprocessor::ParseInclude(const std::string& line, std::string& includePath)
+{
+    if (!IsDirective(line, "#include"))
+    {
+        return false;
+    }
+
+    size_t begin = line.find('"');
+    size_t end = begin != std::string::npos ? line.find('"', begin + 1) : std::string::npos;
+    if (end == std::string::npos)
+    {
+        return false;
+    }
+    includePath = line.substr(begin + 1, end - begin - 1);
+    return true;
+}
+
+bool ShaderPreprocessor::IsDirective(const std::string& line, const char* directive)
+{
+    size_t start = 0;
+    while (start < line.size() && std::isspace(static_cast<unsigned char>(line[start])))
+    {
+        ++start;
+    }
+    return line.compare(start, std::strlen(directive), directive) == 0;
+}
@@ -0,0 +1,345 @@
+#include <ituGL/asset/ShaderProgramCache.h>
+
+#include <ituGL/asset/ShaderLoader.h>
+#include <ituGL/shader/ShaderProgram.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <array>
+#include <algorithm>
+#include <cassert>
+
+#include <iostream>
+
+// Header stored before the binary, to reject files that are not valid for this key
+struct BinaryHeader
+{
+    unsigned int magic;
+    unsigned int binaryFormat;
+    unsigned long long key;
+    unsigned long long binarySize;
+};
+
+static constexpr unsigned int s_binaryMagic = 0x42505449; // "ITPB"
+
+ShaderProgramCache::ShaderProgramCache(const std::filesystem::path& directory)
+    : m_directory(directory), m_enabled(true), m_batchOpen(false)
+{
+}
+
+ShaderProgramCache::~ShaderProgramCache()
+{
+    // Programs would be left unchecked
+    assert(m_pendingPrograms.empty());
+    assert(m_asyncPrograms.empty());
+}
+
+bool ShaderProgramCache::Build(ShaderProgram& shaderProgram, std::span<const Stage> stages, std::span<const std::string> defines, bool separable)
+{
+    PendingProgram pendingProgram;
+    if (!Submit(shaderProgram, stages, defines, separable, pendingProgram))
+    {
+        return false;
+    }
+
+    // Loaded from the cache
+    if (pendingProgram.shaders.empty())
+    {
+        return true;
+    }
+
+    if (m_batchOpen)
+    {
+        m_pendingPrograms.push_back(std::move(pendingProgram));
+        return true;
+    }
+    return FinishBuild(pendingProgram);
+}
+
+void ShaderProgramCache::BeginBatch()
+{
+    assert(!m_batchOpen);
+    m_batchOpen = true;
+}
+
+bool ShaderProgramCache::EndBatch()
+{
+    assert(m_batchOpen);
+    m_batchOpen = false;
+
+    // Everything was submitted already, the driver had time to compile them in parallel while we waited for the first ones
+    bool linked = true;
+    for (PendingProgram& pendingProgram : m_pendingPrograms)
+    {
+        linked &= FinishBuild(pendingProgram);
+    }
+    m_pendingPrograms.clear();
+    return linked;
+}
+
+bool ShaderProgramCache::BuildAsync(ShaderProgram& shaderProgram, std::span<const Stage> stages, std::span<const std::string> defines, bool separable)
+{
+    PendingProgram pendingProgram;
+    if (!Submit(shaderProgram, stages, defines, separable, pendingProgram))
+    {
+        return false;
+    }
+
+    // Programs loaded from the cache are finished already
+    if (!pendingProgram.shaders.empty())
+    {
+        m_asyncPrograms.push_back(std::move(pendingProgram));
+    }
+    return true;
+}
+
+bool ShaderProgramCache::PollAsync(ShaderProgram& shaderProgram)
+{
+    auto itProgram = std::find_if(m_asyncPrograms.begin(), m_asyncPrograms.end(),
+        [&](const PendingProgram& pendingProgram) { return pendingProgram.shaderProgram == &shaderProgram; });
+    if (itProgram == m_asyncPrograms.end())
+    {
+        return true;
+    }
+
+    // Without parallel compilation, it is always completed, and checking the link waits for it
+    if (!shaderProgram.IsLinkCompleted())
+    {
+        return false;
+    }
+
+    FinishBuild(*itProgram);
+    m_asyncPrograms.erase(itProgram);
+    return true;
+}
+
+void ShaderProgramCache::CancelAsync(const ShaderProgram& shaderProgram)
+{
+    std::erase_if(m_asyncPrograms, [&](const PendingProgram& pendingProgram) { return pendingProgram.shaderProgram == &shaderProgram; });
+}
+
+void ShaderProgramCache::Clear()
+{
+    std::error_code error;
+    std::filesystem::remove_all(m_directory, error);
+}
+
+bool ShaderProgramCache::Submit(ShaderProgram& shaderProgram, std::span<const Stage> stages, std::span<const std::string> defines, bool separable, PendingProgram& pendingProgram)
+{
+    std::string defineSource;
+    for (const std::string& define : defines)
+    {
+        defineSource += "#define " + define + "\n";
+    }
+
+    // Files already read by other programs are not read again
+    std::vector<ShaderPreprocessor::Source> sources(stages.size());
+    for (size_t i = 0; i < stages.size(); ++i)
+    {
+        if (!ShaderLoader::ReadSource(stages[i].paths, sources[i]))
+        {
+            return false;
+        }
+        if (!defineSource.empty())
+        {
+            InsertDefines(sources[i].code, defineSource);
+        }
+    }
+
+    // Separable state is needed before linking or loading the binary
+    if (separable)
+    {
+        shaderProgram.SetSeparable(true);
+    }
+
+    pendingProgram = { &shaderProgram, {}, {}, 0, m_enabled };
+    if (m_enabled)
+    {
+        pendingProgram.key = ComputeKey(stages, sources, separable);
+        if (LoadBinary(shaderProgram, pendingProgram.key))
+        {
+            ++m_stats.hitCount;
+            return true;
+        }
+
+        // Not in the cache, or rejected by the driver. Build it and store it for the next time
+        ++m_stats.missCount;
+    }
+
+    StartBuild(pendingProgram, stages, sources);
+    return true;
+}
+
+// FNV-1a 64 bits hash of the preprocessed sources, so it only changes if the content does
+unsigned long long ShaderProgramCache::ComputeKey(std::span<const Stage> stages, std::span<const ShaderPreprocessor::Source> sources, bool separable) const
+{
+    unsigned long long hash = 14695981039346656037ull;
+    auto combine = [&hash](const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    const std::string& driverString = GetDriverString();
+    combine(driverString.data(), driverString.size());
+    combine(&separable, sizeof(separable));
+
+    for (size_t i = 0; i < stages.size(); ++i)
+    {
+        GLenum type = stages[i].type;
+        combine(&type, sizeof(type));
+        const std::string& code = sources[i].code;
+        size_t size = code.size();
+        combine(&size, sizeof(size));
+        combine(code.data(), size);
+    }
+
+    return hash;
+}
+
+std::filesystem::path ShaderProgramCache::GetBinaryPath(unsigned long long key) const
+{
+    std::stringstream fileName;
+    fileName << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return m_directory / fileName.str();
+}
+
+bool ShaderProgramCache::LoadBinary(ShaderProgram& shaderProgram, unsigned long long key) const
+{
+    std::ifstream file(GetBinaryPath(key), std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    BinaryHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != s_binaryMagic || header.key != key)
+    {
+        return false;
+    }
+
+    // The driver could have been changed to one that doesn't support this format
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    std::vector<GLint> formats(formatCount);
+    if (formatCount > 0)
+    {
+        glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+    }
+    if (std::find(formats.begin(), formats.end(), static_cast<GLint>(header.binaryFormat)) == formats.end())
+    {
+        return false;
+    }
+
+    std::vector<std::byte> binary(header.binarySize);
+    if (!file.read(reinterpret_cast<char*>(binary.data()), binary.size()))
+    {
+        return false;
+    }
+
+    return shaderProgram.LoadBinary(header.binaryFormat, binary);
+}
+
+void ShaderProgramCache::SaveBinary(const ShaderProgram& shaderProgram, unsigned long long key) const
+{
+    // Drivers without binary formats return an empty binary
+    BinaryHeader header = { s_binaryMagic, 0, key, 0 };
+    std::vector<std::byte> binary;
+    GLenum binaryFormat = 0;
+    if (!shaderProgram.GetBinary(binaryFormat, binary))
+    {
+        return;
+    }
+    header.binaryFormat = binaryFormat;
+    header.binarySize = binary.size();
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+
+    std::ofstream file(GetBinaryPath(key), std::ios::binary | std::ios::trunc);
+    if (file.is_open())
+    {
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+    }
+}
+
+void ShaderProgramCache::InsertDefines(std::string& code, const std::string& defineSource)
+{
+    size_t versionPosition = code.find("#version");
+    if (versionPosition == std::string::npos)
+    {
+        code.insert(0, defineSource);
+        return;
+    }
+
+    // Right after the end of the #version line. The preprocessor adds a #line after it, so the line numbers are kept
+    size_t lineEnd = code.find('\n', versionPosition);
+    if (lineEnd == std::string::npos)
+    {
+        code += '\n';
+        lineEnd = code.size() - 1;
+    }
+    code.insert(lineEnd + 1, defineSource);
+}
+
+void ShaderProgramCache::StartBuild(PendingProgram& pendingProgram, std::span<const Stage> stages, std::span<const ShaderPreprocessor::Source> sources)
+{
+    pendingProgram.shaders.reserve(stages.size());
+    pendingProgram.files.reserve(stages.size());
+    for (size_t i = 0; i < stages.size(); ++i)
+    {
+        pendingProgram.shaders.push_back(ShaderLoader(stages[i].type).StartLoadFromSource(sources[i]));
+        pendingProgram.files.push_back(sources[i].files);
+    }
+
+    if (pendingProgram.saveBinary)
+    {
+        pendingProgram.shaderProgram->SetBinaryRetrievable(true);
+    }
+    pendingProgram.shaderProgram->StartBuild(pendingProgram.shaders);
+}
+
+bool ShaderProgramCache::FinishBuild(PendingProgram& pendingProgram) const
+{
+    ShaderProgram& shaderProgram = *pendingProgram.shaderProgram;
+    bool linked = shaderProgram.IsLinked();
+    if (linked)
+    {
+        if (pendingProgram.saveBinary)
+        {
+            SaveBinary(shaderProgram, pendingProgram.key);
+        }
+    }
+    else
+    {
+        // Compilation errors are only checked now, the link fails if any shader didn't compile
+        for (size_t i = 0; i < pendingProgram.shaders.size(); ++i)
+        {
+            ShaderLoader::CheckCompilation(pendingProgram.shaders[i], pendingProgram.files[i]);
+        }
+
+        std::array<char, 512> infoLog;
+        shaderProgram.GetLinkingErrors(infoLog);
+        std::cout << "ERROR::PROGRAM::LINKING_FAILED\n" << infoLog.data() << std::endl;
+    }
+    return linked;
+}
+
+const std::string& ShaderProgramCache::GetDriverString() const
+{
+    if (m_driverString.empty())
+    {
+        for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION })
+        {
+            const GLubyte* value = glGetString(name);
+            m_driverString += value ? reinterpret_cast<const char*>(value) : "";
+            m_driverString += '\n';
+        }
+    }
+    return m_driverString;
+}
@@ -0,0 +1,57 @@
+#include <ituGL/asset/ShaderVariantCache.h>
+
+#include <ituGL/shader/ShaderProgram.h>
+#include <vector>
+
+ShaderVariantCache::ShaderVariantCache(ShaderProgramCache& shaderProgramCache) : m_shaderProgramCache(shaderProgramCache)
+{
+}
+
+std::shared_ptr<ShaderProgram> ShaderVariantCache::GetShaderProgram(std::span<const ShaderProgramCache::Stage> stages, const KeywordSet& keywords)
+{
+    std::string key = GetVariantKey(stages, keywords);
+    auto itVariant = m_variants.find(key);
+    if (itVariant != m_variants.end())
+    {
+        return itVariant->second;
+    }
+
+    // First time this variant is requested
+    std::vector<std::string> defines(keywords.begin(), keywords.end());
+    std::shared_ptr<ShaderProgram> shaderProgram = std::make_shared<ShaderProgram>();
+    if (!m_shaderProgramCache.Build(*shaderProgram, stages, defines))
+    {
+        return nullptr;
+    }
+
+    m_variants.emplace(std::move(key), shaderProgram);
+    return shaderProgram;
+}
+
+void ShaderVariantCache::Clear()
+{
+    m_variants.clear();
+}
+
+std::string ShaderVariantCache::GetVariantKey(std::span<const ShaderProgramCache::Stage> stages, const KeywordSet& keywords)
+{
+    // Paths and keywords can't contain new lines, so they are used as separators
+    std::string key;
+    for (const ShaderProgramCache::Stage& stage : stages)
+    {
+        key += std::to_string(stage.type);
+        key += '\n';
+        for (const char* path : stage.paths)
+        {
+            key += path;
+            key += '\n';
+        }
+    }
+    key += '\n';
+    for (const std::string& keyword : keywords)
+    {
+        key += keyword;
+        key += '\n';
+    }
+    return key;
+}
@@ -1,5 +1,6 @@
 #include <ituGL/asset/Texture2DLoader.h>
 
+#include <ituGL/core/DeviceGL.h>
 #include <cassert>
 
 Texture2DLoader::Texture2DLoader()
@@ -13,21 +14,49 @@ Texture2DLoader::Texture2DLoader(TextureObject::Format format, TextureObject::In
 {
 }
 
+Texture2DLoader::~Texture2DLoader()
+{
+    // Free the decoded data that was never loaded
+    for (auto& decodedDataPair : m_decodedData)
+    {
+        FreeData(decodedDataPair.second);
+    }
+}
+
 Texture2DObject Texture2DLoader::Load(const char* path)
 {
     Texture2DObject texture2D;
 
-    // Load texture data using stbimage library
-    int width, height;
-    Data::Type dataType;
-    std::span<const std::byte> data = LoadTexture2DData(path, width, height, dataType, m_flipVertical);
+    // Use the data decoded in advance, if any. Otherwise, load texture data using stbimage library
+    TextureData textureData;
+    auto itDecodedData = m_decodedData.find(path);
+    if (itDecodedData != m_decodedData.end() && itDecodedData->second.format == m_format && itDecodedData->second.internalFormat == m_internalFormat)
+    {
+        textureData = itDecodedData->second;
+        m_decodedData.erase(itDecodedData);
+    }
+    else
+    {
+        textureData = LoadData(path, m_format, m_internalFormat);
+    }
 
     // If data was loaded, copy it to the texture object
-    assert(!data.empty());
-    if (!data.empty())
+    assert(!textureData.data.empty());
+    if (!textureData.data.empty())
     {
-        texture2D.Bind();
-        texture2D.SetImage<std::byte>(0, width, height, m_format, m_internalFormat, data, dataType);
+        // With Direct State Access, the texture is set up without binding it
+        bool bindToEdit = !DeviceGL::IsDirectStateAccessEnabled();
+        if (bindToEdit)
+        {
+            texture2D.Bind();
+        }
+
+        // Immutable storage, with space for the whole mipmap chain if needed
+        int width = textureData.width;
+        int height = textureData.height;
+        int levelCount = m_generateMipmap ? TextureObject::GetMipmapLevelCount(width, height) : 1;
+        texture2D.SetStorage(levelCount, width, height, textureData.internalFormat);
+        texture2D.SetSubImage<std::byte>(0, 0, 0, width, height, textureData.format, textureData.data, textureData.dataType);
 
         texture2D.SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR);
         texture2D.SetParameter(TextureObject::ParameterEnum::MagFilter, GL_LINEAR);
@@ -44,14 +73,51 @@ Texture2DObject Texture2DLoader::Load(const char* path)
             texture2D.SetParameter(TextureObject::ParameterFloat::MaxLod, maxLod);
         }
 
-        texture2D.Unbind();
+        if (bindToEdit)
+        {
+            texture2D.Unbind();
+        }
 
         // Free loaded data (not needed anymore)
-        FreeTexture2DData(data);
+        FreeData(textureData);
     }
     return texture2D;
 }
 
+Texture2DLoader::TextureData Texture2DLoader::LoadData(const char* path, TextureObject::Format format, TextureObject::InternalFormat internalFormat) const
+{
+    TextureData textureData;
+    textureData.format = format;
+    textureData.internalFormat = internalFormat;
+    textureData.data = TextureLoaderUtils::LoadTexture2DData(path, textureData.width, textureData.height, textureData.dataType,
+        format, internalFormat, m_flipVertical);
+    return textureData;
+}
+
+void Texture2DLoader::FreeData(TextureData& textureData)
+{
+    if (!textureData.data.empty())
+    {
+        TextureLoaderUtils::FreeTexture2DData(textureData.data);
+        textureData.data = std::span<const std::byte>();
+    }
+}
+
+void Texture2DLoader::AddDecodedData(const char* path, const TextureData& textureData)
+{
+    // Replace the previous data, if any
+    auto itDecodedData = m_decodedData.find(path);
+    if (itDecodedData != m_decodedData.end())
+    {
+        FreeData(itDecodedData->second);
+        itDecodedData->second = textureData;
+    }
+    else
+    {
+        m_decodedData.insert(std::make_pair(std::string(path), textureData));
+    }
+}
+
 std::shared_ptr<Texture2DObject> Texture2DLoader::LoadTextureShared(const char* path,
     TextureObject::Format format, TextureObject::InternalFormat internalFormat, bool generateMipmap, bool flipVertical)
 {
@@ -1,18 +1,31 @@
 #include <ituGL/core/BufferObject.h>
 
+#include <ituGL/core/DeviceGL.h>
 #include <cassert>
 
 // Create the object initially null, get object handle and generate 1 buffer
 BufferObject::BufferObject() : Object(NullHandle)
 {
     Handle& handle = GetHandle();
-    glGenBuffers(1, &handle);
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        // DSA functions need the buffer to exist, not just the name that glGenBuffers reserves until the first bind
+        glCreateBuffers(1, &handle);
+    }
+    else
+    {
+        glGenBuffers(1, &handle);
+    }
 }
 
 // Get object handle and delete 1 buffer
 BufferObject::~BufferObject()
 {
     Handle& handle = GetHandle();
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->OnBufferDeleted(handle);
+    }
     glDeleteBuffers(1, &handle);
 }
 
@@ -40,26 +53,121 @@ void BufferObject::Unbind(Target target)
     glBindBuffer(target, handle);
 }
 
+#ifndef NDEBUG
+bool BufferObject::IsReadyToEdit() const
+{
+    return DeviceGL::IsDirectStateAccessEnabled() || IsBound();
+}
+#endif
+
 // Get buffer Target and allocate buffer data
 void BufferObject::AllocateData(size_t size, Usage usage)
 {
-    assert(IsBound());
-    Target target = GetTarget();
-    glBufferData(target, size, nullptr, usage);
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glNamedBufferData(GetHandle(), size, nullptr, usage);
+    }
+    else
+    {
+        glBufferData(GetTarget(), size, nullptr, usage);
+    }
 }
 
 // Get buffer Target and allocate buffer data
 void BufferObject::AllocateData(std::span<const std::byte> data, Usage usage)
 {
-    assert(IsBound());
-    Target target = GetTarget();
-    glBufferData(target, data.size_bytes(), data.data(), usage);
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glNamedBufferData(GetHandle(), data.size_bytes(), data.data(), usage);
+    }
+    else
+    {
+        glBufferData(GetTarget(), data.size_bytes(), data.data(), usage);
+    }
+}
+
+// Allocate immutable storage, without initial contents
+void BufferObject::AllocateStorage(size_t size, GLbitfield flags)
+{
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glNamedBufferStorage(GetHandle(), size, nullptr, flags);
+    }
+    else
+    {
+        glBufferData(GetTarget(), size, nullptr, GetFallbackUsage(flags));
+    }
+}
+
+// Allocate immutable storage, with initial contents
+void BufferObject::AllocateStorage(std::span<const std::byte> data, GLbitfield flags)
+{
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glNamedBufferStorage(GetHandle(), data.size_bytes(), data.data(), flags);
+    }
+    else
+    {
+        glBufferData(GetTarget(), data.size_bytes(), data.data(), GetFallbackUsage(flags));
+    }
+}
+
+// The fallback storage stays mutable, but we can hint that it is used in the same way
+BufferObject::Usage BufferObject::GetFallbackUsage(GLbitfield flags)
+{
+    if (flags & MapReadStorage)
+    {
+        return Usage::StreamRead;
+    }
+    else if (flags & (DynamicStorage | MapWriteStorage))
+    {
+        return Usage::DynamicDraw;
+    }
+    return Usage::StaticDraw;
 }
 
 // Get buffer Target and set buffer subdata
 void BufferObject::UpdateData(std::span<const std::byte> data, size_t offset)
 {
-    assert(IsBound());
-    Target target = GetTarget();
-    glBufferSubData(target, offset, data.size_bytes(), data.data());
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glNamedBufferSubData(GetHandle(), offset, data.size_bytes(), data.data());
+    }
+    else
+    {
+        glBufferSubData(GetTarget(), offset, data.size_bytes(), data.data());
+    }
+}
+
+// Get buffer Target and map the range
+void* BufferObject::MapRange(size_t offset, size_t size, GLbitfield access)
+{
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        return glMapNamedBufferRange(GetHandle(), offset, size, access);
+    }
+    else
+    {
+        return glMapBufferRange(GetTarget(), offset, size, access);
+    }
+}
+
+// Get buffer Target and unmap it
+bool BufferObject::Unmap()
+{
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        return glUnmapNamedBuffer(GetHandle()) == GL_TRUE;
+    }
+    else
+    {
+        return glUnmapBuffer(GetTarget()) == GL_TRUE;
+    }
 }
@@ -6,10 +6,20 @@
 
 DeviceGL* DeviceGL::m_instance = nullptr;
 
-DeviceGL::DeviceGL() : m_contextLoaded(false)
+bool DeviceGL::s_directStateAccessEnabled = false;
+
+bool DeviceGL::s_parallelShaderCompileSupported = false;
+
+DeviceGL::MaxShaderCompilerThreadsFunction DeviceGL::s_maxShaderCompilerThreads = nullptr;
+
+static const unsigned long long NoPendingViewport = ~0ull;
+
+DeviceGL::DeviceGL() : m_contextLoaded(false), m_activeTextureUnit(UnknownBinding), m_pendingViewport(NoPendingViewport)
 {
     m_instance = this;
 
+    InvalidateBindingCache();
+
     // Init GLFW
     glfwInit();
 }
@@ -35,6 +45,23 @@ void DeviceGL::SetCurrentWindow(Window& window)
     {
         // Set callback to be called when the window is resized
         glfwSetFramebufferSizeCallback(glfwWindow, FrameBufferResized);
+
+        // Use DSA whenever the context supports it
+        SetDirectStateAccessEnabled(true);
+
+        // Load the parallel shader compile extension. The KHR and ARB versions are the same, with different suffix
+        if (glfwExtensionSupported("GL_KHR_parallel_shader_compile"))
+        {
+            s_maxShaderCompilerThreads = (MaxShaderCompilerThreadsFunction)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+        }
+        else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+        {
+            s_maxShaderCompilerThreads = (MaxShaderCompilerThreadsFunction)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+        }
+        s_parallelShaderCompileSupported = s_maxShaderCompilerThreads != nullptr;
+
+        // Let the driver use as many compiler threads as it wants
+        SetMaxShaderCompilerThreads(~0u);
     }
 }
 
@@ -55,6 +82,21 @@ void DeviceGL::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
     glViewport(0, 0, width, height);
 }
 
+// Apply the viewport of a resize that happened while the context was current in another thread
+void DeviceGL::ApplyPendingViewport()
+{
+    unsigned long long pendingViewport = m_pendingViewport.exchange(NoPendingViewport);
+    if (pendingViewport != NoPendingViewport)
+    {
+        SetViewport(0, 0, static_cast<GLsizei>(pendingViewport >> 32), static_cast<GLsizei>(pendingViewport & 0xFFFFFFFF));
+    }
+}
+
+bool DeviceGL::IsContextCurrent()
+{
+    return glfwGetCurrentContext() != nullptr;
+}
+
 // Poll the events in the window event queue
 void DeviceGL::PollEvents()
 {
@@ -66,8 +108,16 @@ void DeviceGL::FrameBufferResized(GLFWwindow* window, GLsizei width, GLsizei hei
 {
     if (m_instance)
     {
-        // Adjust the viewport when the framebuffer is resized
-        m_instance->SetViewport(0, 0, width, height);
+        if (glfwGetCurrentContext() == window)
+        {
+            // Adjust the viewport when the framebuffer is resized
+            m_instance->SetViewport(0, 0, width, height);
+        }
+        else
+        {
+            // The context is owned by a render thread, let it apply the viewport before the next frame
+            m_instance->m_pendingViewport = (static_cast<unsigned long long>(width) << 32) | static_cast<unsigned int>(height);
+        }
     }
 }
 
@@ -123,3 +173,193 @@ void DeviceGL::SetVSyncEnabled(bool enabled)
 {
     glfwSwapInterval(enabled ? 1 : 0);
 }
+
+// Check if the context supports Direct State Access
+bool DeviceGL::IsDirectStateAccessSupported() const
+{
+    return m_contextLoaded && GLAD_GL_VERSION_4_5;
+}
+
+// Enable / disable the Direct State Access path. It can't be enabled if not supported
+void DeviceGL::SetDirectStateAccessEnabled(bool enabled)
+{
+    s_directStateAccessEnabled = enabled && IsDirectStateAccessSupported();
+}
+
+void DeviceGL::SetMaxShaderCompilerThreads(GLuint count)
+{
+    if (s_maxShaderCompilerThreads)
+    {
+        s_maxShaderCompilerThreads(count);
+    }
+}
+
+void DeviceGL::SetActiveTextureUnit(GLuint textureUnit)
+{
+    if (m_activeTextureUnit == textureUnit)
+    {
+        m_bindingStats.elidedActiveTextureCount++;
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    m_activeTextureUnit = textureUnit;
+    m_bindingStats.activeTextureCount++;
+}
+
+void DeviceGL::BindTexture(GLuint textureUnit, GLenum target, GLuint texture)
+{
+    int targetIndex = GetTextureTargetIndex(target);
+    bool cached = textureUnit < CachedTextureUnitCount && targetIndex >= 0;
+    if (cached && m_boundTextures[textureUnit][targetIndex] == texture)
+    {
+        m_bindingStats.elidedTextureBindCount++;
+        return;
+    }
+
+    if (IsDirectStateAccessEnabled() && texture != 0)
+    {
+        // Binds to the target of the texture, without changing the active texture unit
+        glBindTextureUnit(textureUnit, texture);
+    }
+    else
+    {
+        // glBindTextureUnit with 0 would unbind all the targets, use the classic path
+        SetActiveTextureUnit(textureUnit);
+        glBindTexture(target, texture);
+    }
+    m_bindingStats.textureBindCount++;
+
+    if (cached)
+    {
+        m_boundTextures[textureUnit][targetIndex] = texture;
+    }
+}
+
+void DeviceGL::BindTextureToActiveUnit(GLenum target, GLuint texture)
+{
+    if (m_activeTextureUnit == UnknownBinding)
+    {
+        // Start from a known state
+        SetActiveTextureUnit(0);
+    }
+    BindTexture(m_activeTextureUnit, target, texture);
+}
+
+void DeviceGL::BindSampler(GLuint textureUnit, GLuint sampler)
+{
+    bool cached = textureUnit < CachedTextureUnitCount;
+    if (cached && m_boundSamplers[textureUnit] == sampler)
+    {
+        m_bindingStats.elidedSamplerBindCount++;
+        return;
+    }
+
+    glBindSampler(textureUnit, sampler);
+    m_bindingStats.samplerBindCount++;
+
+    if (cached)
+    {
+        m_boundSamplers[textureUnit] = sampler;
+    }
+}
+
+void DeviceGL::BindUniformBufferRange(GLuint bindingIndex, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    bool cached = bindingIndex < CachedUniformBufferCount;
+    if (cached)
+    {
+        const UniformBufferBinding& binding = m_boundUniformBuffers[bindingIndex];
+        if (binding.buffer == buffer && binding.offset == offset && binding.size == size)
+        {
+            m_bindingStats.elidedUniformBufferBindCount++;
+            return;
+        }
+    }
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, bindingIndex, buffer, offset, size);
+    m_bindingStats.uniformBufferBindCount++;
+
+    if (cached)
+    {
+        m_boundUniformBuffers[bindingIndex] = { buffer, offset, size };
+    }
+}
+
+void DeviceGL::OnTextureDeleted(GLuint texture)
+{
+    for (auto& unitTextures : m_boundTextures)
+    {
+        for (GLuint& boundTexture : unitTextures)
+        {
+            if (boundTexture == texture)
+            {
+                boundTexture = 0;
+            }
+        }
+    }
+}
+
+void DeviceGL::OnSamplerDeleted(GLuint sampler)
+{
+    for (GLuint& boundSampler : m_boundSamplers)
+    {
+        if (boundSampler == sampler)
+        {
+            boundSampler = 0;
+        }
+    }
+}
+
+void DeviceGL::OnBufferDeleted(GLuint buffer)
+{
+    for (UniformBufferBinding& binding : m_boundUniformBuffers)
+    {
+        if (binding.buffer == buffer)
+        {
+            binding = { 0, 0, 0 };
+        }
+    }
+}
+
+void DeviceGL::InvalidateBindingCache()
+{
+    m_activeTextureUnit = UnknownBinding;
+    for (auto& unitTextures : m_boundTextures)
+    {
+        unitTextures.fill(UnknownBinding);
+    }
+    m_boundSamplers.fill(UnknownBinding);
+    m_boundUniformBuffers.fill({ UnknownBinding, 0, 0 });
+}
+
+void DeviceGL::AddSamplerUniformStats(bool elided)
+{
+    if (elided)
+    {
+        m_bindingStats.elidedSamplerUniformCount++;
+    }
+    else
+    {
+        m_bindingStats.samplerUniformCount++;
+    }
+}
+
+int DeviceGL::GetTextureTargetIndex(GLenum target)
+{
+    switch (target)
+    {
+    case GL_TEXTURE_1D: return 0;
+    case GL_TEXTURE_1D_ARRAY: return 1;
+    case GL_TEXTURE_2D: return 2;
+    case GL_TEXTURE_2D_ARRAY: return 3;
+    case GL_TEXTURE_2D_MULTISAMPLE: return 4;
+    case GL_TEXTURE_2D_MULTISAMPLE_ARRAY: return 5;
+    case GL_TEXTURE_3D: return 6;
+    case GL_TEXTURE_CUBE_MAP: return 7;
+    case GL_TEXTURE_CUBE_MAP_ARRAY: return 8;
+    case GL_TEXTURE_BUFFER: return 9;
+    case GL_TEXTURE_RECTANGLE: return 10;
+    default: return -1;
+    }
+}
@@ -0,0 +1,25 @@
+#include <ituGL/core/FrameSync.h>
+
+#include <cassert>
+
+FrameSync::FrameSync(unsigned int framesInFlight) : m_fences(framesInFlight), m_frameIndex(0), m_stallCount(0)
+{
+    assert(framesInFlight > 0);
+}
+
+void FrameSync::BeginFrame()
+{
+    GpuFence& fence = m_fences[GetSlotIndex()];
+    if (!fence.IsSignaled())
+    {
+        m_stallCount++;
+        fence.Wait();
+    }
+    fence.Reset();
+}
+
+void FrameSync::EndFrame()
+{
+    m_fences[GetSlotIndex()].Insert();
+    m_frameIndex++;
+}
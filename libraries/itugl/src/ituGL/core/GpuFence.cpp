@@ -0,0 +1,65 @@
+#include <ituGL/core/GpuFence.h>
+
+#include <utility>
+#include <cassert>
+
+GpuFence::GpuFence() : m_sync(nullptr)
+{
+}
+
+GpuFence::~GpuFence()
+{
+    Reset();
+}
+
+GpuFence::GpuFence(GpuFence&& fence) noexcept : m_sync(fence.m_sync)
+{
+    fence.m_sync = nullptr;
+}
+
+GpuFence& GpuFence::operator = (GpuFence&& fence) noexcept
+{
+    std::swap(m_sync, fence.m_sync);
+    return *this;
+}
+
+void GpuFence::Insert()
+{
+    Reset();
+    m_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void GpuFence::Reset()
+{
+    if (m_sync)
+    {
+        glDeleteSync(m_sync);
+        m_sync = nullptr;
+    }
+}
+
+bool GpuFence::IsSignaled() const
+{
+    if (!m_sync)
+    {
+        return true;
+    }
+
+    // Query the status, it doesn't flush or block
+    GLint status = GL_UNSIGNALED;
+    glGetSynciv(m_sync, GL_SYNC_STATUS, 1, nullptr, &status);
+    return status == GL_SIGNALED;
+}
+
+bool GpuFence::Wait(GLuint64 timeout) const
+{
+    if (!m_sync)
+    {
+        return true;
+    }
+
+    // Flush, otherwise the fence might never reach the GPU and we would wait forever
+    GLenum result = glClientWaitSync(m_sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    assert(result != GL_WAIT_FAILED);
+    return result != GL_TIMEOUT_EXPIRED;
+}
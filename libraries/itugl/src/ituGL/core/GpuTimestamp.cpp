@@ -0,0 +1,68 @@
+#include <ituGL/core/GpuTimestamp.h>
+
+#include <utility>
+#include <cassert>
+
+GpuTimestamp::GpuTimestamp() : m_query(0)
+{
+}
+
+GpuTimestamp::~GpuTimestamp()
+{
+    Reset();
+}
+
+GpuTimestamp::GpuTimestamp(GpuTimestamp&& timestamp) noexcept : m_query(timestamp.m_query)
+{
+    timestamp.m_query = 0;
+}
+
+GpuTimestamp& GpuTimestamp::operator = (GpuTimestamp&& timestamp) noexcept
+{
+    std::swap(m_query, timestamp.m_query);
+    return *this;
+}
+
+void GpuTimestamp::Record()
+{
+    // The query object can be reused
+    if (!m_query)
+    {
+        glGenQueries(1, &m_query);
+    }
+    glQueryCounter(m_query, GL_TIMESTAMP);
+}
+
+void GpuTimestamp::Reset()
+{
+    if (m_query)
+    {
+        glDeleteQueries(1, &m_query);
+        m_query = 0;
+    }
+}
+
+bool GpuTimestamp::IsAvailable() const
+{
+    assert(m_query);
+
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(m_query, GL_QUERY_RESULT_AVAILABLE, &available);
+    return available != GL_FALSE;
+}
+
+GLuint64 GpuTimestamp::GetTime() const
+{
+    assert(m_query);
+
+    GLuint64 time = 0;
+    glGetQueryObjectui64v(m_query, GL_QUERY_RESULT, &time);
+    return time;
+}
+
+GLuint64 GpuTimestamp::GetCurrentTime()
+{
+    GLint64 time = 0;
+    glGetInteger64v(GL_TIMESTAMP, &time);
+    return static_cast<GLuint64>(time);
+}
@@ -0,0 +1,433 @@
+#include <ituGL/core/JobSystem.h>
+
+#include <algorithm>
+#include <cassert>
+
+struct JobSystem::Job
+{
+    JobFunction function;
+    const char* name;
+    Affinity affinity;
+
+    // Owners of the job: handles, queues and continuation lists
+    std::atomic<int> referenceCount;
+
+    // Unfinished dependencies, plus one until the job is submitted
+    std::atomic<int> pendingCount;
+
+    std::atomic<bool> done;
+
+    // Jobs waiting for this one, protected by the mutex
+    std::mutex mutex;
+    std::vector<Job*> continuations;
+};
+
+// Each thread knows its index inside the job system that owns it
+static thread_local const JobSystem* s_currentJobSystem = nullptr;
+static thread_local unsigned int s_currentThreadIndex = JobSystem::ExternalThreadIndex;
+
+JobSystem::JobHandle::JobHandle() : m_job(nullptr)
+{
+}
+
+JobSystem::JobHandle::JobHandle(Job* job) : m_job(job)
+{
+    // Reference already added by the caller
+}
+
+JobSystem::JobHandle::~JobHandle()
+{
+    if (m_job)
+    {
+        RemoveReference(m_job);
+    }
+}
+
+JobSystem::JobHandle::JobHandle(const JobHandle& other) : m_job(other.m_job)
+{
+    if (m_job)
+    {
+        AddReference(m_job);
+    }
+}
+
+JobSystem::JobHandle::JobHandle(JobHandle&& other) noexcept : m_job(other.m_job)
+{
+    other.m_job = nullptr;
+}
+
+JobSystem::JobHandle& JobSystem::JobHandle::operator = (JobHandle other) noexcept
+{
+    std::swap(m_job, other.m_job);
+    return *this;
+}
+
+JobSystem::JobSystem(unsigned int workerCount)
+    : m_queuedJobCount(0)
+    , m_mainThreadId(std::this_thread::get_id())
+    , m_stop(false)
+{
+    s_currentJobSystem = this;
+    s_currentThreadIndex = MainThreadIndex;
+
+    // Create all the queues before starting any worker, they steal from each other
+    for (unsigned int i = 0; i <= workerCount; ++i)
+    {
+        m_queues.push_back(std::make_unique<JobQueue>());
+    }
+
+    m_workers.reserve(workerCount);
+    for (unsigned int i = 1; i <= workerCount; ++i)
+    {
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_sleepCondition.notify_all();
+
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+
+    if (s_currentJobSystem == this)
+    {
+        s_currentJobSystem = nullptr;
+        s_currentThreadIndex = ExternalThreadIndex;
+    }
+}
+
+unsigned int JobSystem::GetDefaultWorkerCount()
+{
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+bool JobSystem::IsMainThread() const
+{
+    return std::this_thread::get_id() == m_mainThreadId;
+}
+
+unsigned int JobSystem::GetCurrentThreadIndex() const
+{
+    return s_currentJobSystem == this ? s_currentThreadIndex : ExternalThreadIndex;
+}
+
+void JobSystem::SetProfilerHooks(const ProfilerHooks& profilerHooks)
+{
+    m_profilerHooks = profilerHooks;
+}
+
+JobSystem::JobHandle JobSystem::CreateJob(JobFunction function, const char* name, Affinity affinity)
+{
+    Job* job = new Job();
+    job->function = std::move(function);
+    job->name = name;
+    job->affinity = affinity;
+    job->referenceCount = 1;
+    job->pendingCount = 1;
+    job->done = false;
+    return JobHandle(job);
+}
+
+void JobSystem::AddDependency(const JobHandle& job, const JobHandle& dependency)
+{
+    assert(job.IsValid() && dependency.IsValid());
+    assert(job.m_job != dependency.m_job);
+
+    Job* dependencyJob = dependency.m_job;
+    std::lock_guard<std::mutex> lock(dependencyJob->mutex);
+
+    // If it already finished, there is nothing to wait for
+    if (!dependencyJob->done)
+    {
+        job.m_job->pendingCount++;
+        AddReference(job.m_job);
+        dependencyJob->continuations.push_back(job.m_job);
+    }
+}
+
+void JobSystem::Submit(const JobHandle& job)
+{
+    assert(job.IsValid());
+
+    // Reference owned by the scheduler until the job finishes
+    AddReference(job.m_job);
+
+    // Remove the "not submitted" count. If there are no other dependencies, it is ready
+    if (job.m_job->pendingCount.fetch_sub(1) == 1)
+    {
+        Schedule(job.m_job);
+    }
+}
+
+JobSystem::JobHandle JobSystem::Run(JobFunction function, const char* name, Affinity affinity)
+{
+    JobHandle job = CreateJob(std::move(function), name, affinity);
+    Submit(job);
+    return job;
+}
+
+bool JobSystem::IsDone(const JobHandle& job) const
+{
+    assert(job.IsValid());
+    return job.m_job->done.load(std::memory_order_acquire);
+}
+
+void JobSystem::Wait(const JobHandle& job)
+{
+    assert(job.IsValid());
+
+    unsigned int threadIndex = GetCurrentThreadIndex();
+    while (!IsDone(job))
+    {
+        // Help instead of blocking
+        if (!TryRunJob(threadIndex))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::ParallelFor(unsigned int begin, unsigned int end, const RangeFunction& function, unsigned int grainSize, const char* name)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    unsigned int count = end - begin;
+    if (grainSize == 0)
+    {
+        // A few chunks per thread, so the stealing can balance uneven work
+        unsigned int threadCount = GetWorkerCount() + 1;
+        grainSize = std::max(1u, count / (threadCount * 4));
+    }
+
+    // Not worth splitting
+    if (count <= grainSize || m_workers.empty())
+    {
+        function(begin, end);
+        return;
+    }
+
+    // Empty job that finishes when all the chunks are done
+    JobHandle completionJob = CreateJob([] {}, name);
+    for (unsigned int chunkBegin = begin; chunkBegin < end; chunkBegin += std::min(grainSize, end - chunkBegin))
+    {
+        unsigned int chunkEnd = chunkBegin + std::min(grainSize, end - chunkBegin);
+
+        // Function captured by reference, it is alive until the wait below returns
+        JobHandle chunkJob = CreateJob([&function, chunkBegin, chunkEnd] { function(chunkBegin, chunkEnd); }, name);
+        AddDependency(completionJob, chunkJob);
+        Submit(chunkJob);
+    }
+    Submit(completionJob);
+
+    Wait(completionJob);
+}
+
+unsigned int JobSystem::RunMainThreadJobs()
+{
+    assert(IsMainThread());
+
+    unsigned int jobCount = 0;
+    while (true)
+    {
+        Job* job = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+            if (m_mainThreadQueue.empty())
+            {
+                break;
+            }
+            job = m_mainThreadQueue.front();
+            m_mainThreadQueue.pop_front();
+        }
+        Execute(job, MainThreadIndex);
+        ++jobCount;
+    }
+    return jobCount;
+}
+
+void JobSystem::WorkerLoop(unsigned int threadIndex)
+{
+    s_currentJobSystem = this;
+    s_currentThreadIndex = threadIndex;
+
+    while (true)
+    {
+        if (TryRunJob(threadIndex))
+        {
+            continue;
+        }
+
+        // Nothing found, sleep until new jobs are queued
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [this] { return m_stop || m_queuedJobCount.load() > 0; });
+        if (m_stop)
+        {
+            break;
+        }
+    }
+}
+
+void JobSystem::Schedule(Job* job)
+{
+    if (job->affinity == Affinity::MainThread)
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        m_mainThreadQueue.push_back(job);
+        return;
+    }
+
+    unsigned int threadIndex = GetCurrentThreadIndex();
+    if (threadIndex != ExternalThreadIndex)
+    {
+        if (!m_queues[threadIndex]->Push(job))
+        {
+            // Queue full, better to run it now than to lose it
+            Execute(job, threadIndex);
+            return;
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_injectionMutex);
+        m_injectionQueue.push_back(job);
+    }
+
+    {
+        // Lock, so a worker can't miss the notification between checking the count and going to sleep
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_queuedJobCount++;
+    }
+    m_sleepCondition.notify_one();
+}
+
+bool JobSystem::TryRunJob(unsigned int threadIndex)
+{
+    Job* job = nullptr;
+    if (TryGetJob(threadIndex, job))
+    {
+        m_queuedJobCount--;
+        Execute(job, threadIndex);
+        return true;
+    }
+
+    // The main thread also takes its own jobs while waiting, it could be waiting for one of them
+    if (threadIndex == MainThreadIndex && IsMainThread())
+    {
+        // A failed pop or steal can still write the job pointer
+        job = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+            if (!m_mainThreadQueue.empty())
+            {
+                job = m_mainThreadQueue.front();
+                m_mainThreadQueue.pop_front();
+            }
+        }
+        if (job)
+        {
+            Execute(job, threadIndex);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::TryGetJob(unsigned int threadIndex, Job*& job)
+{
+    // Own queue first, most recent job (likely still in cache)
+    if (threadIndex != ExternalThreadIndex && m_queues[threadIndex]->Pop(job))
+    {
+        return true;
+    }
+
+    // Jobs from external threads
+    {
+        std::lock_guard<std::mutex> lock(m_injectionMutex);
+        if (!m_injectionQueue.empty())
+        {
+            job = m_injectionQueue.front();
+            m_injectionQueue.pop_front();
+            return true;
+        }
+    }
+
+    // Steal the oldest job from another thread, starting from a different one each time to spread the contention
+    static thread_local unsigned int s_stealSeed = 0;
+    unsigned int queueCount = static_cast<unsigned int>(m_queues.size());
+    unsigned int firstVictim = (s_stealSeed++ + threadIndex) % queueCount;
+    for (unsigned int i = 0; i < queueCount; ++i)
+    {
+        unsigned int victimIndex = (firstVictim + i) % queueCount;
+        if (victimIndex != threadIndex && m_queues[victimIndex]->Steal(job))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::Execute(Job* job, unsigned int threadIndex)
+{
+    if (m_profilerHooks.jobBegin)
+    {
+        m_profilerHooks.jobBegin(job->name, threadIndex);
+    }
+
+    job->function();
+
+    if (m_profilerHooks.jobEnd)
+    {
+        m_profilerHooks.jobEnd(job->name, threadIndex);
+    }
+
+    Finish(job);
+}
+
+void JobSystem::Finish(Job* job)
+{
+    std::vector<Job*> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->done.store(true, std::memory_order_release);
+        continuations.swap(job->continuations);
+    }
+
+    // Release the jobs that were waiting for this one
+    for (Job* continuation : continuations)
+    {
+        if (continuation->pendingCount.fetch_sub(1) == 1)
+        {
+            Schedule(continuation);
+        }
+        RemoveReference(continuation);
+    }
+
+    // Reference taken in Submit
+    RemoveReference(job);
+}
+
+void JobSystem::AddReference(Job* job)
+{
+    job->referenceCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void JobSystem::RemoveReference(Job* job)
+{
+    if (job->referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete job;
+    }
+}
@@ -8,7 +8,10 @@ unsigned int Mesh::AddVertexData(size_t size)
 {
     unsigned int vboIndex = GetVertexBufferCount();
     VertexBufferObject& vbo = m_vbos.emplace_back();
-    vbo.Bind();
+    if (!DeviceGL::IsDirectStateAccessEnabled())
+    {
+        vbo.Bind();
+    }
     vbo.AllocateData(size);
     return vboIndex;
 }
@@ -20,6 +23,45 @@ unsigned int Mesh::AddVertexArray()
     return vaoIndex;
 }
 
+unsigned int Mesh::AddVertexArray(unsigned int vboIndex, std::span<const VertexAttribute::Layout> layouts, const SemanticMap& locations)
+{
+    unsigned int vaoIndex = AddVertexArray();
+
+    // Same locations as SetupVertexAttribute: from the semantic map, or after the previous attribute
+    std::vector<GLuint> attributeLocations;
+    attributeLocations.reserve(layouts.size());
+    GLuint location = 0;
+    for (const VertexAttribute::Layout& layout : layouts)
+    {
+        auto itLocation = locations.find(layout.GetAttribute().GetSemantic());
+        if (itLocation != locations.end())
+        {
+            location = itLocation->second;
+        }
+        attributeLocations.push_back(location);
+        location += layout.GetAttribute().GetLocationSize();
+    }
+
+    // With Direct State Access, the attributes are set without binding anything
+    bool bindToEdit = !DeviceGL::IsDirectStateAccessEnabled();
+
+    VertexArrayObject& vao = GetVertexArray(vaoIndex);
+    if (bindToEdit)
+    {
+        vao.Bind();
+    }
+
+    vao.SetAttributes(m_vbos[vboIndex], layouts, attributeLocations);
+
+    if (bindToEdit)
+    {
+        VertexBufferObject::Unbind();
+        VertexArrayObject::Unbind();
+    }
+
+    return vaoIndex;
+}
+
 unsigned int Mesh::AddSubmesh(unsigned int vaoIndex, const Drawcall& drawcall)
 {
     unsigned int submeshIndex = GetSubmeshCount();
@@ -45,7 +87,7 @@ void Mesh::DrawSubmesh(int submeshIndex) const
     //VertexArrayObject::Unbind(); // No need to unbind
 }
 
-void Mesh::SetupVertexAttribute(VertexArrayObject& vao, const VertexAttribute::Layout& attributeLayout, GLuint& location, const SemanticMap& locations)
+void Mesh::SetupVertexAttribute(VertexArrayObject& vao, const VertexBufferObject& vbo, const VertexAttribute::Layout& attributeLayout, GLuint& location, const SemanticMap& locations)
 {
     const VertexAttribute& attribute = attributeLayout.GetAttribute();
 
@@ -55,6 +97,21 @@ void Mesh::SetupVertexAttribute(VertexArrayObject& vao, const VertexAttribute::L
         location = itLocation->second;
     }
 
-    vao.SetAttribute(location, attribute, attributeLayout.GetOffset(), attributeLayout.GetStride());
+    vao.SetAttribute(vbo, location, attribute, attributeLayout.GetOffset(), attributeLayout.GetStride());
     location += attribute.GetLocationSize();
 }
+
+void Mesh::SetupElementBuffer(VertexArrayObject& vao, const ElementBufferObject& ebo)
+{
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        vao.SetElementBuffer(ebo);
+    }
+    else
+    {
+        vao.Bind();
+        vao.SetElementBuffer(ebo);
+        VertexArrayObject::Unbind();
+        ElementBufferObject::Unbind();
+    }
+}
@@ -3,7 +3,7 @@
 #include <ituGL/geometry/Mesh.h>
 #include <ituGL/shader/Material.h>
 
-Model::Model(std::shared_ptr<Mesh> mesh) : m_mesh(mesh)
+Model::Model(std::shared_ptr<Mesh> mesh) : m_mesh(mesh), m_layerMask(RenderLayer::All)
 {
 }
 
@@ -56,6 +56,16 @@ void Model::ClearMaterials()
     m_materials.clear();
 }
 
+RenderLayerMask Model::GetLayerMask() const
+{
+    return m_layerMask;
+}
+
+void Model::SetLayerMask(RenderLayerMask layerMask)
+{
+    m_layerMask = layerMask;
+}
+
 void Model::Draw()
 {
     if (m_mesh)
@@ -65,7 +75,8 @@ void Model::Draw()
 
         for (unsigned int submeshIndex = 0; submeshIndex < m_mesh->GetSubmeshCount(); ++submeshIndex)
         {
-            Material& material = GetMaterial(submeshIndex);
+            GetMaterial(submeshIndex).UpdateShaderProgram();
+            const Material& material = GetMaterial(submeshIndex).GetRenderMaterial();
 
             // Set up the material before rendering
             material.Use();
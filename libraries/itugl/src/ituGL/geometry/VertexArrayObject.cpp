@@ -1,11 +1,14 @@
 #include <ituGL/geometry/VertexArrayObject.h>
 
 #include <ituGL/geometry/VertexAttribute.h>
+#include <ituGL/geometry/VertexBufferObject.h>
+#include <ituGL/geometry/ElementBufferObject.h>
+#include <ituGL/core/DeviceGL.h>
+#include <algorithm>
+#include <vector>
 #include <cassert>
 
 #ifndef NDEBUG
-#include <ituGL/geometry/VertexBufferObject.h>   // To assert that there is a VertexBufferObject bound
-
 VertexArrayObject::Handle VertexArrayObject::s_boundHandle = VertexArrayObject::NullHandle;
 #endif
 
@@ -13,7 +16,15 @@ VertexArrayObject::Handle VertexArrayObject::s_boundHandle = VertexArrayObject::
 VertexArrayObject::VertexArrayObject() : Object(NullHandle)
 {
     Handle& handle = GetHandle();
-    glGenVertexArrays(1, &handle);
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        // DSA functions need the vertex array to exist, not just the name reserved by glGenVertexArrays
+        glCreateVertexArrays(1, &handle);
+    }
+    else
+    {
+        glGenVertexArrays(1, &handle);
+    }
 }
 
 // Get object handle and delete 1 vertex array
@@ -74,3 +85,105 @@ void VertexArrayObject::SetAttribute(GLuint location, const VertexAttribute& att
     // Finally, we enable the VertexAttribute in this location
     glEnableVertexAttribArray(location);
 }
+
+// Sets the VertexAttribute format, the buffer it reads from, and enables the VertexAttribute in that location
+void VertexArrayObject::SetAttribute(const VertexBufferObject& vbo, GLuint location, const VertexAttribute& attribute, GLint offset, GLsizei stride)
+{
+    if (!DeviceGL::IsDirectStateAccessEnabled())
+    {
+        // Fallback: bind the buffer and use the bind-to-edit path
+        vbo.Bind();
+        SetAttribute(location, attribute, offset, stride);
+        return;
+    }
+
+    Handle handle = GetHandle();
+
+    // Get the attribute properties in OpenGL expected format
+    GLint components = attribute.GetComponents();
+    GLenum type = static_cast<GLenum>(attribute.GetType());
+    GLboolean normalized = attribute.IsNormalized() ? GL_TRUE : GL_FALSE;
+
+    // Unlike glVertexAttribPointer, stride 0 is not replaced with the attribute size
+    if (stride == 0)
+    {
+        stride = attribute.GetSize();
+    }
+
+    // One buffer binding point per location, with the offset in the binding. Equivalent to glVertexAttribPointer
+    GLuint bindingIndex = location;
+    glVertexArrayVertexBuffer(handle, bindingIndex, vbo.GetHandle(), offset, stride);
+    glVertexArrayAttribFormat(handle, location, components, type, normalized, 0);
+    glVertexArrayAttribBinding(handle, location, bindingIndex);
+
+    // Finally, we enable the VertexAttribute in this location
+    glEnableVertexArrayAttrib(handle, location);
+}
+
+void VertexArrayObject::SetAttributes(const VertexBufferObject& vbo, std::span<const VertexAttribute::Layout> layouts, GLuint firstLocation)
+{
+    // Consecutive locations, each attribute after the locations used by the previous one
+    std::vector<GLuint> locations;
+    locations.reserve(layouts.size());
+    GLuint location = firstLocation;
+    for (const VertexAttribute::Layout& layout : layouts)
+    {
+        locations.push_back(location);
+        location += layout.GetAttribute().GetLocationSize();
+    }
+
+    SetAttributes(vbo, layouts, locations);
+}
+
+void VertexArrayObject::SetAttributes(const VertexBufferObject& vbo, std::span<const VertexAttribute::Layout> layouts, std::span<const GLuint> locations)
+{
+    assert(locations.size() == layouts.size());
+
+    // Interleaved attributes have the same stride, and offsets relative to the start of the vertex
+    GLsizei stride = layouts.empty() ? 0 : layouts[0].GetStride();
+    bool interleaved = stride != 0 && std::all_of(layouts.begin(), layouts.end(),
+        [stride](const VertexAttribute::Layout& layout) { return layout.GetStride() == stride; });
+
+    if (!DeviceGL::IsDirectStateAccessEnabled() || !interleaved)
+    {
+        for (std::size_t i = 0; i < layouts.size(); ++i)
+        {
+            SetAttribute(vbo, locations[i], layouts[i].GetAttribute(), layouts[i].GetOffset(), layouts[i].GetStride());
+        }
+        return;
+    }
+
+    Handle handle = GetHandle();
+
+    // A single binding point for the whole vertex. The offset of each attribute is relative to it
+    GLuint bindingIndex = locations[0];
+    glVertexArrayVertexBuffer(handle, bindingIndex, vbo.GetHandle(), 0, stride);
+
+    for (std::size_t i = 0; i < layouts.size(); ++i)
+    {
+        const VertexAttribute& attribute = layouts[i].GetAttribute();
+        GLint components = attribute.GetComponents();
+        GLenum type = static_cast<GLenum>(attribute.GetType());
+        GLboolean normalized = attribute.IsNormalized() ? GL_TRUE : GL_FALSE;
+
+        GLuint location = locations[i];
+        glVertexArrayAttribFormat(handle, location, components, type, normalized, layouts[i].GetOffset());
+        glVertexArrayAttribBinding(handle, location, bindingIndex);
+        glEnableVertexArrayAttrib(handle, location);
+    }
+}
+
+// Sets the ElementBufferObject in the VertexArrayObject state
+void VertexArrayObject::SetElementBuffer(const ElementBufferObject& ebo)
+{
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glVertexArrayElementBuffer(GetHandle(), ebo.GetHandle());
+    }
+    else
+    {
+        // Binding the element buffer while the VertexArrayObject is bound stores it in the VertexArrayObject
+        assert(IsBound());
+        ebo.Bind();
+    }
+}
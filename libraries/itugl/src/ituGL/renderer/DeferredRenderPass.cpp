@@ -7,6 +7,8 @@
 #include <ituGL/shader/Material.h>
 #include <ituGL/texture/Texture2DObject.h>
 #include <glm/gtx/transform.hpp>
+#include <algorithm>
+#include <vector>
 
 DeferredRenderPass::DeferredRenderPass(std::shared_ptr<Material> material, std::shared_ptr<const FramebufferObject> framebuffer)
     : RenderPass(framebuffer), m_material(material)
@@ -23,8 +25,17 @@ void DeferredRenderPass::Render()
     const Camera& camera = renderer.GetCurrentCamera();
 
     assert(m_material);
-    m_material->Use();
-    std::shared_ptr<const ShaderProgram> shaderProgram = m_material->GetShaderProgram();
+
+    // Resolve the materials once, so all the lights of the frame are drawn with the same ones
+    m_material->UpdateShaderProgram();
+    const Material& material = m_material->GetRenderMaterial();
+
+    // The variant without shadows is only used together with the main material, never with its placeholder
+    const Material* noShadowMaterial = nullptr;
+    if (m_noShadowMaterial && m_noShadowMaterial->UpdateShaderProgram() && &material == m_material.get())
+    {
+        noShadowMaterial = m_noShadowMaterial.get();
+    }
 
     // Our fullscreen triangle is directly in clip coordinates.
     // Use the inverse view proj matrix to cancel view projection from the camera
@@ -33,11 +44,40 @@ void DeferredRenderPass::Render()
     bool first = true;
     unsigned int lightIndex = 0;
     const auto& lights = renderer.GetLights();
-    while (renderer.UpdateLights(shaderProgram, lights, lightIndex))
+
+    // Each material has its own program, that needs the camera the first time it is used
+    const Material* currentMaterial = nullptr;
+    Renderer::ShaderProgramHandle shaderProgramHandle;
+    std::vector<const Material*> usedMaterials;
+
+    while (true)
     {
+        // Choose the material before the light is uploaded to its program
+        // Lights without a shadow map, and the ambient only pass when there are no lights, don't need the shadow code
+        const Light* nextLight = lightIndex < lights.size() ? lights[lightIndex] : nullptr;
+        bool useNoShadowMaterial = noShadowMaterial && (!nextLight || !nextLight->GetShadowMap());
+        const Material& lightMaterial = useNoShadowMaterial ? *noShadowMaterial : material;
+        if (&lightMaterial != currentMaterial)
+        {
+            lightMaterial.Use();
+            currentMaterial = &lightMaterial;
+            shaderProgramHandle = renderer.GetShaderProgramHandle(*lightMaterial.GetShaderProgram());
+        }
+
+        if (!renderer.UpdateLights(shaderProgramHandle, lights, lightIndex))
+        {
+            break;
+        }
+
         const Light* light = lightIndex <= lights.size() ? lights[lightIndex - 1] : nullptr;
         assert(first || light);
 
+        bool cameraChanged = std::find(usedMaterials.begin(), usedMaterials.end(), &lightMaterial) == usedMaterials.end();
+        if (cameraChanged)
+        {
+            usedMaterials.push_back(&lightMaterial);
+        }
+
         const Mesh* mesh = &renderer.GetFullscreenMesh();
         glm::mat4 worldMatrix = fullscreenMatrix;
 
@@ -46,7 +86,7 @@ void DeferredRenderPass::Render()
         // Set the render states for the first and additional lights
         renderer.SetLightingRenderStates(first);
 
-        renderer.UpdateTransforms(shaderProgram, worldMatrix, first);
+        renderer.UpdateTransforms(shaderProgramHandle, worldMatrix, cameraChanged);
         mesh->DrawSubmesh(0);
         first = false;
     }
@@ -5,13 +5,8 @@
 #include <ituGL/geometry/VertexArrayObject.h>
 #include <ituGL/renderer/Renderer.h>
 
-ForwardRenderPass::ForwardRenderPass()
-    : ForwardRenderPass(0)
-{
-}
-
-ForwardRenderPass::ForwardRenderPass(int drawcallCollectionIndex)
-    : m_drawcallCollectionIndex(drawcallCollectionIndex)
+ForwardRenderPass::ForwardRenderPass(RenderLayerMask layerMask)
+    : m_layerMask(layerMask)
 {
 }
 
@@ -19,29 +14,10 @@ void ForwardRenderPass::Render()
 {
     Renderer& renderer = GetRenderer();
 
-    const auto& lights = renderer.GetLights();
-    const auto& drawcallCollection = renderer.GetDrawcalls(m_drawcallCollectionIndex);
-
-    // for all drawcalls
-    for (const Renderer::DrawcallInfo& drawcallInfo : drawcallCollection)
-    {
-        // Prepare drawcall states
-        renderer.PrepareDrawcall(drawcallInfo);
-
-        std::shared_ptr<const ShaderProgram> shaderProgram = drawcallInfo.material.GetShaderProgram();
-
-        //for all lights
-        bool first = true;
-        unsigned int lightIndex = 0;
-        while (renderer.UpdateLights(shaderProgram, lights, lightIndex))
-        {
-            // Set the renderstates
-            renderer.SetLightingRenderStates(first);
-
-            // Draw
-            drawcallInfo.drawcall.Draw();
+    // Record the drawcalls in our layers
+    m_commandList.Clear();
+    m_commandList.Record(renderer, m_layerMask);
 
-            first = false;
-        }
-    }
+    // Draw them once per light
+    m_commandList.SubmitLit(renderer);
 }
@@ -7,8 +7,8 @@
 #include <ituGL/texture/Texture2DObject.h>
 #include <ituGL/texture/FramebufferObject.h>
 
-GBufferRenderPass::GBufferRenderPass(int width, int height, int drawcallCollectionIndex)
-    : m_drawcallCollectionIndex(drawcallCollectionIndex)
+GBufferRenderPass::GBufferRenderPass(int width, int height, RenderLayerMask layerMask)
+    : m_layerMask(layerMask)
 {
     InitTextures(width, height);
     InitFramebuffer();
@@ -81,26 +81,29 @@ void GBufferRenderPass::Render()
 {
     Renderer& renderer = GetRenderer();
 
-    const auto& drawcallCollection = renderer.GetDrawcalls(m_drawcallCollectionIndex);
+    // Record the drawcalls in our layers
+    m_commandList.Clear();
+    m_commandList.Record(renderer, m_layerMask);
+
+#ifndef NDEBUG
+    for (const Renderer::DrawcallInfo& drawcallInfo : renderer.GetDrawcalls())
+    {
+        if (drawcallInfo.IsInLayers(m_layerMask))
+        {
+            assert(drawcallInfo.material.GetBlendEquationColor() == Material::BlendEquation::None);
+            assert(drawcallInfo.material.GetBlendEquationAlpha() == Material::BlendEquation::None);
+            assert(drawcallInfo.material.GetDepthWrite());
+        }
+    }
+#endif
 
     renderer.GetDevice().Clear(true, Color(0.0f, 0.0f, 0.0f, 1.0f), true, 1.0f);
 
     bool wasSRGB = renderer.GetDevice().IsFeatureEnabled(GL_FRAMEBUFFER_SRGB);
     renderer.GetDevice().EnableFeature(GL_FRAMEBUFFER_SRGB);
 
-    // for all drawcalls
-    for (const Renderer::DrawcallInfo& drawcallInfo : drawcallCollection)
-    {
-        assert(drawcallInfo.material.GetBlendEquationColor() == Material::BlendEquation::None);
-        assert(drawcallInfo.material.GetBlendEquationAlpha() == Material::BlendEquation::None);
-        assert(drawcallInfo.material.GetDepthWrite());
-
-        // Prepare drawcall (similar to forward)
-        renderer.PrepareDrawcall(drawcallInfo);
-
-        // Render drawcall
-        drawcallInfo.drawcall.Draw();
-    }
+    // Render all the commands with their materials
+    m_commandList.Submit(renderer);
 
     renderer.GetDevice().SetFeatureEnabled(GL_FRAMEBUFFER_SRGB, wasSRGB);
 }
@@ -14,7 +14,8 @@ void PostFXRenderPass::Render()
     Renderer& renderer = GetRenderer();
 
     assert(m_material);
-    m_material->Use();
+    m_material->UpdateShaderProgram();
+    m_material->GetRenderMaterial().Use();
 
     const Mesh* mesh = &renderer.GetFullscreenMesh();
     mesh->DrawSubmesh(0);
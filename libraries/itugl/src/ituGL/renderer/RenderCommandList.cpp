@@ -0,0 +1,228 @@
+#include <ituGL/renderer/RenderCommandList.h>
+
+#include <ituGL/shader/Material.h>
+#include <ituGL/geometry/VertexArrayObject.h>
+#include <algorithm>
+#include <cassert>
+
+// Keep the commands small, so many of them fit in a cache line
+static_assert(sizeof(RenderCommandList::Command) <= 32, "RenderCommandList::Command should be 32 bytes or less");
+
+RenderCommandList::RenderCommandList()
+{
+}
+
+void RenderCommandList::Clear()
+{
+    m_commands.clear();
+    m_materials.clear();
+    m_vaos.clear();
+    m_materialIndices.clear();
+    m_batchIndices.clear();
+    m_vaoIndices.clear();
+}
+
+void RenderCommandList::Record(const Renderer& renderer, RenderLayerMask layerMask)
+{
+    for (const Renderer::DrawcallInfo& drawcallInfo : renderer.GetDrawcalls())
+    {
+        if (drawcallInfo.IsInLayers(layerMask))
+        {
+            Add(renderer, drawcallInfo);
+        }
+    }
+}
+
+void RenderCommandList::Add(const Renderer& renderer, const Renderer::DrawcallInfo& drawcallInfo)
+{
+    Command command;
+    command.materialIndex = GetMaterialIndex(renderer, drawcallInfo.material);
+    command.vaoIndex = GetVaoIndex(drawcallInfo.vao);
+    command.worldMatrixIndex = drawcallInfo.worldMatrixIndex;
+    command.drawcall = drawcallInfo.drawcall;
+    m_commands.push_back(command);
+}
+
+void RenderCommandList::SortByState()
+{
+    // Stable, so commands with the same state keep the order they were recorded in
+    std::stable_sort(m_commands.begin(), m_commands.end(), [this](const Command& a, const Command& b)
+        {
+            unsigned int batchA = m_materials[a.materialIndex].batchIndex;
+            unsigned int batchB = m_materials[b.materialIndex].batchIndex;
+            if (batchA != batchB)
+                return batchA < batchB;
+            return a.materialIndex != b.materialIndex ? a.materialIndex < b.materialIndex : a.vaoIndex < b.vaoIndex;
+        });
+}
+
+void RenderCommandList::Submit(Renderer& renderer) const
+{
+    const Camera& camera = renderer.GetCurrentCamera();
+
+    unsigned int currentMaterialIndex = ~0u;
+    unsigned int currentVaoIndex = ~0u;
+    Renderer::ShaderProgramHandle shaderProgramHandle;
+    const Renderer::ShaderProgramInfo* shaderProgramInfo = nullptr;
+
+    for (const Command& command : m_commands)
+    {
+        bool cameraChanged = false;
+
+        // Setup material, only if it changed
+        if (command.materialIndex != currentMaterialIndex)
+        {
+            const MaterialEntry& materialEntry = m_materials[command.materialIndex];
+            materialEntry.material->Use();
+
+            if (materialEntry.shaderProgram != shaderProgramHandle)
+            {
+                shaderProgramHandle = materialEntry.shaderProgram;
+                shaderProgramInfo = renderer.GetShaderProgramInfo(shaderProgramHandle);
+                cameraChanged = true;
+            }
+            currentMaterialIndex = command.materialIndex;
+        }
+
+        // Setup VAO, only if it changed
+        if (command.vaoIndex != currentVaoIndex)
+        {
+            m_vaos[command.vaoIndex]->Bind();
+            currentVaoIndex = command.vaoIndex;
+        }
+
+        // Setup world matrix and camera
+        if (shaderProgramInfo)
+        {
+            shaderProgramInfo->UpdateTransforms(renderer.GetWorldMatrix(command.worldMatrixIndex), camera, cameraChanged);
+        }
+
+        command.drawcall.Draw();
+    }
+}
+
+void RenderCommandList::SubmitLit(Renderer& renderer) const
+{
+    const Camera& camera = renderer.GetCurrentCamera();
+    std::span<const Light* const> lights = renderer.GetLights();
+
+    unsigned int currentMaterialIndex = ~0u;
+    unsigned int currentVaoIndex = ~0u;
+    Renderer::ShaderProgramHandle shaderProgramHandle;
+    const Renderer::ShaderProgramInfo* shaderProgramInfo = nullptr;
+
+    for (const Command& command : m_commands)
+    {
+        bool cameraChanged = false;
+
+        // Setup material, only if it changed. The lighting render states are set again for each command
+        if (command.materialIndex != currentMaterialIndex)
+        {
+            const MaterialEntry& materialEntry = m_materials[command.materialIndex];
+            materialEntry.material->Use();
+
+            if (materialEntry.shaderProgram != shaderProgramHandle)
+            {
+                shaderProgramHandle = materialEntry.shaderProgram;
+                shaderProgramInfo = renderer.GetShaderProgramInfo(shaderProgramHandle);
+                cameraChanged = true;
+            }
+            currentMaterialIndex = command.materialIndex;
+        }
+
+        // Without a lights function there is nothing to draw, same as the forward pass
+        if (!shaderProgramInfo || !shaderProgramInfo->HasLights())
+            continue;
+
+        // Setup VAO, only if it changed
+        if (command.vaoIndex != currentVaoIndex)
+        {
+            m_vaos[command.vaoIndex]->Bind();
+            currentVaoIndex = command.vaoIndex;
+        }
+
+        // Setup world matrix and camera
+        if (shaderProgramInfo)
+        {
+            shaderProgramInfo->UpdateTransforms(renderer.GetWorldMatrix(command.worldMatrixIndex), camera, cameraChanged);
+        }
+
+        //for all lights
+        bool first = true;
+        unsigned int lightIndex = 0;
+        while (shaderProgramInfo->UpdateLights(lights, lightIndex))
+        {
+            renderer.SetLightingRenderStates(first);
+            command.drawcall.Draw();
+            first = false;
+        }
+    }
+}
+
+void RenderCommandList::Submit(Renderer& renderer, const Material& overrideMaterial) const
+{
+    const Camera& camera = renderer.GetCurrentCamera();
+
+    const Material& material = overrideMaterial.GetRenderMaterial();
+
+    material.Use();
+    const Renderer::ShaderProgramInfo* shaderProgramInfo = renderer.GetShaderProgramInfo(renderer.GetShaderProgramHandle(*material.GetShaderProgram()));
+
+    unsigned int currentVaoIndex = ~0u;
+    bool cameraChanged = true;
+
+    for (const Command& command : m_commands)
+    {
+        // Setup VAO, only if it changed
+        if (command.vaoIndex != currentVaoIndex)
+        {
+            m_vaos[command.vaoIndex]->Bind();
+            currentVaoIndex = command.vaoIndex;
+        }
+
+        // Setup world matrix and camera
+        if (shaderProgramInfo)
+        {
+            shaderProgramInfo->UpdateTransforms(renderer.GetWorldMatrix(command.worldMatrixIndex), camera, cameraChanged);
+        }
+
+        command.drawcall.Draw();
+
+        cameraChanged = false;
+    }
+}
+
+unsigned int RenderCommandList::GetMaterialIndex(const Renderer& renderer, const Material& drawcallMaterial)
+{
+    // Materials waiting for their shader program are recorded with their placeholder, and sorted with it
+    const Material& material = drawcallMaterial.GetRenderMaterial();
+
+    auto itFind = m_materialIndices.find(&material);
+    if (itFind != m_materialIndices.end())
+    {
+        return itFind->second;
+    }
+
+    unsigned int index = static_cast<unsigned int>(m_materials.size());
+    // Instances are batched with the other instances of their parent
+    const ShaderUniformCollection* batchKey = material.GetParent() ? material.GetParent() : &material;
+    unsigned int batchIndex = m_batchIndices.try_emplace(batchKey, index).first->second;
+
+    m_materials.push_back(MaterialEntry{ &material, renderer.GetShaderProgramHandle(*material.GetShaderProgram()), batchIndex });
+    m_materialIndices[&material] = index;
+    return index;
+}
+
+unsigned int RenderCommandList::GetVaoIndex(const VertexArrayObject& vao)
+{
+    auto itFind = m_vaoIndices.find(&vao);
+    if (itFind != m_vaoIndices.end())
+    {
+        return itFind->second;
+    }
+
+    unsigned int index = static_cast<unsigned int>(m_vaos.size());
+    m_vaos.push_back(&vao);
+    m_vaoIndices[&vao] = index;
+    return index;
+}
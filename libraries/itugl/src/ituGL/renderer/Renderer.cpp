@@ -1,5 +1,6 @@
 #include <ituGL/renderer/Renderer.h>
 
+#include <ituGL/core/DeviceGL.h>
 #include <ituGL/shader/Material.h>
 #include <ituGL/geometry/VertexFormat.h>
 #include <ituGL/geometry/VertexArrayObject.h>
@@ -18,7 +19,6 @@ Renderer::Renderer(DeviceGL& device)
     , m_currentCamera(nullptr)
     , m_defaultFramebuffer(FramebufferObject::GetDefault())
     , m_currentFramebuffer(m_defaultFramebuffer)
-    , m_drawcallCollections(1)
 {
     InitializeFullscreenMesh();
 
@@ -73,6 +73,9 @@ void Renderer::Render()
 {
     assert(m_currentCamera);
 
+    // The passes issue GL commands directly, they can't be recorded for the RenderThread
+    assert(DeviceGL::IsContextCurrent());
+
     for (auto& pass : m_passes)
     {
         SetCurrentFramebuffer(pass->GetTargetFramebuffer());
@@ -86,10 +89,9 @@ void Renderer::Reset()
 {
     m_lights.clear();
 
-    for (auto& collection : m_drawcallCollections)
-    {
-        collection.clear();
-    }
+    m_worldMatrices.clear();
+
+    m_drawcalls.clear();
 
     m_currentCamera = nullptr;
 }
@@ -103,96 +105,98 @@ int Renderer::AddRenderPass(std::unique_ptr<RenderPass> renderPass)
     return passIndex;
 }
 
-void Renderer::RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr,
+Renderer::ShaderProgramHandle Renderer::RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr,
     const UpdateTransformsFunction& updateTransformFunction,
     const UpdateLightsFunction& updateLightsFunction)
 {
-    assert(shaderProgramPtr);
+    ShaderProgramHandle handle = RegisterShaderProgram(shaderProgramPtr);
+    ShaderProgramInfo* shaderProgramInfo = m_shaderPrograms.Get(handle);
 
     if (updateTransformFunction)
     {
-        m_updateTransformsFunctions[shaderProgramPtr] = updateTransformFunction;
+        shaderProgramInfo->updateTransformsFunction = updateTransformFunction;
     }
 
     if (updateLightsFunction)
     {
-        m_updateLightsFunctions[shaderProgramPtr] = updateLightsFunction;
+        shaderProgramInfo->updateLightsFunction = updateLightsFunction;
+    }
+
+    return handle;
+}
+
+Renderer::ShaderProgramHandle Renderer::RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr,
+    const ShaderBindingTable& bindingTable)
+{
+    ShaderProgramHandle handle = RegisterShaderProgram(shaderProgramPtr);
+    m_shaderPrograms.Get(handle)->bindingTable = bindingTable;
+    return handle;
+}
+
+Renderer::ShaderProgramHandle Renderer::RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr)
+{
+    assert(shaderProgramPtr);
+
+    ShaderProgramHandle handle = GetShaderProgramHandle(*shaderProgramPtr);
+    if (!handle.IsValid())
+    {
+        ShaderProgramInfo shaderProgramInfo;
+        shaderProgramInfo.shaderProgram = shaderProgramPtr;
+        handle = m_shaderPrograms.Add(std::move(shaderProgramInfo));
+        m_shaderProgramHandles[shaderProgramPtr.get()] = handle;
+    }
+
+    return handle;
+}
+
+void Renderer::UnregisterShaderProgram(ShaderProgramHandle handle)
+{
+    if (const ShaderProgramInfo* shaderProgramInfo = m_shaderPrograms.Get(handle))
+    {
+        m_shaderProgramHandles.erase(shaderProgramInfo->shaderProgram.get());
+        m_shaderPrograms.Remove(handle);
     }
 }
 
-void Renderer::UpdateTransforms(std::shared_ptr<const ShaderProgram> shaderProgramPtr, unsigned int worldMatrixIndex, bool cameraChanged) const
+Renderer::ShaderProgramHandle Renderer::GetShaderProgramHandle(const ShaderProgram& shaderProgram) const
 {
-    const glm::mat4& worldMatrix = m_worldMatrices[worldMatrixIndex];
-    UpdateTransforms(shaderProgramPtr, worldMatrix);
+    const auto& itFind = m_shaderProgramHandles.find(&shaderProgram);
+    return itFind != m_shaderProgramHandles.end() ? itFind->second : ShaderProgramHandle();
 }
 
-void Renderer::UpdateTransforms(std::shared_ptr<const ShaderProgram> shaderProgramPtr, const glm::mat4& worldMatrix, bool cameraChanged) const
+const Renderer::ShaderProgramInfo* Renderer::GetShaderProgramInfo(ShaderProgramHandle handle) const
 {
-    const auto& itFind = m_updateTransformsFunctions.find(shaderProgramPtr);
-    if (itFind != m_updateTransformsFunctions.end())
+    return m_shaderPrograms.Get(handle);
+}
+
+void Renderer::UpdateTransforms(ShaderProgramHandle handle, const glm::mat4& worldMatrix, bool cameraChanged) const
+{
+    if (const ShaderProgramInfo* shaderProgramInfo = GetShaderProgramInfo(handle))
     {
-        itFind->second(*shaderProgramPtr, worldMatrix, *m_currentCamera, cameraChanged);
+        shaderProgramInfo->UpdateTransforms(worldMatrix, *m_currentCamera, cameraChanged);
     }
 }
 
+void Renderer::UpdateTransforms(ShaderProgramHandle handle, unsigned int worldMatrixIndex, bool cameraChanged) const
+{
+    UpdateTransforms(handle, GetWorldMatrix(worldMatrixIndex), cameraChanged);
+}
+
 Renderer::UpdateLightsFunction Renderer::GetDefaultUpdateLightsFunction(const ShaderProgram& shaderProgram)
 {
-    // Get lighting related uniform locations
-    ShaderProgram::Location lightIndirectLocation = shaderProgram.GetUniformLocation("LightIndirect");
-    ShaderProgram::Location lightColorLocation = shaderProgram.GetUniformLocation("LightColor");
-    ShaderProgram::Location lightPositionLocation = shaderProgram.GetUniformLocation("LightPosition");
-    ShaderProgram::Location lightDirectionLocation = shaderProgram.GetUniformLocation("LightDirection");
-    ShaderProgram::Location lightAttenuationLocation = shaderProgram.GetUniformLocation("LightAttenuation");
-    ShaderProgram::Location LightShadowEnabledLocation = shaderProgram.GetUniformLocation("LightShadowEnabled");
-    ShaderProgram::Location lightShadowMapLocation = shaderProgram.GetUniformLocation("LightShadowMap");
-    ShaderProgram::Location lightShadowMatrixLocation = shaderProgram.GetUniformLocation("LightShadowMatrix");
-    ShaderProgram::Location lightShadowBiasLocation = shaderProgram.GetUniformLocation("LightShadowBias");
+    // Get lighting related uniform locations, only the light semantics are used
+    ShaderBindingTable bindingTable(shaderProgram);
 
     return [=](const ShaderProgram& shaderProgram, std::span<const Light* const> lights, unsigned int& lightIndex) -> bool
     {
-        bool needsRender = lightIndex == 0;
-
-        shaderProgram.SetUniform(lightIndirectLocation, lightIndex == 0 ? 1 : 0);
-
-        if (lightIndex < lights.size())
-        {
-            const Light& light = *lights[lightIndex];
-            shaderProgram.SetUniform(lightColorLocation, light.GetColor() * light.GetIntensity());
-            shaderProgram.SetUniform(lightPositionLocation, light.GetPosition());
-            shaderProgram.SetUniform(lightDirectionLocation, light.GetDirection());
-            shaderProgram.SetUniform(lightAttenuationLocation, light.GetAttenuation());
-            shaderProgram.SetUniform(lightAttenuationLocation, light.GetAttenuation());
-
-            std::shared_ptr<const TextureObject> shadowMap = light.GetShadowMap();
-            shaderProgram.SetUniform(LightShadowEnabledLocation, shadowMap ? 1 : 0);
-            if (shadowMap)
-            {
-                shaderProgram.SetTexture(lightShadowMapLocation, 8, *shadowMap);
-                shaderProgram.SetUniform(lightShadowMatrixLocation, light.GetShadowMatrix());
-                shaderProgram.SetUniform(lightShadowBiasLocation, light.GetShadowBias());
-            }
-            needsRender = true;
-        }
-        else
-        {
-            // Disable light
-            shaderProgram.SetUniform(lightColorLocation, glm::vec3(0.0f));
-        }
-
-        lightIndex++;
-
-        return needsRender;
+        return bindingTable.UpdateLights(shaderProgram, lights, lightIndex);
     };
 }
 
-bool Renderer::UpdateLights(std::shared_ptr<const ShaderProgram> shaderProgramPtr, std::span<const Light* const> lights, unsigned int& lightIndex) const
+bool Renderer::UpdateLights(ShaderProgramHandle handle, std::span<const Light* const> lights, unsigned int& lightIndex) const
 {
-    const auto& itFind = m_updateLightsFunctions.find(shaderProgramPtr);
-    if (itFind != m_updateLightsFunctions.end())
-    {
-        return itFind->second(*shaderProgramPtr, lights, lightIndex);
-    }
-    return false;
+    const ShaderProgramInfo* shaderProgramInfo = GetShaderProgramInfo(handle);
+    return shaderProgramInfo && shaderProgramInfo->UpdateLights(lights, lightIndex);
 }
 
 std::span<const Light* const> Renderer::GetLights() const
@@ -205,9 +209,9 @@ void Renderer::AddLight(const Light& light)
     m_lights.push_back(&light);
 }
 
-std::span<const Renderer::DrawcallInfo> Renderer::GetDrawcalls(unsigned int collectionIndex) const
+std::span<const Renderer::DrawcallInfo> Renderer::GetDrawcalls() const
 {
-    return m_drawcallCollections[collectionIndex];
+    return m_drawcalls;
 }
 
 void Renderer::AddModel(const Model& model, const glm::mat4& worldMatrix)
@@ -215,31 +219,84 @@ void Renderer::AddModel(const Model& model, const glm::mat4& worldMatrix)
     unsigned int worldMatrixIndex = static_cast<unsigned int>(m_worldMatrices.size());
     m_worldMatrices.push_back(worldMatrix);
 
+    AppendModelDrawcalls(model, worldMatrixIndex, m_drawcalls);
+}
+
+void Renderer::AddDrawcalls(std::span<const glm::mat4> worldMatrices, std::span<const DrawcallInfo> drawcalls)
+{
+    unsigned int worldMatrixOffset = static_cast<unsigned int>(m_worldMatrices.size());
+    m_worldMatrices.insert(m_worldMatrices.end(), worldMatrices.begin(), worldMatrices.end());
+
+    m_drawcalls.reserve(m_drawcalls.size() + drawcalls.size());
+    for (const DrawcallInfo& drawcallInfo : drawcalls)
+    {
+        assert(drawcallInfo.worldMatrixIndex < worldMatrices.size());
+        m_drawcalls.emplace_back(drawcallInfo.material, worldMatrixOffset + drawcallInfo.worldMatrixIndex,
+            drawcallInfo.vao, drawcallInfo.drawcall, drawcallInfo.layerMask);
+    }
+}
+
+void Renderer::AppendModelDrawcalls(const Model& model, unsigned int worldMatrixIndex, std::vector<DrawcallInfo>& drawcalls)
+{
     const Mesh& mesh = model.GetMesh();
     for (unsigned int submeshIndex = 0; submeshIndex < mesh.GetSubmeshCount(); ++submeshIndex)
     {
-        DrawcallInfo drawcallInfo(model.GetMaterial(submeshIndex), worldMatrixIndex,
-            mesh.GetSubmeshVertexArray(submeshIndex), mesh.GetSubmeshDrawcall(submeshIndex));
+        const Material& material = model.GetMaterial(submeshIndex);
+
+        // The model can only restrict the layers of its materials
+        RenderLayerMask layerMask = model.GetLayerMask() & material.GetLayerMask();
+        if (layerMask == RenderLayer::None)
+            continue;
+
+        drawcalls.emplace_back(material, worldMatrixIndex,
+            mesh.GetSubmeshVertexArray(submeshIndex), mesh.GetSubmeshDrawcall(submeshIndex), layerMask);
+    }
+}
+
+void Renderer::ShaderProgramInfo::UpdateTransforms(const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged) const
+{
+    if (updateTransformsFunction)
+    {
+        updateTransformsFunction(*shaderProgram, worldMatrix, camera, cameraChanged);
+    }
+    else if (bindingTable.HasTransforms())
+    {
+        bindingTable.UpdateTransforms(*shaderProgram, worldMatrix, camera, cameraChanged);
+    }
+}
 
-        for (DrawcallCollection& collection : m_drawcallCollections)
-        {
-            collection.push_back(drawcallInfo);
-        }
+bool Renderer::ShaderProgramInfo::UpdateLights(std::span<const Light* const> lights, unsigned int& lightIndex) const
+{
+    if (updateLightsFunction)
+    {
+        return updateLightsFunction(*shaderProgram, lights, lightIndex);
+    }
+    else if (bindingTable.HasLights())
+    {
+        return bindingTable.UpdateLights(*shaderProgram, lights, lightIndex);
     }
+    return false;
+}
+
+const glm::mat4& Renderer::GetWorldMatrix(unsigned int worldMatrixIndex) const
+{
+    assert(worldMatrixIndex < m_worldMatrices.size());
+    return m_worldMatrices[worldMatrixIndex];
 }
 
 void Renderer::PrepareDrawcall(const DrawcallInfo& drawcallInfo)
 {
-    std::shared_ptr<const ShaderProgram> shaderProgram = drawcallInfo.material.GetShaderProgram();
+    // The placeholder is used if the material is not ready
+    const Material& material = drawcallInfo.material.GetRenderMaterial();
 
     // TODO: Room for optimization here, caching current material, current worldMatrixIndex and current VAO
 
     // Setup material
-    drawcallInfo.material.Use();
+    material.Use();
 
     // Setup world matrix
     // Setup camera
-    UpdateTransforms(shaderProgram, drawcallInfo.worldMatrixIndex);
+    UpdateTransforms(GetShaderProgramHandle(*material.GetShaderProgram()), drawcallInfo.worldMatrixIndex);
 
     // Setup VAO
     drawcallInfo.vao.Bind();
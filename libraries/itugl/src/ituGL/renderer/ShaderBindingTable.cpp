@@ -0,0 +1,189 @@
+#include <ituGL/renderer/ShaderBindingTable.h>
+
+#include <ituGL/camera/Camera.h>
+#include <ituGL/lighting/Light.h>
+#include <ituGL/texture/TextureObject.h>
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+ShaderBindingTable::ShaderBindingTable()
+    : m_cachedValues{}
+    , m_cachedMask(0)
+    , m_hasTransforms(false)
+    , m_hasLights(false)
+{
+    m_locations.fill(-1);
+}
+
+ShaderBindingTable::ShaderBindingTable(const ShaderProgram& shaderProgram)
+    : ShaderBindingTable()
+{
+    for (int i = 0; i < SemanticCount; ++i)
+    {
+        Semantic semantic = static_cast<Semantic>(i);
+        SetLocation(semantic, shaderProgram, GetDefaultName(semantic));
+    }
+}
+
+const char* ShaderBindingTable::GetDefaultName(Semantic semantic)
+{
+    switch (semantic)
+    {
+    case Semantic::WorldMatrix: return "WorldMatrix";
+    case Semantic::ViewMatrix: return "ViewMatrix";
+    case Semantic::ProjMatrix: return "ProjMatrix";
+    case Semantic::ViewProjMatrix: return "ViewProjMatrix";
+    case Semantic::WorldViewMatrix: return "WorldViewMatrix";
+    case Semantic::WorldViewProjMatrix: return "WorldViewProjMatrix";
+    case Semantic::InvViewMatrix: return "InvViewMatrix";
+    case Semantic::InvProjMatrix: return "InvProjMatrix";
+    case Semantic::InvViewProjMatrix: return "InvViewProjMatrix";
+    case Semantic::CameraPosition: return "CameraPosition";
+    case Semantic::LightIndirect: return "LightIndirect";
+    case Semantic::LightColor: return "LightColor";
+    case Semantic::LightPosition: return "LightPosition";
+    case Semantic::LightDirection: return "LightDirection";
+    case Semantic::LightAttenuation: return "LightAttenuation";
+    case Semantic::LightShadowEnabled: return "LightShadowEnabled";
+    case Semantic::LightShadowMap: return "LightShadowMap";
+    case Semantic::LightShadowMatrix: return "LightShadowMatrix";
+    case Semantic::LightShadowBias: return "LightShadowBias";
+    default:
+        assert(false);
+        return "";
+    }
+}
+
+ShaderProgram::Location ShaderBindingTable::GetLocation(Semantic semantic) const
+{
+    return m_locations[static_cast<int>(semantic)];
+}
+
+void ShaderBindingTable::SetLocation(Semantic semantic, ShaderProgram::Location location)
+{
+    int index = static_cast<int>(semantic);
+    m_locations[index] = location;
+    m_cachedMask &= ~(1u << index);
+
+    const int firstLightIndex = static_cast<int>(Semantic::LightIndirect);
+    m_hasTransforms = std::any_of(m_locations.begin(), m_locations.begin() + firstLightIndex, [](ShaderProgram::Location l) { return l >= 0; });
+    m_hasLights = std::any_of(m_locations.begin() + firstLightIndex, m_locations.end(), [](ShaderProgram::Location l) { return l >= 0; });
+}
+
+void ShaderBindingTable::SetLocation(Semantic semantic, const ShaderProgram& shaderProgram, const char* uniformName)
+{
+    SetLocation(semantic, shaderProgram.GetUniformLocation(uniformName));
+}
+
+void ShaderBindingTable::AddDefaultNames(ShaderUniformCollection::NameSet& names) const
+{
+    for (int i = 0; i < SemanticCount; ++i)
+    {
+        if (m_locations[i] >= 0)
+        {
+            names.insert(GetDefaultName(static_cast<Semantic>(i)));
+        }
+    }
+}
+
+void ShaderBindingTable::UpdateTransforms(const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged) const
+{
+    const glm::mat4& viewMatrix = camera.GetViewMatrix();
+    const glm::mat4& projMatrix = camera.GetProjectionMatrix();
+    glm::mat4 viewProjMatrix = projMatrix * viewMatrix;
+
+    // Values that only depend on the camera
+    if (cameraChanged)
+    {
+        Upload(shaderProgram, Semantic::ViewMatrix, viewMatrix);
+        Upload(shaderProgram, Semantic::ProjMatrix, projMatrix);
+        Upload(shaderProgram, Semantic::ViewProjMatrix, viewProjMatrix);
+
+        if (IsBound(Semantic::InvViewMatrix))
+            Upload(shaderProgram, Semantic::InvViewMatrix, glm::inverse(viewMatrix));
+        if (IsBound(Semantic::InvProjMatrix))
+            Upload(shaderProgram, Semantic::InvProjMatrix, glm::inverse(projMatrix));
+        if (IsBound(Semantic::InvViewProjMatrix))
+            Upload(shaderProgram, Semantic::InvViewProjMatrix, glm::inverse(viewProjMatrix));
+        if (IsBound(Semantic::CameraPosition))
+            Upload(shaderProgram, Semantic::CameraPosition, camera.ExtractTranslation());
+    }
+
+    // Values that depend on the object
+    Upload(shaderProgram, Semantic::WorldMatrix, worldMatrix);
+
+    if (IsBound(Semantic::WorldViewMatrix))
+        Upload(shaderProgram, Semantic::WorldViewMatrix, viewMatrix * worldMatrix);
+    if (IsBound(Semantic::WorldViewProjMatrix))
+        Upload(shaderProgram, Semantic::WorldViewProjMatrix, viewProjMatrix * worldMatrix);
+}
+
+bool ShaderBindingTable::UpdateLights(const ShaderProgram& shaderProgram, std::span<const Light* const> lights, unsigned int& lightIndex) const
+{
+    bool needsRender = lightIndex == 0;
+
+    Upload(shaderProgram, Semantic::LightIndirect, lightIndex == 0 ? 1 : 0);
+
+    if (lightIndex < lights.size())
+    {
+        const Light& light = *lights[lightIndex];
+        Upload(shaderProgram, Semantic::LightColor, light.GetColor() * light.GetIntensity());
+        Upload(shaderProgram, Semantic::LightPosition, light.GetPosition());
+        Upload(shaderProgram, Semantic::LightDirection, light.GetDirection());
+        Upload(shaderProgram, Semantic::LightAttenuation, light.GetAttenuation());
+
+        std::shared_ptr<const TextureObject> shadowMap = light.GetShadowMap();
+        Upload(shaderProgram, Semantic::LightShadowEnabled, shadowMap ? 1 : 0);
+        if (shadowMap)
+        {
+            // The texture unit could have been used by a material. The binding cache skips it if it is still bound
+            if (IsBound(Semantic::LightShadowMap))
+            {
+                TextureObject::SetActiveTexture(ShadowMapTextureUnit);
+                shadowMap->Bind();
+                Upload(shaderProgram, Semantic::LightShadowMap, ShadowMapTextureUnit);
+            }
+            Upload(shaderProgram, Semantic::LightShadowMatrix, light.GetShadowMatrix());
+            Upload(shaderProgram, Semantic::LightShadowBias, light.GetShadowBias());
+        }
+        needsRender = true;
+    }
+    else
+    {
+        // Disable light
+        Upload(shaderProgram, Semantic::LightColor, glm::vec3(0.0f));
+    }
+
+    lightIndex++;
+
+    return needsRender;
+}
+
+void ShaderBindingTable::Invalidate() const
+{
+    m_cachedMask = 0;
+}
+
+template<typename T>
+void ShaderBindingTable::Upload(const ShaderProgram& shaderProgram, Semantic semantic, const T& value) const
+{
+    static_assert(sizeof(T) <= sizeof(CachedValue));
+
+    int index = static_cast<int>(semantic);
+    ShaderProgram::Location location = m_locations[index];
+    if (location < 0)
+        return;
+
+    // Skip the upload if the value is the same as the last time
+    CachedValue& cachedValue = m_cachedValues[index];
+    unsigned int bit = 1u << index;
+    if ((m_cachedMask & bit) != 0 && std::memcmp(cachedValue.data(), &value, sizeof(T)) == 0)
+        return;
+
+    std::memcpy(cachedValue.data(), &value, sizeof(T));
+    m_cachedMask |= bit;
+
+    shaderProgram.SetUniform(location, value);
+}
@@ -7,10 +7,10 @@
 #include <ituGL/texture/Texture2DObject.h>
 #include <ituGL/texture/FramebufferObject.h>
 
-ShadowMapRenderPass::ShadowMapRenderPass(std::shared_ptr<Light> light, std::shared_ptr<const Material> material, int drawcallCollectionIndex)
+ShadowMapRenderPass::ShadowMapRenderPass(std::shared_ptr<Light> light, std::shared_ptr<const Material> material, RenderLayerMask layerMask)
     : m_light(light)
     , m_material(material)
-    , m_drawcallCollectionIndex(drawcallCollectionIndex)
+    , m_layerMask(layerMask)
     , m_volumeCenter(0.0f)
     , m_volumeSize(1.0f)
 {
@@ -43,14 +43,12 @@ void ShadowMapRenderPass::Render()
     Renderer& renderer = GetRenderer();
     DeviceGL& device = renderer.GetDevice();
 
-    const auto& drawcallCollection = renderer.GetDrawcalls(m_drawcallCollectionIndex);
+    // Record the drawcalls in our layers
+    m_commandList.Clear();
+    m_commandList.Record(renderer, m_layerMask);
 
     device.Clear(false, Color(), true, 1.0f);
 
-    // Use shadow map shader
-    m_material->Use();
-    std::shared_ptr<const ShaderProgram> shaderProgram = m_material->GetShaderProgram();
-
     // Backup current viewport
     glm::ivec4 currentViewport;
     device.GetViewport(currentViewport.x, currentViewport.y, currentViewport.z, currentViewport.w);
@@ -66,21 +64,8 @@ void ShadowMapRenderPass::Render()
     InitLightCamera(lightCamera);
     renderer.SetCurrentCamera(lightCamera);
 
-    // for all drawcalls
-    bool first = true;
-    for (const Renderer::DrawcallInfo& drawcallInfo : drawcallCollection)
-    {
-        // Bind the vao
-        drawcallInfo.vao.Bind();
-
-        // Set up object matrix
-        renderer.UpdateTransforms(shaderProgram, drawcallInfo.worldMatrixIndex, first);
-
-        // Render drawcall
-        drawcallInfo.drawcall.Draw();
-
-        first = false;
-    }
+    // Render all the commands with the shadow map material
+    m_commandList.Submit(renderer, *m_material);
 
     m_light->SetShadowMatrix(lightCamera.GetViewProjectionMatrix());
 
@@ -0,0 +1,122 @@
+#include <ituGL/scene/RendererSceneCollector.h>
+
+#include <ituGL/core/JobSystem.h>
+#include <ituGL/geometry/Model.h>
+#include <ituGL/scene/Scene.h>
+#include <ituGL/scene/SceneVisitor.h>
+#include <ituGL/scene/SceneCamera.h>
+#include <ituGL/scene/SceneLight.h>
+#include <ituGL/scene/SceneModel.h>
+#include <ituGL/scene/Transform.h>
+#include <algorithm>
+#include <cassert>
+
+// Visitor that adds cameras and lights to the renderer, and only gathers the models
+class GatherSceneVisitor : public SceneVisitor
+{
+public:
+    GatherSceneVisitor(Renderer& renderer, std::vector<SceneModel*>& models) : m_renderer(renderer), m_models(models)
+    {
+    }
+
+    void VisitCamera(SceneCamera& sceneCamera) override
+    {
+        assert(!m_renderer.HasCamera()); // Currently, only one camera per scene supported
+        m_renderer.SetCurrentCamera(*sceneCamera.GetCamera());
+    }
+
+    void VisitLight(SceneLight& sceneLight) override
+    {
+        m_renderer.AddLight(*sceneLight.GetLight());
+    }
+
+    void VisitModel(SceneModel& sceneModel) override
+    {
+        m_models.push_back(&sceneModel);
+    }
+
+private:
+    Renderer& m_renderer;
+    std::vector<SceneModel*>& m_models;
+};
+
+RendererSceneCollector::RendererSceneCollector(Renderer& renderer, JobSystem& jobSystem)
+    : m_renderer(renderer)
+    , m_jobSystem(jobSystem)
+    , m_chunkSize(256)
+{
+}
+
+void RendererSceneCollector::SetCullFunction(const CullFunction& cullFunction)
+{
+    m_cullFunction = cullFunction;
+}
+
+void RendererSceneCollector::SetChunkSize(unsigned int chunkSize)
+{
+    assert(chunkSize > 0);
+    m_chunkSize = chunkSize;
+}
+
+void RendererSceneCollector::Collect(Scene& scene)
+{
+    // Gather the nodes. Cheap, it only stores pointers
+    m_models.clear();
+    GatherSceneVisitor gatherVisitor(m_renderer, m_models);
+    scene.AcceptVisitor(gatherVisitor);
+
+    unsigned int modelCount = static_cast<unsigned int>(m_models.size());
+
+    // Refresh the dirty transforms serially. Parents are updated before their children, and shared parents only once
+    m_worldMatrices.resize(modelCount);
+    for (unsigned int modelIndex = 0; modelIndex < modelCount; ++modelIndex)
+    {
+        const SceneModel& sceneModel = *m_models[modelIndex];
+        assert(sceneModel.GetTransform());
+        m_worldMatrices[modelIndex] = sceneModel.GetTransform()->GetTransformMatrix();
+    }
+
+    unsigned int chunkCount = (modelCount + m_chunkSize - 1) / m_chunkSize;
+    if (m_buckets.size() < chunkCount)
+    {
+        m_buckets.resize(chunkCount);
+    }
+
+    // Cull and emit drawcalls in parallel
+    m_jobSystem.ParallelFor(0, chunkCount, [this](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int chunkIndex = begin; chunkIndex < end; ++chunkIndex)
+            {
+                CollectChunk(chunkIndex);
+            }
+        }, 1, "CollectScene");
+
+    // Merge in chunk order
+    for (unsigned int chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+    {
+        const Bucket& bucket = m_buckets[chunkIndex];
+        m_renderer.AddDrawcalls(bucket.worldMatrices, bucket.drawcalls);
+    }
+}
+
+void RendererSceneCollector::CollectChunk(unsigned int chunkIndex)
+{
+    Bucket& bucket = m_buckets[chunkIndex];
+    bucket.worldMatrices.clear();
+    bucket.drawcalls.clear();
+
+    unsigned int begin = chunkIndex * m_chunkSize;
+    unsigned int end = std::min(begin + m_chunkSize, static_cast<unsigned int>(m_models.size()));
+    for (unsigned int modelIndex = begin; modelIndex < end; ++modelIndex)
+    {
+        const SceneModel& sceneModel = *m_models[modelIndex];
+        const glm::mat4& worldMatrix = m_worldMatrices[modelIndex];
+
+        if (m_cullFunction && !m_cullFunction(sceneModel, worldMatrix))
+            continue;
+
+        unsigned int worldMatrixIndex = static_cast<unsigned int>(bucket.worldMatrices.size());
+        bucket.worldMatrices.push_back(worldMatrix);
+        Renderer::AppendModelDrawcalls(*sceneModel.GetModel(), worldMatrixIndex, bucket.drawcalls);
+    }
+}
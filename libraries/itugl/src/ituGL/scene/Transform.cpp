@@ -1,8 +1,10 @@
 #include <ituGL/scene/Transform.h>
 
 #include <glm/ext/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/matrix_decompose.hpp>
 
-Transform::Transform() : m_translation(0, 0, 0), m_rotation(0, 0, 0), m_scale(1, 1, 1), m_matrix(1.0f), m_dirty(false)
+Transform::Transform() : m_translation(0, 0, 0), m_rotation(0, 0, 0), m_scale(1, 1, 1), m_matrix(1.0f), m_dirty(false), m_version(0), m_parentVersion(0)
 {
 }
 
@@ -33,13 +35,35 @@ glm::mat4 Transform::GetTransformMatrix() const
         if (m_parent)
         {
             m_matrix = m_parent->GetTransformMatrix() * m_matrix;
+            m_parentVersion = m_parent->m_version;
         }
         m_dirty = false;
+        ++m_version;
     }
     return m_matrix;
 }
 
 bool Transform::IsDirty() const
 {
-    return m_dirty || (m_parent && m_parent->IsDirty());
+    return m_dirty || (m_parent && (m_parent->IsDirty() || m_parent->m_version != m_parentVersion));
+}
+
+glm::mat4 Transform::Interpolate(const glm::mat4& from, const glm::mat4& to, float t)
+{
+    glm::vec3 fromScale, toScale;
+    glm::quat fromRotation, toRotation;
+    glm::vec3 fromTranslation, toTranslation;
+    glm::vec3 skew;
+    glm::vec4 perspective;
+    if (!glm::decompose(from, fromScale, fromRotation, fromTranslation, skew, perspective) ||
+        !glm::decompose(to, toScale, toRotation, toTranslation, skew, perspective))
+    {
+        // Degenerate matrix, no interpolation possible
+        return t < 0.5f ? from : to;
+    }
+
+    glm::vec3 translation = glm::mix(fromTranslation, toTranslation, t);
+    glm::quat rotation = glm::slerp(fromRotation, toRotation, t);
+    glm::vec3 scale = glm::mix(fromScale, toScale, t);
+    return glm::translate(glm::identity<glm::mat4>(), translation) * glm::mat4_cast(rotation) * glm::scale(glm::identity<glm::mat4>(), scale);
 }
@@ -1,8 +1,9 @@
 #include <ituGL/shader/Material.h>
+#include <ituGL/shader/ProgramPipeline.h>
 #include <ituGL/core/DeviceGL.h>
 #include <cassert>
 
-Material::Material() : Material(nullptr)
+Material::Material() : Material(std::shared_ptr<ShaderProgram>())
 {
 }
 
@@ -19,14 +20,85 @@ Material::Material(std::shared_ptr<ShaderProgram> shaderProgram, const NameSet&
     , m_blendEquations{ BlendEquation::None }
     , m_blendParams{ BlendParam::One, BlendParam::Zero, BlendParam::One, BlendParam::Zero }
     , m_cullMode(CullMode::Back)
+    , m_layerMask(RenderLayer::Opaque | RenderLayer::ShadowCaster)
 {
 }
 
+Material::Material(ShaderProgramProvider shaderProgramProvider, std::shared_ptr<const Material> placeholderMaterial,
+    const NameSet& filteredUniforms, MaterialSetupFunction materialSetupFunction)
+    : Material()
+{
+    assert(shaderProgramProvider);
+    assert(placeholderMaterial && placeholderMaterial->IsShaderProgramReady());
+    m_shaderProgramProvider = shaderProgramProvider;
+    m_placeholderMaterial = placeholderMaterial;
+    m_filteredUniforms = filteredUniforms;
+    m_materialSetupFunction = materialSetupFunction;
+}
+
+Material::Material(std::shared_ptr<const Material> parent)
+    : ShaderUniformCollection(parent)
+    , m_shaderSetupFunction(parent->m_shaderSetupFunction)
+    , m_programPipeline(parent->m_programPipeline)
+    , m_depthTestFunction(parent->m_depthTestFunction)
+    , m_depthWrite(parent->m_depthWrite)
+    , m_stencilTestFunctions(parent->m_stencilTestFunctions)
+    , m_stencilRefValues(parent->m_stencilRefValues)
+    , m_stencilMasks(parent->m_stencilMasks)
+    , m_stencilFail(parent->m_stencilFail)
+    , m_stencilDepthFail(parent->m_stencilDepthFail)
+    , m_stencilDepthPass(parent->m_stencilDepthPass)
+    , m_blendEquations(parent->m_blendEquations)
+    , m_blendParams(parent->m_blendParams)
+    , m_cullMode(parent->m_cullMode)
+    , m_blendColor(parent->m_blendColor)
+    , m_layerMask(parent->m_layerMask)
+{
+    // Instances need the properties of the parent
+    assert(parent->IsShaderProgramReady());
+}
+
 void Material::SetShaderSetupFunction(ShaderSetupFunction shaderSetupFunction)
 {
     m_shaderSetupFunction = shaderSetupFunction;
 }
 
+std::shared_ptr<const ProgramPipeline> Material::GetProgramPipeline() const
+{
+    return m_programPipeline;
+}
+
+void Material::SetProgramPipeline(std::shared_ptr<const ProgramPipeline> programPipeline)
+{
+    assert(!programPipeline || m_shaderProgram->IsSeparable());
+    m_programPipeline = programPipeline;
+}
+
+bool Material::IsShaderProgramReady() const
+{
+    return !m_shaderProgramProvider;
+}
+
+bool Material::UpdateShaderProgram()
+{
+    if (m_shaderProgramProvider)
+    {
+        std::shared_ptr<ShaderProgram> shaderProgram = m_shaderProgramProvider();
+        if (!shaderProgram)
+        {
+            return false;
+        }
+
+        InitializeShaderProgram(shaderProgram);
+    }
+    return true;
+}
+
+const Material& Material::GetRenderMaterial() const
+{
+    return m_shaderProgramProvider ? *m_placeholderMaterial : *this;
+}
+
 Material::TestFunction Material::GetDepthTestFunction() const
 {
     return m_depthTestFunction;
@@ -181,12 +253,29 @@ void Material::SetCullMode(CullMode cullmode)
     m_cullMode = cullmode;
 }
 
+RenderLayerMask Material::GetLayerMask() const
+{
+    return m_layerMask;
+}
+
+void Material::SetLayerMask(RenderLayerMask layerMask)
+{
+    m_layerMask = layerMask;
+}
+
 void Material::Use(OverrideFlags overrideFlags) const
 {
     assert(m_shaderProgram);
 
-    // Set the shader program as the one currently in use
-    m_shaderProgram->Use();
+    // Set the shader program as the one currently in use, or the pipeline it belongs to
+    if (m_programPipeline)
+    {
+        m_programPipeline->Bind();
+    }
+    else
+    {
+        m_shaderProgram->Use();
+    }
 
     // Set the value of all the uniforms stored as properties
     SetUniforms();
@@ -222,6 +311,21 @@ void Material::Use(OverrideFlags overrideFlags) const
     }
 }
 
+void Material::InitializeShaderProgram(std::shared_ptr<ShaderProgram> shaderProgram)
+{
+    ChangeShader(shaderProgram, m_filteredUniforms);
+
+    m_shaderProgramProvider = nullptr;
+    m_placeholderMaterial.reset();
+    m_filteredUniforms.clear();
+
+    if (m_materialSetupFunction)
+    {
+        m_materialSetupFunction(*this);
+        m_materialSetupFunction = nullptr;
+    }
+}
+
 void Material::UseDepthTest() const
 {
     // Depth function
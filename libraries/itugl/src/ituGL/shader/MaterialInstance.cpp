@@ -0,0 +1,14 @@
+#include <ituGL/shader/MaterialInstance.h>
+
+#include <cassert>
+
+MaterialInstance::MaterialInstance(std::shared_ptr<const Material> parent) : Material(parent)
+{
+}
+
+const Material& MaterialInstance::GetParentMaterial() const
+{
+    // The parent collection is always a Material, it was passed in the constructor
+    assert(GetParent());
+    return static_cast<const Material&>(*GetParent());
+}
@@ -0,0 +1,92 @@
+#include <ituGL/shader/ProgramPipeline.h>
+
+#include <ituGL/shader/ShaderProgram.h>
+#include <cassert>
+
+// Create the object initially null, get object handle and generate 1 program pipeline
+ProgramPipeline::ProgramPipeline() : Object(NullHandle)
+{
+    Handle& handle = GetHandle();
+    glGenProgramPipelines(1, &handle);
+}
+
+// Get object handle and delete 1 program pipeline
+ProgramPipeline::~ProgramPipeline()
+{
+    Handle& handle = GetHandle();
+    glDeleteProgramPipelines(1, &handle);
+}
+
+ProgramPipeline::ProgramPipeline(ProgramPipeline&& programPipeline) noexcept
+    : Object(std::move(programPipeline))
+    , m_stagePrograms(std::move(programPipeline.m_stagePrograms))
+{
+}
+
+ProgramPipeline& ProgramPipeline::operator = (ProgramPipeline&& programPipeline) noexcept
+{
+    Object::operator=(std::move(programPipeline));
+    m_stagePrograms = std::move(programPipeline.m_stagePrograms);
+    return *this;
+}
+
+void ProgramPipeline::Bind() const
+{
+    assert(IsValid());
+    glUseProgram(0);
+    glBindProgramPipeline(GetHandle());
+}
+
+void ProgramPipeline::Unbind()
+{
+    glBindProgramPipeline(NullHandle);
+}
+
+void ProgramPipeline::SetStages(GLbitfield stageMask, std::shared_ptr<const ShaderProgram> shaderProgram)
+{
+    assert(IsValid());
+    assert(!shaderProgram || shaderProgram->IsSeparable());
+
+    glUseProgramStages(GetHandle(), stageMask, shaderProgram ? shaderProgram->GetHandle() : NullHandle);
+
+    for (unsigned int i = 0; i < StageCount; ++i)
+    {
+        if (stageMask & (1u << i))
+        {
+            m_stagePrograms[i] = shaderProgram;
+        }
+    }
+}
+
+std::shared_ptr<const ShaderProgram> ProgramPipeline::GetStageProgram(Stage stage) const
+{
+    return m_stagePrograms[GetStageIndex(stage)];
+}
+
+bool ProgramPipeline::Validate() const
+{
+    assert(IsValid());
+    glValidateProgramPipeline(GetHandle());
+
+    GLint valid;
+    glGetProgramPipelineiv(GetHandle(), GL_VALIDATE_STATUS, &valid);
+    return valid;
+}
+
+void ProgramPipeline::GetValidationErrors(std::span<char> errors) const
+{
+    assert(IsValid());
+    glGetProgramPipelineInfoLog(GetHandle(), static_cast<GLsizei>(errors.size()), nullptr, errors.data());
+}
+
+// The stage bits are consecutive, from GL_VERTEX_SHADER_BIT (1) to GL_COMPUTE_SHADER_BIT (32)
+unsigned int ProgramPipeline::GetStageIndex(Stage stage)
+{
+    unsigned int index = 0;
+    while ((1u << index) != stage)
+    {
+        ++index;
+        assert(index < StageCount);
+    }
+    return index;
+}
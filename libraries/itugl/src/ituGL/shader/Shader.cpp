@@ -1,5 +1,6 @@
 #include <ituGL/shader/Shader.h>
 
+#include <ituGL/core/DeviceGL.h>
 #include <cassert>
 
 Shader::Shader(Type type) : Object(NullHandle)
@@ -62,6 +63,25 @@ bool Shader::Compile()
     return IsCompiled();
 }
 
+void Shader::StartCompile()
+{
+    assert(IsValid());
+
+    glCompileShader(GetHandle());
+}
+
+bool Shader::IsCompileCompleted() const
+{
+    assert(IsValid());
+
+    GLint completed = GL_TRUE;
+    if (DeviceGL::IsParallelShaderCompileSupported())
+    {
+        glGetShaderiv(GetHandle(), GL_COMPLETION_STATUS_KHR, &completed);
+    }
+    return completed;
+}
+
 // Check if the shader has been successfully compiled
 bool Shader::IsCompiled() const
 {
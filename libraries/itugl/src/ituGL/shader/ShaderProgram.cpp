@@ -2,13 +2,15 @@
 
 #include <ituGL/shader/Shader.h>
 #include <ituGL/texture/TextureObject.h>
+#include <ituGL/core/DeviceGL.h>
+#include <algorithm>
 #include <cassert>
 
 #ifndef NDEBUG
 ShaderProgram::Handle ShaderProgram::s_usedHandle = ShaderProgram::NullHandle;
 #endif
 
-ShaderProgram::ShaderProgram() : Object(NullHandle)
+ShaderProgram::ShaderProgram() : Object(NullHandle), m_uniformLocationsFilled(false)
 {
     Handle& handle = GetHandle();
     handle = glCreateProgram();
@@ -24,13 +26,24 @@ ShaderProgram::~ShaderProgram()
     }
 }
 
-ShaderProgram::ShaderProgram(ShaderProgram&& shaderProgram) noexcept : Object(std::move(shaderProgram))
+ShaderProgram::ShaderProgram(ShaderProgram&& shaderProgram) noexcept
+    : Object(std::move(shaderProgram))
+    , m_textureUnits(std::move(shaderProgram.m_textureUnits))
+    , m_appliedUniforms(std::move(shaderProgram.m_appliedUniforms))
+    , m_uniformLocations(std::move(shaderProgram.m_uniformLocations))
+    , m_uniformLocationsFilled(shaderProgram.m_uniformLocationsFilled)
 {
+    shaderProgram.InvalidateAppliedUniforms();
 }
 
 ShaderProgram& ShaderProgram::operator = (ShaderProgram&& shaderProgram) noexcept
 {
     Object::operator=(std::move(shaderProgram));
+    m_textureUnits = std::move(shaderProgram.m_textureUnits);
+    m_appliedUniforms = std::move(shaderProgram.m_appliedUniforms);
+    m_uniformLocations = std::move(shaderProgram.m_uniformLocations);
+    m_uniformLocationsFilled = shaderProgram.m_uniformLocationsFilled;
+    shaderProgram.InvalidateAppliedUniforms();
     return *this;
 }
 
@@ -49,6 +62,29 @@ bool ShaderProgram::Build(const Shader& computeShader)
     return Link();
 }
 
+// Build (Attach and link) a separable shader program with a single shader of any type
+bool ShaderProgram::BuildSeparable(const Shader& shader)
+{
+    SetSeparable(true);
+    AttachShader(shader);
+    return Link();
+}
+
+void ShaderProgram::SetSeparable(bool separable)
+{
+    assert(IsValid());
+    glProgramParameteri(GetHandle(), GL_PROGRAM_SEPARABLE, separable ? GL_TRUE : GL_FALSE);
+}
+
+bool ShaderProgram::IsSeparable() const
+{
+    assert(IsValid());
+
+    GLint separable;
+    glGetProgramiv(GetHandle(), GL_PROGRAM_SEPARABLE, &separable);
+    return separable;
+}
+
 // Build (Attach and link) all shaders provided for the rasterization pipeline
 bool ShaderProgram::Build(const Shader& vertexShader, const Shader& fragmentShader,
     const Shader* tesselationControlShader, const Shader* tesselationEvaluationShader,
@@ -82,6 +118,31 @@ bool ShaderProgram::Build(const Shader& vertexShader, const Shader& fragmentShad
     return Link();
 }
 
+// Compile status is not checked here, so the driver doesn't have to finish compiling the shaders yet
+void ShaderProgram::StartBuild(std::span<const Shader> shaders)
+{
+    assert(IsValid());
+    for (const Shader& shader : shaders)
+    {
+        assert(shader.IsValid());
+        glAttachShader(GetHandle(), shader.GetHandle());
+    }
+    glLinkProgram(GetHandle());
+    OnLinked();
+}
+
+bool ShaderProgram::IsLinkCompleted() const
+{
+    assert(IsValid());
+
+    GLint completed = GL_TRUE;
+    if (DeviceGL::IsParallelShaderCompileSupported())
+    {
+        glGetProgramiv(GetHandle(), GL_COMPLETION_STATUS_KHR, &completed);
+    }
+    return completed;
+}
+
 // Attach a shader to be linked
 void ShaderProgram::AttachShader(const Shader& shader)
 {
@@ -97,9 +158,19 @@ bool ShaderProgram::Link()
 {
     assert(IsValid());
     glLinkProgram(GetHandle());
+    OnLinked();
     return IsLinked();
 }
 
+// Linking resets the uniforms
+void ShaderProgram::OnLinked()
+{
+    InvalidateTextureUnits();
+    InvalidateAppliedUniforms();
+    m_uniformLocations.clear();
+    m_uniformLocationsFilled = false;
+}
+
 // Check if shaders have been linked to create a valid program
 bool ShaderProgram::IsLinked() const
 {
@@ -110,6 +181,41 @@ bool ShaderProgram::IsLinked() const
     return success;
 }
 
+void ShaderProgram::SetBinaryRetrievable(bool retrievable)
+{
+    assert(IsValid());
+    glProgramParameteri(GetHandle(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, retrievable ? GL_TRUE : GL_FALSE);
+}
+
+bool ShaderProgram::GetBinary(GLenum& binaryFormat, std::vector<std::byte>& binary) const
+{
+    assert(IsValid());
+    assert(IsLinked());
+
+    GLint binaryLength = 0;
+    glGetProgramiv(GetHandle(), GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0)
+    {
+        binary.clear();
+        return false;
+    }
+
+    binary.resize(binaryLength);
+    GLsizei length = 0;
+    glGetProgramBinary(GetHandle(), binaryLength, &length, &binaryFormat, binary.data());
+    binary.resize(length);
+    return length > 0;
+}
+
+// Loading a binary works as linking, including the link status
+bool ShaderProgram::LoadBinary(GLenum binaryFormat, std::span<const std::byte> binary)
+{
+    assert(IsValid());
+    glProgramBinary(GetHandle(), binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+    OnLinked();
+    return IsLinked();
+}
+
 // Get a string with linking error messages
 // The max length of the string returned is determined by the capacity of the span
 void ShaderProgram::GetLinkingErrors(std::span<char> errors) const
@@ -139,11 +245,62 @@ ShaderProgram::Location ShaderProgram::GetAttributeLocation(const char* name) co
 }
 
 // Find a uniform location by name
-ShaderProgram::Location ShaderProgram::GetUniformLocation(const char* name) const
+ShaderProgram::Location ShaderProgram::GetUniformLocation(UniformName name) const
 {
     assert(IsValid());
     assert(IsLinked());
-    return glGetUniformLocation(GetHandle(), name);
+
+    if (!m_uniformLocationsFilled)
+    {
+        FillUniformLocations();
+    }
+
+    auto itLocation = m_uniformLocations.find(name.GetHash());
+    if (itLocation != m_uniformLocations.end())
+    {
+        assert(itLocation->second.name == name.GetName());
+        return itLocation->second.location;
+    }
+
+    // Array elements, or names that are not active uniforms. Stored too, even if not found
+    Location location = glGetUniformLocation(GetHandle(), name.GetName());
+    UniformLocationEntry& entry = m_uniformLocations[name.GetHash()];
+    entry.location = location;
+#ifndef NDEBUG
+    entry.name = name.GetName();
+#endif
+    return location;
+}
+
+void ShaderProgram::FillUniformLocations() const
+{
+    unsigned int uniformCount = GetUniformCount();
+    for (unsigned int i = 0; i < uniformCount; ++i)
+    {
+        int size;
+        GLenum glType;
+        char uniformName[256];
+        GetUniformInfo(i, size, glType, std::span(uniformName, sizeof(uniformName)));
+
+        UniformLocationEntry entry;
+        entry.location = glGetUniformLocation(GetHandle(), uniformName);
+
+        // Arrays are reported as "name[0]", they can be found by the name of the array too
+        std::string name(uniformName);
+        if (name.ends_with("[0]"))
+        {
+            std::string arrayName = name.substr(0, name.size() - 3);
+#ifndef NDEBUG
+            entry.name = arrayName;
+#endif
+            m_uniformLocations[UniformName::ComputeHash(arrayName.c_str())] = entry;
+        }
+#ifndef NDEBUG
+        entry.name = name;
+#endif
+        m_uniformLocations[UniformName::ComputeHash(uniformName)] = entry;
+    }
+    m_uniformLocationsFilled = true;
 }
 
 // Get how many uniforms exist in this shader program
@@ -160,7 +317,46 @@ void ShaderProgram::GetUniformInfo(unsigned int index, int& size, GLenum& glType
     glGetActiveUniform(GetHandle(), index, uniformName.size(), nullptr, &size, &glType, uniformName.data());
 }
 
+void ShaderProgram::GetUniformsParameter(std::span<const GLuint> indices, GLenum pname, std::span<GLint> params) const
+{
+    assert(indices.size() == params.size());
+    glGetActiveUniformsiv(GetHandle(), static_cast<GLsizei>(indices.size()), indices.data(), pname, params.data());
+}
+
+GLuint ShaderProgram::GetUniformBlockIndex(const char* name) const
+{
+    return glGetUniformBlockIndex(GetHandle(), name);
+}
+
+GLint ShaderProgram::GetUniformBlockSize(GLuint blockIndex) const
+{
+    GLint size = 0;
+    glGetActiveUniformBlockiv(GetHandle(), blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+    return size;
+}
+
+void ShaderProgram::GetUniformBlockUniforms(GLuint blockIndex, std::vector<GLuint>& indices) const
+{
+    GLint uniformCount = 0;
+    glGetActiveUniformBlockiv(GetHandle(), blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &uniformCount);
+
+    // Returned as GLint, but they are uniform indices
+    std::vector<GLint> blockIndices(uniformCount);
+    if (uniformCount > 0)
+    {
+        glGetActiveUniformBlockiv(GetHandle(), blockIndex, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, blockIndices.data());
+    }
+    indices.assign(blockIndices.begin(), blockIndices.end());
+}
+
+void ShaderProgram::SetUniformBlockBinding(GLuint blockIndex, GLuint bindingIndex) const
+{
+    assert(IsValid());
+    glUniformBlockBinding(GetHandle(), blockIndex, bindingIndex);
+}
+
 // All the different combinations of Get/SetUniform
+// Uniforms are set with glProgramUniform (core since GL 4.1), so the program doesn't need to be in use
 template<>
 void ShaderProgram::GetUniform<GLint>(Location location, std::span<GLint> value) const
 {
@@ -197,207 +393,213 @@ template<>
 void ShaderProgram::SetUniforms<GLint, 1>(Location location, const GLint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform1iv(location, count, values);
+
+    // It could be a sampler uniform, that now has a different value than the cached one
+    if (location >= 0 && location < static_cast<Location>(m_textureUnits.size()))
+    {
+        Location end = std::min(location + count, static_cast<Location>(m_textureUnits.size()));
+        std::fill(m_textureUnits.begin() + location, m_textureUnits.begin() + end, -1);
+    }
+
+    glProgramUniform1iv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLint, 2>(Location location, const GLint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform2iv(location, count, values);
+    glProgramUniform2iv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLint, 3>(Location location, const GLint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform3iv(location, count, values);
+    glProgramUniform3iv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLint, 4>(Location location, const GLint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform4iv(location, count, values);
+    glProgramUniform4iv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLuint, 1>(Location location, const GLuint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform1uiv(location, count, values);
+    glProgramUniform1uiv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLuint, 2>(Location location, const GLuint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform2uiv(location, count, values);
+    glProgramUniform2uiv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLuint, 3>(Location location, const GLuint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform3uiv(location, count, values);
+    glProgramUniform3uiv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLuint, 4>(Location location, const GLuint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform4uiv(location, count, values);
+    glProgramUniform4uiv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 1>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform1fv(location, count, values);
+    glProgramUniform1fv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 2>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform2fv(location, count, values);
+    glProgramUniform2fv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 3>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform3fv(location, count, values);
+    glProgramUniform3fv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 4>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform4fv(location, count, values);
+    glProgramUniform4fv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLdouble, 1>(Location location, const GLdouble* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform1dv(location, count, values);
+    glProgramUniform1dv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLdouble, 2>(Location location, const GLdouble* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform2dv(location, count, values);
+    glProgramUniform2dv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLdouble, 3>(Location location, const GLdouble* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform3dv(location, count, values);
+    glProgramUniform3dv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLdouble, 4>(Location location, const GLdouble* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform4dv(location, count, values);
+    glProgramUniform4dv(GetHandle(), location, count, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 2, 2>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix2fv(location, count, false, values);
+    glProgramUniformMatrix2fv(GetHandle(), location, count, false, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 2, 3>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix2x3fv(location, count, false, values);
+    glProgramUniformMatrix2x3fv(GetHandle(), location, count, false, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 2, 4>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix2x4fv(location, count, false, values);
+    glProgramUniformMatrix2x4fv(GetHandle(), location, count, false, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 3, 2>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix3x2fv(location, count, false, values);
+    glProgramUniformMatrix3x2fv(GetHandle(), location, count, false, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 3, 3>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix3fv(location, count, false, values);
+    glProgramUniformMatrix3fv(GetHandle(), location, count, false, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 3, 4>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix3x4fv(location, count, false, values);
+    glProgramUniformMatrix3x4fv(GetHandle(), location, count, false, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 4, 2>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix4x2fv(location, count, false, values);
+    glProgramUniformMatrix4x2fv(GetHandle(), location, count, false, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 4, 3>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix4x3fv(location, count, false, values);
+    glProgramUniformMatrix4x3fv(GetHandle(), location, count, false, values);
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 4, 4>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix4fv(location, count, false, values);
+    glProgramUniformMatrix4fv(GetHandle(), location, count, false, values);
 }
 
 void ShaderProgram::SetTexture(Location location, GLint textureUnit, const TextureObject& texture) const
 {
     assert(IsValid());
-    assert(IsUsed());
+
+    // Active texture unit and texture bindings are skipped by DeviceGL if nothing changed
     TextureObject::SetActiveTexture(textureUnit);
     texture.Bind();
-    SetUniform(location, textureUnit);
+
+    if (location < 0)
+    {
+        return;
+    }
+
+    // Set the sampler uniform only if it was assigned to a different unit
+    bool elided = location < static_cast<Location>(m_textureUnits.size()) && m_textureUnits[location] == textureUnit;
+    if (!elided)
+    {
+        SetUniform(location, textureUnit);
+        if (location >= static_cast<Location>(m_textureUnits.size()))
+        {
+            m_textureUnits.resize(location + 1, -1);
+        }
+        m_textureUnits[location] = textureUnit;
+    }
+    DeviceGL::GetInstance().AddSamplerUniformStats(elided);
+}
+
+void ShaderProgram::InvalidateTextureUnits() const
+{
+    m_textureUnits.clear();
 }
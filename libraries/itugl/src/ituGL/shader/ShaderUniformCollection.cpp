@@ -1,16 +1,34 @@
 #include <ituGL/shader/ShaderUniformCollection.h>
+#include <algorithm>
+#include <cstring>
 #include <cassert>
 #include <array>
+#include <iostream>
 
-ShaderUniformCollection::ShaderUniformCollection() : m_shaderProgram(nullptr)
+unsigned long long ShaderUniformCollection::s_lastVersion = 0;
+
+ShaderUniformCollection::ShaderUniformCollection()
+    : m_shaderProgram(nullptr), m_firstBlockLocation(0), m_packedParentVersion(0), m_version(++s_lastVersion), m_uploadedVersion(0)
 {
 }
 
-ShaderUniformCollection::ShaderUniformCollection(std::shared_ptr<ShaderProgram> shaderProgram, const NameSet& filteredUniforms) : m_shaderProgram(shaderProgram)
+ShaderUniformCollection::ShaderUniformCollection(std::shared_ptr<ShaderProgram> shaderProgram, const NameSet& filteredUniforms)
+    : m_shaderProgram(shaderProgram), m_firstBlockLocation(0), m_packedParentVersion(0), m_version(++s_lastVersion), m_uploadedVersion(0)
 {
     ExtractUniforms(filteredUniforms);
 }
 
+ShaderUniformCollection::ShaderUniformCollection(std::shared_ptr<const ShaderUniformCollection> parent)
+    : m_shaderProgram(parent->m_shaderProgram)
+    , m_parent(parent)
+    , m_firstBlockLocation(parent->m_firstBlockLocation)
+    , m_packedParentVersion(0)
+    , m_version(++s_lastVersion)
+    , m_uploadedVersion(0)
+{
+    assert(!parent->m_parent);
+}
+
 std::shared_ptr<ShaderProgram> ShaderUniformCollection::GetShaderProgram()
 {
     return m_shaderProgram;
@@ -33,37 +51,234 @@ ShaderProgram::Location ShaderUniformCollection::GetAttributeLocation(const char
     return m_shaderProgram->GetAttributeLocation(name);
 }
 
-ShaderProgram::Location ShaderUniformCollection::GetUniformLocation(const char* name) const
+ShaderProgram::Location ShaderUniformCollection::GetUniformLocation(UniformName name) const
 {
+    // Instances use the same locations as the parent
+    if (m_parent)
+    {
+        return m_parent->GetUniformLocation(name);
+    }
+
+    if (!m_blockUniformLocations.empty())
+    {
+        auto itLocation = m_blockUniformLocations.find(name.GetHash());
+        if (itLocation != m_blockUniformLocations.end())
+        {
+            return itLocation->second;
+        }
+    }
     return m_shaderProgram->GetUniformLocation(name);
 }
 
+bool ShaderUniformCollection::SetUniformBlock(const char* blockName, GLuint bindingIndex, std::shared_ptr<UniformBufferArena> arena)
+{
+    assert(m_shaderProgram);
+    assert(!m_parent);
+    assert(!m_uniformBlock.allocation.IsValid());
+
+    const ShaderProgram& shaderProgram = *m_shaderProgram;
+
+    GLuint blockIndex = shaderProgram.GetUniformBlockIndex(blockName);
+    if (blockIndex == GL_INVALID_INDEX)
+    {
+        return false;
+    }
+
+    // Reserve the range of the block in the arena
+    GLint blockSize = shaderProgram.GetUniformBlockSize(blockIndex);
+    UniformBufferAllocation allocation(arena, blockSize);
+    if (!allocation.IsValid())
+    {
+        return false;
+    }
+
+    // Read the layout of the uniforms in the block
+    std::vector<GLuint> indices;
+    shaderProgram.GetUniformBlockUniforms(blockIndex, indices);
+    std::vector<GLint> offsets(indices.size());
+    std::vector<GLint> arrayStrides(indices.size());
+    std::vector<GLint> matrixStrides(indices.size());
+    std::vector<GLint> rowMajor(indices.size());
+    shaderProgram.GetUniformsParameter(indices, GL_UNIFORM_OFFSET, offsets);
+    shaderProgram.GetUniformsParameter(indices, GL_UNIFORM_ARRAY_STRIDE, arrayStrides);
+    shaderProgram.GetUniformsParameter(indices, GL_UNIFORM_MATRIX_STRIDE, matrixStrides);
+    shaderProgram.GetUniformsParameter(indices, GL_UNIFORM_IS_ROW_MAJOR, rowMajor);
+
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        int size;
+        GLenum glType;
+        char uniformName[256];
+        shaderProgram.GetUniformInfo(indices[i], size, glType, std::span(uniformName, sizeof(uniformName)));
+
+        // Values are packed by columns
+        assert(!rowMajor[i]);
+
+        // Blocks can only contain data, not textures
+        DataUniform uniform;
+        bool isData = IsDataUniform(glType, uniform.type, uniform.dimension);
+        assert(isData);
+        if (!isData)
+            continue;
+
+        uniform.location = m_firstBlockLocation + static_cast<ShaderProgram::Location>(i);
+        uniform.count = size;
+        uniform.blockOffset = offsets[i];
+        uniform.arrayStride = arrayStrides[i];
+        uniform.matrixStride = matrixStrides[i];
+        AddUniform(uniform);
+
+        // Arrays are reported as "name[0]", they can be found by the name of the array too
+        std::string name(uniformName);
+        if (name.ends_with("[0]"))
+        {
+            m_blockUniformLocations[UniformName::ComputeHash(name.substr(0, name.size() - 3).c_str())] = uniform.location;
+        }
+        m_blockUniformLocations[UniformName::ComputeHash(uniformName)] = uniform.location;
+    }
+
+    shaderProgram.SetUniformBlockBinding(blockIndex, bindingIndex);
+
+    m_uniformBlock.bindingIndex = bindingIndex;
+    m_uniformBlock.allocation = std::move(allocation);
+    m_uniformBlock.data.assign(blockSize, std::byte(0));
+
+    return true;
+}
+
 ShaderUniformCollection::DataUniform& ShaderUniformCollection::GetDataUniform(ShaderProgram::Location location)
 {
-    return const_cast<DataUniform&>(const_cast<const ShaderUniformCollection*>(this)->GetDataUniform(location));
+    if (const DataUniform* uniform = FindDataUniform(location))
+    {
+        return const_cast<DataUniform&>(*uniform);
+    }
+
+    // Copy on write: the instance gets its own copy of the uniform
+    assert(m_parent);
+    return OverrideUniform(m_parent->GetDataUniform(location));
 }
 
 const ShaderUniformCollection::DataUniform& ShaderUniformCollection::GetDataUniform(ShaderProgram::Location location) const
 {
-    int uniformIndex = m_locationDataIndex.at(location);
-    const DataUniform& uniform = m_dataUniforms[uniformIndex];
-    assert(uniform.location == location);
-    return uniform;
+    if (const DataUniform* uniform = FindDataUniform(location))
+    {
+        return *uniform;
+    }
+
+    assert(m_parent);
+    return m_parent->GetDataUniform(location);
 }
 
 ShaderUniformCollection::TextureUniform& ShaderUniformCollection::GetTextureUniform(ShaderProgram::Location location)
 {
-    return const_cast<TextureUniform&>(const_cast<const ShaderUniformCollection*>(this)->GetTextureUniform(location));
+    if (const TextureUniform* uniform = FindTextureUniform(location))
+    {
+        return const_cast<TextureUniform&>(*uniform);
+    }
+
+    // Copy on write: the instance gets its own copy of the uniform
+    assert(m_parent);
+    return OverrideUniform(m_parent->GetTextureUniform(location));
 }
 
 const ShaderUniformCollection::TextureUniform& ShaderUniformCollection::GetTextureUniform(ShaderProgram::Location location) const
 {
-    int uniformIndex = m_locationTextureIndex.at(location);
-    const TextureUniform& uniform = m_textureUniforms[uniformIndex];
+    if (const TextureUniform* uniform = FindTextureUniform(location))
+    {
+        return *uniform;
+    }
+
+    assert(m_parent);
+    return m_parent->GetTextureUniform(location);
+}
+
+const ShaderUniformCollection::DataUniform* ShaderUniformCollection::FindDataUniform(ShaderProgram::Location location) const
+{
+    assert(location >= 0);
+    if (location >= static_cast<ShaderProgram::Location>(m_locationDataIndex.size()) || m_locationDataIndex[location] < 0)
+    {
+        return nullptr;
+    }
+
+    const DataUniform& uniform = m_dataUniforms[m_locationDataIndex[location]];
     assert(uniform.location == location);
+    return &uniform;
+}
+
+const ShaderUniformCollection::TextureUniform* ShaderUniformCollection::FindTextureUniform(ShaderProgram::Location location) const
+{
+    assert(location >= 0);
+    if (location >= static_cast<ShaderProgram::Location>(m_locationTextureIndex.size()) || m_locationTextureIndex[location] < 0)
+    {
+        return nullptr;
+    }
+
+    const TextureUniform& uniform = m_textureUniforms[m_locationTextureIndex[location]];
+    assert(uniform.location == location);
+    return &uniform;
+}
+
+const ShaderUniformCollection& ShaderUniformCollection::GetDataOwner(ShaderProgram::Location location) const
+{
+    if (m_parent && !FindDataUniform(location))
+    {
+        return *m_parent;
+    }
+    return *this;
+}
+
+ShaderUniformCollection::DataUniform& ShaderUniformCollection::OverrideUniform(const DataUniform& parentUniform)
+{
+    switch (parentUniform.type)
+    {
+    case Data::Type::Int:
+        return OverrideUniform<int>(parentUniform);
+    case Data::Type::UInt:
+        return OverrideUniform<unsigned int>(parentUniform);
+    case Data::Type::Float:
+        return OverrideUniform<float>(parentUniform);
+    case Data::Type::Double:
+        return OverrideUniform<double>(parentUniform);
+    default:
+        assert(false);
+        return OverrideUniform<int>(parentUniform);
+    }
+}
+
+template<typename T>
+ShaderUniformCollection::DataUniform& ShaderUniformCollection::OverrideUniform(const DataUniform& parentUniform)
+{
+    AddUniform<T>(parentUniform);
+    DataUniform& uniform = m_dataUniforms.back();
+
+    // Start with the current values of the parent
+    const T* parentValues = &m_parent->GetDataValues<T>()[parentUniform.index];
+    std::copy(parentValues, parentValues + GetDataUniformSize(uniform), &GetDataValues<T>()[uniform.index]);
+
+    // Overrides of the block are packed in a range of the instance, allocated in the same arena as the parent
+    if (uniform.blockOffset >= 0 && !m_uniformBlock.allocation.IsValid())
+    {
+        m_uniformBlock.bindingIndex = m_parent->m_uniformBlock.bindingIndex;
+        m_uniformBlock.allocation = m_parent->m_uniformBlock.allocation;
+
+        // Without its own range, the instance would draw with the block values of the parent
+        if (!m_uniformBlock.allocation.IsValid())
+        {
+            std::cout << "ERROR::UNIFORMBLOCK::OVERRIDE_NOT_ALLOCATED\n" << "Block overrides of this instance will be ignored" << std::endl;
+            assert(false);
+        }
+    }
+
     return uniform;
 }
 
+ShaderUniformCollection::TextureUniform& ShaderUniformCollection::OverrideUniform(const TextureUniform& parentUniform)
+{
+    // Same texture unit as the parent
+    AddUniform(parentUniform);
+    return m_textureUniforms.back();
+}
+
 void ShaderUniformCollection::ExtractUniforms(const NameSet& filteredUniforms)
 {
     assert(m_shaderProgram);
@@ -72,23 +287,43 @@ void ShaderUniformCollection::ExtractUniforms(const NameSet& filteredUniforms)
 
     unsigned int uniformCount = shaderProgram.GetUniformCount();
 
+    // Find which uniforms belong to a uniform block
+    std::vector<GLuint> indices(uniformCount);
+    std::vector<GLint> blockIndices(uniformCount);
+    for (unsigned int i = 0; i < uniformCount; ++i)
+    {
+        indices[i] = i;
+    }
+    if (uniformCount > 0)
+    {
+        shaderProgram.GetUniformsParameter(indices, GL_UNIFORM_BLOCK_INDEX, blockIndices);
+    }
+
     // Loop over all the uniforms
     for (unsigned int i = 0; i < uniformCount; ++i)
     {
+        // Uniforms in blocks don't have a location. The material block is added with SetUniformBlock
+        if (blockIndices[i] >= 0)
+            continue;
+
         // Get the information of uniform in position i
         int size;
         GLenum glType;
         char uniformName[256];
         shaderProgram.GetUniformInfo(i, size, glType, std::span(uniformName, sizeof(uniformName)));
 
-        // If the named is in the filtered list, skip
-        if (filteredUniforms.contains(uniformName))
-            continue;
-
         // Get the uniform location
         ShaderProgram::Location location = GetUniformLocation(uniformName);
         assert(location >= 0);
 
+        // Block uniforms get locations after all the locations used by the program, filtered or not
+        // Arrays use one location per element
+        m_firstBlockLocation = std::max(m_firstBlockLocation, location + size);
+
+        // If the named is in the filtered list, skip
+        if (filteredUniforms.contains(uniformName))
+            continue;
+
         Data::Type type;
         UniformDimension dimension;
         TextureObject::Target target;
@@ -100,6 +335,9 @@ void ShaderUniformCollection::ExtractUniforms(const NameSet& filteredUniforms)
             uniform.type = type;
             uniform.dimension = dimension;
             uniform.count = size;
+            uniform.blockOffset = -1;
+            uniform.arrayStride = 0;
+            uniform.matrixStride = 0;
             AddUniform(uniform);
         }
         else if (IsTextureUniform(glType, target))
@@ -108,6 +346,7 @@ void ShaderUniformCollection::ExtractUniforms(const NameSet& filteredUniforms)
             TextureUniform uniform;
             uniform.location = location;
             uniform.target = target;
+            uniform.unit = static_cast<GLint>(m_textureUniforms.size());
             AddUniform(uniform);
         }
         else
@@ -283,20 +522,114 @@ void ShaderUniformCollection::AddUniform(const DataUniform& uniform)
 
 void ShaderUniformCollection::AddUniform(const TextureUniform& uniform)
 {
-    m_locationTextureIndex.insert(std::make_pair(uniform.location, static_cast<int>(m_textureUniforms.size())));
+    if (uniform.location >= static_cast<ShaderProgram::Location>(m_locationTextureIndex.size()))
+    {
+        m_locationTextureIndex.resize(uniform.location + 1, -1);
+    }
+    m_locationTextureIndex[uniform.location] = static_cast<int>(m_textureUniforms.size());
     m_textureUniforms.push_back(uniform);
 }
 
 void ShaderUniformCollection::SetUniforms() const
 {
+    // Uniforms of the block are in a range of the arena, that only needs to be bound
+    // Instances that don't override any uniform of the block use the range of the parent
+    const ShaderUniformCollection& blockOwner = m_parent && !m_uniformBlock.allocation.IsValid() ? *m_parent : *this;
+    if (blockOwner.m_uniformBlock.allocation.IsValid())
+    {
+        blockOwner.UpdateUniformBlock();
+        blockOwner.m_uniformBlock.allocation.BindRange(blockOwner.m_uniformBlock.bindingIndex);
+    }
+
+    // Data uniforms are stored in the program, only the changes are uploaded
+    if (m_parent)
+    {
+        UseOverrideUniforms();
+    }
+    else
+    {
+        UseDataUniforms();
+    }
+
+    // Texture units are shared by all programs, so textures are always bound. DeviceGL skips the redundant bindings
+    UseTextureUniforms();
+}
+
+void ShaderUniformCollection::UseDataUniforms() const
+{
+    ShaderProgram::AppliedUniforms& applied = m_shaderProgram->GetAppliedUniforms();
+
+    // Skip them if the program already has this version of the values
+    if (applied.version == m_version && applied.overrideVersion == 0)
+    {
+        return;
+    }
+
+    // If the program still has the values of our last upload, only the dirty uniforms are different
+    bool uploadDirtyOnly = applied.version != 0 && (applied.version == m_version || applied.version == m_uploadedVersion);
+
+    // Restore the uniforms changed by the overrides of an instance
+    if (uploadDirtyOnly)
+    {
+        for (ShaderProgram::Location location : applied.overrideLocations)
+        {
+            UseUniform(GetDataUniform(location));
+        }
+    }
+
     for (const DataUniform& uniform : m_dataUniforms)
     {
-        UseUniform(uniform);
+        if (uniform.blockOffset >= 0)
+            continue;
+
+        if (uniform.dirty || !uploadDirtyOnly)
+        {
+            UseUniform(uniform);
+        }
+        uniform.dirty = false;
     }
-    for (const TextureUniform& uniform : m_textureUniforms)
+
+    m_uploadedVersion = m_version;
+    applied.version = m_version;
+    applied.overrideVersion = 0;
+    applied.overrideLocations.clear();
+}
+
+void ShaderUniformCollection::UseTextureUniforms() const
+{
+    // Instances use the texture units of the parent, replacing the textures they override
+    const std::vector<TextureUniform>& textureUniforms = m_parent ? m_parent->m_textureUniforms : m_textureUniforms;
+    for (const TextureUniform& uniform : textureUniforms)
+    {
+        const TextureUniform* overrideUniform = m_parent ? FindTextureUniform(uniform.location) : nullptr;
+        UseUniform(overrideUniform ? *overrideUniform : uniform);
+    }
+}
+
+void ShaderUniformCollection::UseOverrideUniforms() const
+{
+    ShaderProgram::AppliedUniforms& applied = m_shaderProgram->GetAppliedUniforms();
+
+    // Skip them if the program already has the values of the parent with these overrides
+    if (applied.version == m_parent->m_version && applied.overrideVersion == m_version)
     {
+        return;
+    }
+
+    // Values of the parent first. This also restores the uniforms overridden by another instance of the parent
+    m_parent->UseDataUniforms();
+
+    // Then the overrides, usually just a few
+    for (const DataUniform& uniform : m_dataUniforms)
+    {
+        if (uniform.blockOffset >= 0)
+            continue;
+
         UseUniform(uniform);
+        uniform.dirty = false;
+        applied.overrideLocations.push_back(uniform.location);
     }
+    applied.overrideVersion = m_version;
 }
 
 void ShaderUniformCollection::UseUniform(const DataUniform& uniform) const
@@ -325,8 +658,93 @@ void ShaderUniformCollection::UseUniform(const TextureUniform& uniform) const
     //TODO: default texture
     if (uniform.texture)
     {
-        size_t textureIndex = &uniform - m_textureUniforms.data();
-        m_shaderProgram->SetTexture(uniform.location, static_cast<int>(textureIndex), *uniform.texture);
+        m_shaderProgram->SetTexture(uniform.location, uniform.unit, *uniform.texture);
+
+        // Always set the sampler of the unit, so a sampler from a previous material doesn't stay bound
+        if (uniform.sampler)
+        {
+            uniform.sampler->Bind(static_cast<GLuint>(uniform.unit));
+        }
+        else
+        {
+            SamplerObject::Unbind(static_cast<GLuint>(uniform.unit));
+        }
+    }
+}
+
+void ShaderUniformCollection::UpdateUniformBlock() const
+{
+    // A new range, from a copy of the collection, needs all the values
+    bool packAll = !m_uniformBlock.allocation.IsUploaded();
+
+    if (m_parent)
+    {
+        // The overrides are packed on top of the values of the parent. Start again from them if the parent changed
+        m_parent->UpdateUniformBlock();
+        if (packAll || m_packedParentVersion != m_parent->m_version)
+        {
+            m_uniformBlock.data = m_parent->m_uniformBlock.data;
+            m_packedParentVersion = m_parent->m_version;
+            packAll = true;
+        }
+    }
+
+    bool changed = false;
+    for (const DataUniform& uniform : m_dataUniforms)
+    {
+        if (uniform.blockOffset >= 0 && (uniform.dirty || packAll))
+        {
+            PackUniform(uniform);
+            uniform.dirty = false;
+            changed = true;
+        }
+    }
+
+    if (changed || packAll)
+    {
+        m_uniformBlock.allocation.UpdateData(m_uniformBlock.data);
+    }
+}
+
+void ShaderUniformCollection::PackUniform(const DataUniform& uniform) const
+{
+    switch (uniform.type)
+    {
+    case Data::Type::Int:
+        PackUniform<int>(uniform);
+        break;
+    case Data::Type::UInt:
+        PackUniform<unsigned int>(uniform);
+        break;
+    case Data::Type::Float:
+        PackUniform<float>(uniform);
+        break;
+    case Data::Type::Double:
+        PackUniform<double>(uniform);
+        break;
+    default:
+        assert(false);
+    }
+}
+
+template<typename T>
+void ShaderUniformCollection::PackUniform(const DataUniform& uniform) const
+{
+    int columns, rows;
+    GetDimensionSize(uniform.dimension, columns, rows);
+
+    // Values are stored contiguous, but std140 pads array elements and matrix columns
+    const T* values = &GetDataValues<T>()[uniform.index];
+    std::byte* elementData = &m_uniformBlock.data[uniform.blockOffset];
+    for (unsigned int i = 0; i < uniform.count; ++i)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            assert(elementData + column * uniform.matrixStride + rows * sizeof(T) <= m_uniformBlock.data.data() + m_uniformBlock.data.size());
+            std::memcpy(elementData + column * uniform.matrixStride, values, rows * sizeof(T));
+            values += rows;
+        }
+        elementData += uniform.arrayStride;
     }
 }
 
@@ -395,6 +813,64 @@ void ShaderUniformCollection::SetUniformValue(ShaderProgram::Location location,
     uniform.texture = value;
 }
 
+std::shared_ptr<const SamplerObject> ShaderUniformCollection::GetTextureSampler(UniformName name) const
+{
+    ShaderProgram::Location location = GetUniformLocation(name);
+    assert(location >= 0);
+    return GetTextureSampler(location);
+}
+
+std::shared_ptr<const SamplerObject> ShaderUniformCollection::GetTextureSampler(ShaderProgram::Location location) const
+{
+    const TextureUniform& uniform = GetTextureUniform(location);
+    return uniform.sampler;
+}
+
+void ShaderUniformCollection::SetTextureSampler(UniformName name, std::shared_ptr<const SamplerObject> sampler)
+{
+    ShaderProgram::Location location = GetUniformLocation(name);
+    if (location >= 0) // Silent skip, like SetUniformValue
+    {
+        SetTextureSampler(location, sampler);
+    }
+}
+
+void ShaderUniformCollection::SetTextureSampler(ShaderProgram::Location location, std::shared_ptr<const SamplerObject> sampler)
+{
+    TextureUniform& uniform = GetTextureUniform(location);
+    uniform.sampler = sampler;
+}
+
+void ShaderUniformCollection::SetDirty(DataUniform& uniform)
+{
+    uniform.dirty = true;
+    m_version = ++s_lastVersion;
+}
+
+void ShaderUniformCollection::GetDimensionSize(UniformDimension dimension, int& columns, int& rows)
+{
+    switch (dimension)
+    {
+    case UniformDimension::Scalar: columns = 1; rows = 1; break;
+    case UniformDimension::Vector2: columns = 1; rows = 2; break;
+    case UniformDimension::Vector3: columns = 1; rows = 3; break;
+    case UniformDimension::Vector4: columns = 1; rows = 4; break;
+    case UniformDimension::Matrix2x2: columns = 2; rows = 2; break;
+    case UniformDimension::Matrix2x3: columns = 2; rows = 3; break;
+    case UniformDimension::Matrix2x4: columns = 2; rows = 4; break;
+    case UniformDimension::Matrix3x2: columns = 3; rows = 2; break;
+    case UniformDimension::Matrix3x3: columns = 3; rows = 3; break;
+    case UniformDimension::Matrix3x4: columns = 3; rows = 4; break;
+    case UniformDimension::Matrix4x2: columns = 4; rows = 2; break;
+    case UniformDimension::Matrix4x3: columns = 4; rows = 3; break;
+    case UniformDimension::Matrix4x4: columns = 4; rows = 4; break;
+    default:
+        assert(false);
+        columns = 0;
+        rows = 0;
+    }
+}
+
 int ShaderUniformCollection::GetDataUniformSize(const DataUniform& uniform) const
 {
     int size = 0;
@@ -448,6 +924,13 @@ void ShaderUniformCollection::Reset()
     m_uintDataValues.clear();
     m_floatDataValues.clear();
     m_doubleDataValues.clear();
+    m_uniformBlock = UniformBlock();
+    m_blockUniformLocations.clear();
+    m_firstBlockLocation = 0;
+    m_packedParentVersion = 0;
+    m_parent.reset();
+    m_version = ++s_lastVersion;
+    m_uploadedVersion = 0;
 }
 
 #ifndef NDEBUG
@@ -0,0 +1,228 @@
+#include <ituGL/shader/UniformBufferArena.h>
+
+#include <ituGL/core/DeviceGL.h>
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+UniformBufferArena::UniformBufferArena(GLsizeiptr capacity)
+    : m_capacity(capacity)
+    , m_alignment(UniformBufferObject::GetOffsetAlignment())
+    , m_top(0)
+    , m_usedSize(0)
+{
+    assert(m_alignment > 0);
+
+    // The contents are updated when a material changes, so it needs dynamic storage
+    if (!DeviceGL::IsDirectStateAccessEnabled())
+    {
+        m_buffer.Bind();
+    }
+    m_buffer.AllocateStorage(static_cast<size_t>(capacity), BufferObject::DynamicStorage);
+}
+
+bool UniformBufferArena::Allocate(GLsizeiptr size, Range& range)
+{
+    assert(size > 0);
+
+    // Round up the size, so the next range stays aligned
+    GLsizeiptr alignedSize = (size + m_alignment - 1) / m_alignment * m_alignment;
+
+    // First, try to reuse a free range
+    for (auto itRange = m_freeRanges.begin(); itRange != m_freeRanges.end(); ++itRange)
+    {
+        if (itRange->size >= alignedSize)
+        {
+            range.offset = itRange->offset;
+            range.size = alignedSize;
+
+            // Keep the rest of the range free
+            itRange->offset += alignedSize;
+            itRange->size -= alignedSize;
+            if (itRange->size == 0)
+            {
+                m_freeRanges.erase(itRange);
+            }
+
+            m_usedSize += alignedSize;
+            return true;
+        }
+    }
+
+    // Then, allocate from the top
+    if (m_top + alignedSize > m_capacity)
+    {
+        return false;
+    }
+
+    range.offset = m_top;
+    range.size = alignedSize;
+    m_top += alignedSize;
+    m_usedSize += alignedSize;
+    return true;
+}
+
+void UniformBufferArena::Free(const Range& range)
+{
+    assert(range.offset + range.size <= m_top);
+    m_usedSize -= range.size;
+
+    // Free ranges are sorted by offset, merge the new one with its neighbours
+    auto itNext = std::lower_bound(m_freeRanges.begin(), m_freeRanges.end(), range,
+        [](const Range& a, const Range& b) { return a.offset < b.offset; });
+    Range merged = range;
+    if (itNext != m_freeRanges.end() && merged.offset + merged.size == itNext->offset)
+    {
+        merged.size += itNext->size;
+        itNext = m_freeRanges.erase(itNext);
+    }
+    if (itNext != m_freeRanges.begin())
+    {
+        auto itPrevious = std::prev(itNext);
+        if (itPrevious->offset + itPrevious->size == merged.offset)
+        {
+            merged.offset = itPrevious->offset;
+            merged.size += itPrevious->size;
+            itNext = m_freeRanges.erase(itPrevious);
+        }
+    }
+
+    if (merged.offset + merged.size == m_top)
+    {
+        // Last range, give it back to the top
+        m_top = merged.offset;
+    }
+    else
+    {
+        m_freeRanges.insert(itNext, merged);
+    }
+}
+
+void UniformBufferArena::UpdateData(const Range& range, std::span<const std::byte> data)
+{
+    assert(static_cast<GLsizeiptr>(data.size()) <= range.size);
+    if (!DeviceGL::IsDirectStateAccessEnabled())
+    {
+        m_buffer.Bind();
+    }
+    m_buffer.UpdateData(data, static_cast<size_t>(range.offset));
+}
+
+void UniformBufferArena::BindRange(GLuint bindingIndex, const Range& range) const
+{
+    m_buffer.BindRange(bindingIndex, range.offset, range.size);
+}
+
+std::shared_ptr<UniformBufferArena> UniformBufferArena::GetNextArena()
+{
+    if (!m_nextArena)
+    {
+        m_nextArena = std::make_shared<UniformBufferArena>(m_capacity);
+    }
+    return m_nextArena;
+}
+
+
+UniformBufferAllocation::UniformBufferAllocation() : m_uploaded(false)
+{
+}
+
+UniformBufferAllocation::UniformBufferAllocation(std::shared_ptr<UniformBufferArena> arena, GLsizeiptr size) : m_uploaded(false)
+{
+    Allocate(arena, size);
+}
+
+UniformBufferAllocation::~UniformBufferAllocation()
+{
+    Free();
+}
+
+UniformBufferAllocation::UniformBufferAllocation(const UniformBufferAllocation& allocation) : m_uploaded(false)
+{
+    if (allocation.IsValid())
+    {
+        Allocate(allocation.m_arena, allocation.m_range.size);
+    }
+}
+
+UniformBufferAllocation& UniformBufferAllocation::operator = (const UniformBufferAllocation& allocation)
+{
+    if (this != &allocation)
+    {
+        Free();
+        if (allocation.IsValid())
+        {
+            Allocate(allocation.m_arena, allocation.m_range.size);
+        }
+    }
+    return *this;
+}
+
+UniformBufferAllocation::UniformBufferAllocation(UniformBufferAllocation&& allocation) noexcept
+    : m_arena(std::move(allocation.m_arena))
+    , m_range(allocation.m_range)
+    , m_uploaded(allocation.m_uploaded)
+{
+    allocation.m_range = UniformBufferArena::Range();
+    allocation.m_uploaded = false;
+}
+
+UniformBufferAllocation& UniformBufferAllocation::operator = (UniformBufferAllocation&& allocation) noexcept
+{
+    if (this != &allocation)
+    {
+        Free();
+        m_arena = std::move(allocation.m_arena);
+        m_range = allocation.m_range;
+        m_uploaded = allocation.m_uploaded;
+        allocation.m_range = UniformBufferArena::Range();
+        allocation.m_uploaded = false;
+    }
+    return *this;
+}
+
+void UniformBufferAllocation::UpdateData(std::span<const std::byte> data)
+{
+    assert(IsValid());
+    m_arena->UpdateData(m_range, data);
+    m_uploaded = true;
+}
+
+void UniformBufferAllocation::BindRange(GLuint bindingIndex) const
+{
+    assert(IsValid());
+    m_arena->BindRange(bindingIndex, m_range);
+}
+
+void UniformBufferAllocation::Allocate(std::shared_ptr<UniformBufferArena> arena, GLsizeiptr size)
+{
+    assert(arena);
+    m_uploaded = false;
+
+    // A block larger than the arena doesn't fit in any arena of the chain
+    if (size > arena->GetCapacity())
+    {
+        std::cout << "ERROR::UNIFORMBUFFERARENA::BLOCK_TOO_LARGE\n" << size << " bytes, capacity " << arena->GetCapacity() << std::endl;
+        assert(false);
+        m_range = UniformBufferArena::Range();
+        return;
+    }
+
+    // If the arena is full, continue with the next one, instead of leaving the block without a range
+    while (!arena->Allocate(size, m_range))
+    {
+        arena = arena->GetNextArena();
+    }
+    m_arena = arena;
+}
+
+void UniformBufferAllocation::Free()
+{
+    if (IsValid())
+    {
+        m_arena->Free(m_range);
+        m_arena.reset();
+        m_range = UniformBufferArena::Range();
+    }
+    m_uploaded = false;
+}
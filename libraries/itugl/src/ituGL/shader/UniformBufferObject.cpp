@@ -0,0 +1,23 @@
+#include <ituGL/shader/UniformBufferObject.h>
+
+#include <ituGL/core/DeviceGL.h>
+#include <cassert>
+
+UniformBufferObject::UniformBufferObject()
+{
+    // Nothing to do here, it is done by the base class
+}
+
+// Range bindings go through the cache in DeviceGL, to skip the redundant ones
+void UniformBufferObject::BindRange(GLuint bindingIndex, GLintptr offset, GLsizeiptr size) const
+{
+    assert(offset % GetOffsetAlignment() == 0);
+    DeviceGL::GetInstance().BindUniformBufferRange(bindingIndex, GetHandle(), offset, size);
+}
+
+GLint UniformBufferObject::GetOffsetAlignment()
+{
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return alignment;
+}
@@ -0,0 +1,102 @@
+#include <ituGL/texture/AsyncReadback.h>
+
+#include <utility>
+#include <cassert>
+
+AsyncReadback::AsyncReadback(int width, int height, size_t rowPitch)
+    : m_width(width)
+    , m_height(height)
+    , m_rowPitch(rowPitch)
+    , m_mappedData(nullptr)
+{
+    // Allocate the destination, the GPU writes it and we read it once
+    m_buffer.Bind();
+    m_buffer.AllocateData(rowPitch * height, BufferObject::Usage::StreamRead);
+    PixelPackBufferObject::Unbind();
+}
+
+AsyncReadback::~AsyncReadback()
+{
+    Unmap();
+}
+
+AsyncReadback::AsyncReadback(AsyncReadback&& readback) noexcept
+    : m_buffer(std::move(readback.m_buffer))
+    , m_fence(std::move(readback.m_fence))
+    , m_width(readback.m_width)
+    , m_height(readback.m_height)
+    , m_rowPitch(readback.m_rowPitch)
+    , m_mappedData(readback.m_mappedData)
+{
+    // The mapping belongs to the buffer, that is now ours
+    readback.m_mappedData = nullptr;
+}
+
+AsyncReadback& AsyncReadback::operator = (AsyncReadback&& readback) noexcept
+{
+    Unmap();
+    m_buffer = std::move(readback.m_buffer);
+    m_fence = std::move(readback.m_fence);
+    m_width = readback.m_width;
+    m_height = readback.m_height;
+    m_rowPitch = readback.m_rowPitch;
+    m_mappedData = readback.m_mappedData;
+    readback.m_mappedData = nullptr;
+    return *this;
+}
+
+bool AsyncReadback::IsReady() const
+{
+    return m_fence.IsSignaled();
+}
+
+void AsyncReadback::Wait() const
+{
+    m_fence.Wait();
+}
+
+std::span<const std::byte> AsyncReadback::GetData()
+{
+    if (!m_mappedData)
+    {
+        // If not ready, this is where the stall happens
+        Wait();
+
+        m_buffer.Bind();
+        m_mappedData = static_cast<const std::byte*>(m_buffer.MapRange(0, m_rowPitch * m_height, GL_MAP_READ_BIT));
+        PixelPackBufferObject::Unbind();
+    }
+    return std::span<const std::byte>(m_mappedData, m_mappedData ? m_rowPitch * m_height : 0);
+}
+
+void AsyncReadback::Unmap()
+{
+    if (m_mappedData)
+    {
+        m_buffer.Bind();
+        m_buffer.Unmap();
+        PixelPackBufferObject::Unbind();
+        m_mappedData = nullptr;
+    }
+}
+
+void AsyncReadback::BeginCopy()
+{
+    assert(!m_mappedData);
+
+    // With a PBO bound, the pointer argument of the read functions is an offset in the buffer
+    m_buffer.Bind();
+}
+
+void AsyncReadback::EndCopy()
+{
+    PixelPackBufferObject::Unbind();
+    m_fence.Insert();
+}
+
+size_t AsyncReadback::ComputeRowPitch(int width, size_t pixelSize)
+{
+    const size_t packAlignment = 4;
+    size_t rowSize = width * pixelSize;
+    return (rowSize + packAlignment - 1) / packAlignment * packAlignment;
+}
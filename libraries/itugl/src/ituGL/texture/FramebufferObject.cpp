@@ -75,3 +75,30 @@ void FramebufferObject::SetDrawBuffers(std::span<const Attachment> attachments)
 {
     glDrawBuffers(static_cast<GLint>(attachments.size()), reinterpret_cast<const GLenum*>(attachments.data()));
 }
+
+AsyncReadback FramebufferObject::ReadPixelsAsync(Attachment attachment, int x, int y, int width, int height, TextureObject::Format format, Data::Type type) const
+{
+    size_t pixelSize = TextureObject::GetComponentCount(format) * Data::GetTypeSize(type);
+    AsyncReadback readback(width, height, AsyncReadback::ComputeRowPitch(width, pixelSize));
+
+    // Depth has no read buffer, and the default framebuffer has no attachments
+    // The read buffer is part of the framebuffer state, restore it so later reads and blits are not affected
+    bool setReadBuffer = GetHandle() != NullHandle && attachment != Attachment::Depth;
+    GLint previousReadBuffer = GL_NONE;
+    if (setReadBuffer)
+    {
+        glGetIntegerv(GL_READ_BUFFER, &previousReadBuffer);
+        glReadBuffer(static_cast<GLenum>(attachment));
+    }
+
+    readback.BeginCopy();
+    glReadPixels(x, y, width, height, format, static_cast<GLenum>(type), nullptr);
+    readback.EndCopy();
+
+    if (setReadBuffer)
+    {
+        glReadBuffer(static_cast<GLenum>(previousReadBuffer));
+    }
+
+    return readback;
+}
@@ -0,0 +1,6 @@
+#include <ituGL/texture/PixelPackBufferObject.h>
+
+PixelPackBufferObject::PixelPackBufferObject()
+{
+    // Nothing to do here, it is done by the base class
+}
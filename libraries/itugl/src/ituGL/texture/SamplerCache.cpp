@@ -0,0 +1,55 @@
+#include <ituGL/texture/SamplerCache.h>
+
+#include <functional>
+
+SamplerCache::SamplerCache()
+{
+}
+
+std::shared_ptr<const SamplerObject> SamplerCache::GetSampler(const SamplerObject::State& state)
+{
+    auto itSampler = m_samplers.find(state);
+    if (itSampler != m_samplers.end())
+    {
+        return itSampler->second;
+    }
+
+    // First time this state is requested
+    std::shared_ptr<SamplerObject> sampler = std::make_shared<SamplerObject>();
+    sampler->SetState(state);
+    m_samplers.emplace(state, sampler);
+    return sampler;
+}
+
+void SamplerCache::Clear()
+{
+    m_samplers.clear();
+}
+
+size_t SamplerCache::StateHash::operator()(const SamplerObject::State& state) const
+{
+    // Combine the hashes of all the parameters
+    size_t hash = 0;
+    auto combine = [&hash](size_t valueHash)
+    {
+        hash ^= valueHash + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+
+    std::hash<GLenum> enumHash;
+    combine(enumHash(state.minFilter));
+    combine(enumHash(state.magFilter));
+    combine(enumHash(state.wrapS));
+    combine(enumHash(state.wrapT));
+    combine(enumHash(state.wrapR));
+
+    std::hash<GLfloat> floatHash;
+    combine(floatHash(state.minLod));
+    combine(floatHash(state.maxLod));
+    combine(floatHash(state.lodBias));
+    for (GLfloat component : state.borderColor)
+    {
+        combine(floatHash(component));
+    }
+
+    return hash;
+}
@@ -0,0 +1,113 @@
+#include <ituGL/texture/SamplerObject.h>
+
+#include <ituGL/core/DeviceGL.h>
+#include <cassert>
+
+// Create the object initially null, get object handle and generate 1 sampler
+SamplerObject::SamplerObject() : Object(NullHandle)
+{
+    Handle& handle = GetHandle();
+    glGenSamplers(1, &handle);
+}
+
+// Get object handle and delete 1 sampler
+SamplerObject::~SamplerObject()
+{
+    Handle& handle = GetHandle();
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->OnSamplerDeleted(handle);
+    }
+    glDeleteSamplers(1, &handle);
+}
+
+SamplerObject::SamplerObject(SamplerObject&& samplerObject) noexcept : Object(std::move(samplerObject))
+{
+}
+
+SamplerObject& SamplerObject::operator = (SamplerObject&& samplerObject) noexcept
+{
+    Object::operator=(std::move(samplerObject));
+    return *this;
+}
+
+// Bind without texture unit should not be called for SamplerObject
+void SamplerObject::Bind() const
+{
+    // Assert if it gets called
+    assert(false);
+}
+
+// Sampler bindings go through the cache in DeviceGL, to skip the redundant ones
+void SamplerObject::Bind(GLuint textureUnit) const
+{
+    DeviceGL::GetInstance().BindSampler(textureUnit, GetHandle());
+}
+
+void SamplerObject::Unbind(GLuint textureUnit)
+{
+    DeviceGL::GetInstance().BindSampler(textureUnit, NullHandle);
+}
+
+void SamplerObject::SetState(const State& state)
+{
+    SetParameter(TextureObject::ParameterEnum::MinFilter, state.minFilter);
+    SetParameter(TextureObject::ParameterEnum::MagFilter, state.magFilter);
+    SetParameter(TextureObject::ParameterEnum::WrapS, state.wrapS);
+    SetParameter(TextureObject::ParameterEnum::WrapT, state.wrapT);
+    SetParameter(TextureObject::ParameterEnum::WrapR, state.wrapR);
+    SetParameter(TextureObject::ParameterFloat::MinLod, state.minLod);
+    SetParameter(TextureObject::ParameterFloat::MaxLod, state.maxLod);
+    SetParameter(TextureObject::ParameterFloat::LodBias, state.lodBias);
+    SetParameter(TextureObject::ParameterColor::BorderColor, std::span<const GLfloat, 4>(state.borderColor));
+}
+
+// Sampler parameters are always set through the handle, samplers don't need to be bound to be edited
+void SamplerObject::GetParameter(TextureObject::ParameterFloat pname, GLfloat& param) const
+{
+    glGetSamplerParameterfv(GetHandle(), static_cast<GLenum>(pname), &param);
+}
+
+void SamplerObject::SetParameter(TextureObject::ParameterFloat pname, GLfloat param)
+{
+    glSamplerParameterf(GetHandle(), static_cast<GLenum>(pname), param);
+}
+
+void SamplerObject::GetParameter(TextureObject::ParameterEnum pname, GLenum& param) const
+{
+    assert(IsSamplerParameter(pname));
+    glGetSamplerParameterIuiv(GetHandle(), static_cast<GLenum>(pname), &param);
+}
+
+void SamplerObject::SetParameter(TextureObject::ParameterEnum pname, GLenum param)
+{
+    assert(IsSamplerParameter(pname));
+    glSamplerParameteri(GetHandle(), static_cast<GLenum>(pname), param);
+}
+
+void SamplerObject::GetParameter(TextureObject::ParameterColor pname, std::span<GLfloat, 4> params) const
+{
+    glGetSamplerParameterfv(GetHandle(), static_cast<GLenum>(pname), params.data());
+}
+
+void SamplerObject::SetParameter(TextureObject::ParameterColor pname, std::span<const GLfloat, 4> params)
+{
+    glSamplerParameterfv(GetHandle(), static_cast<GLenum>(pname), params.data());
+}
+
+#ifndef NDEBUG
+bool SamplerObject::IsSamplerParameter(TextureObject::ParameterEnum pname)
+{
+    switch (pname)
+    {
+    case TextureObject::ParameterEnum::MinFilter:
+    case TextureObject::ParameterEnum::MagFilter:
+    case TextureObject::ParameterEnum::WrapS:
+    case TextureObject::ParameterEnum::WrapT:
+    case TextureObject::ParameterEnum::WrapR:
+        return true;
+    default:
+        return false;
+    }
+}
+#endif
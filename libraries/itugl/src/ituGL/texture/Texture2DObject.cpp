@@ -1,5 +1,7 @@
 #include <ituGL/texture/Texture2DObject.h>
 
+#include <ituGL/core/DeviceGL.h>
+#include <algorithm>
 #include <cassert>
 
 Texture2DObject::Texture2DObject()
@@ -20,3 +22,41 @@ void Texture2DObject::SetImage(GLint level, GLsizei width, GLsizei height, Forma
 {
     SetImage<float>(level, width, height, format, internalFormat, std::span<float>());
 }
+
+void Texture2DObject::SetStorage(GLsizei levels, GLsizei width, GLsizei height, InternalFormat internalFormat)
+{
+    assert(IsReadyToEdit());
+    assert(levels > 0 && levels <= GetMipmapLevelCount(width, height));
+
+    internalFormat = GetSizedInternalFormat(internalFormat);
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glTextureStorage2D(GetHandle(), levels, internalFormat, width, height);
+    }
+    else
+    {
+        // Allocate each level without data, and limit the levels so the texture is complete as if it was immutable
+        Format format = GetFormat(internalFormat);
+        for (GLint level = 0; level < levels; ++level)
+        {
+            SetImage(level, std::max(1, width >> level), std::max(1, height >> level), format, internalFormat);
+        }
+        SetParameter(ParameterInt::MaxLevel, levels - 1);
+    }
+}
+
+template <>
+void Texture2DObject::SetSubImage<std::byte>(GLint level, GLint x, GLint y, GLsizei width, GLsizei height, Format format, std::span<const std::byte> data, Data::Type type)
+{
+    assert(IsReadyToEdit());
+    assert(type != Data::Type::None);
+    assert(data.size_bytes() == width * height * GetComponentCount(format) * Data::GetTypeSize(type));
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glTextureSubImage2D(GetHandle(), level, x, y, width, height, format, static_cast<GLenum>(type), data.data());
+    }
+    else
+    {
+        glTexSubImage2D(GetTarget(), level, x, y, width, height, format, static_cast<GLenum>(type), data.data());
+    }
+}
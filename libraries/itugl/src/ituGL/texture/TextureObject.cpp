@@ -1,20 +1,40 @@
 #include <ituGL/texture/TextureObject.h>
 
+#include <ituGL/texture/AsyncReadback.h>
+#include <ituGL/core/DeviceGL.h>
+#include <algorithm>
 #include <cassert>
 
-TextureObject::TextureObject() : Object(NullHandle)
+TextureObject::TextureObject(Target target) : Object(NullHandle)
 {
     Handle& handle = GetHandle();
-    glGenTextures(1, &handle);
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        // DSA functions need the texture to exist, not just the name that glGenTextures reserves until the first bind
+        glCreateTextures(target, 1, &handle);
+    }
+    else
+    {
+        glGenTextures(1, &handle);
+    }
 }
 
 TextureObject::~TextureObject()
 {
     Handle& handle = GetHandle();
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->OnTextureDeleted(handle);
+    }
     glDeleteTextures(1, &handle);
 }
 
 #ifndef NDEBUG
+bool TextureObject::IsReadyToEdit() const
+{
+    return DeviceGL::IsDirectStateAccessEnabled() || IsBound();
+}
+
 GLint TextureObject::GetActiveTexture()
 {
     GLint activeTexture;
@@ -23,87 +43,185 @@ GLint TextureObject::GetActiveTexture()
 }
 #endif
 
+// Texture bindings go through the cache in DeviceGL, to skip the redundant ones
 void TextureObject::SetActiveTexture(GLint textureUnit)
 {
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    DeviceGL::GetInstance().SetActiveTextureUnit(textureUnit);
 }
 
 void TextureObject::Bind(Target target) const
 {
     Handle handle = GetHandle();
-    glBindTexture(target, handle);
+    DeviceGL::GetInstance().BindTextureToActiveUnit(target, handle);
 }
 
 void TextureObject::Unbind(Target target)
 {
     Handle handle = NullHandle;
-    glBindTexture(target, handle);
+    DeviceGL::GetInstance().BindTextureToActiveUnit(target, handle);
 }
 
 void TextureObject::GenerateMipmap()
+{
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glGenerateTextureMipmap(GetHandle());
+    }
+    else
+    {
+        glGenerateMipmap(GetTarget());
+    }
+}
+
+AsyncReadback TextureObject::ReadAsync(int level, Format format, Data::Type type) const
 {
     assert(IsBound());
-    glGenerateMipmap(GetTarget());
+    assert(GetTarget() != TextureCubemap); // Each face needs to be read separately
+
+    GLint width, height, depth;
+    glGetTexLevelParameteriv(GetTarget(), level, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GetTarget(), level, GL_TEXTURE_HEIGHT, &height);
+    glGetTexLevelParameteriv(GetTarget(), level, GL_TEXTURE_DEPTH, &depth);
+
+    size_t pixelSize = GetComponentCount(format) * Data::GetTypeSize(type);
+    AsyncReadback readback(width, height * depth, AsyncReadback::ComputeRowPitch(width, pixelSize));
+
+    readback.BeginCopy();
+    glGetTexImage(GetTarget(), level, format, static_cast<GLenum>(type), nullptr);
+    readback.EndCopy();
+
+    return readback;
 }
 
 void TextureObject::GetParameter(ParameterFloat pname, GLfloat& param) const
 {
-    assert(IsBound());
-    glGetTexParameterfv(GetTarget(), static_cast<GLenum>(pname), &param);
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glGetTextureParameterfv(GetHandle(), static_cast<GLenum>(pname), &param);
+    }
+    else
+    {
+        glGetTexParameterfv(GetTarget(), static_cast<GLenum>(pname), &param);
+    }
 }
 
 void TextureObject::SetParameter(ParameterFloat pname, GLfloat param)
 {
-    assert(IsBound());
-    glTexParameterf(GetTarget(), static_cast<GLenum>(pname), param);
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glTextureParameterf(GetHandle(), static_cast<GLenum>(pname), param);
+    }
+    else
+    {
+        glTexParameterf(GetTarget(), static_cast<GLenum>(pname), param);
+    }
 }
 
 void TextureObject::GetParameter(ParameterInt pname, GLint& param) const
 {
-    assert(IsBound());
-    glGetTexParameteriv(GetTarget(), static_cast<GLenum>(pname), &param);
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glGetTextureParameteriv(GetHandle(), static_cast<GLenum>(pname), &param);
+    }
+    else
+    {
+        glGetTexParameteriv(GetTarget(), static_cast<GLenum>(pname), &param);
+    }
 }
 
 void TextureObject::SetParameter(ParameterInt pname, GLint param)
 {
-    assert(IsBound());
-    glTexParameteri(GetTarget(), static_cast<GLenum>(pname), param);
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glTextureParameteri(GetHandle(), static_cast<GLenum>(pname), param);
+    }
+    else
+    {
+        glTexParameteri(GetTarget(), static_cast<GLenum>(pname), param);
+    }
 }
 
 void TextureObject::GetParameter(ParameterEnum pname, GLenum& param) const
 {
-    assert(IsBound());
-    glGetTexParameterIuiv(GetTarget(), static_cast<GLenum>(pname), &param);
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glGetTextureParameterIuiv(GetHandle(), static_cast<GLenum>(pname), &param);
+    }
+    else
+    {
+        glGetTexParameterIuiv(GetTarget(), static_cast<GLenum>(pname), &param);
+    }
 }
 
 void TextureObject::SetParameter(ParameterEnum pname, GLenum param)
 {
-    assert(IsBound());
-    glTexParameteri(GetTarget(), static_cast<GLenum>(pname), param);
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glTextureParameteri(GetHandle(), static_cast<GLenum>(pname), param);
+    }
+    else
+    {
+        glTexParameteri(GetTarget(), static_cast<GLenum>(pname), param);
+    }
 }
 
 void TextureObject::GetParameter(ParameterEnumVector pname, std::span<GLenum> params) const
 {
-    assert(IsBound());
-    glGetTexParameterIuiv(GetTarget(), static_cast<GLenum>(pname), params.data());
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glGetTextureParameterIuiv(GetHandle(), static_cast<GLenum>(pname), params.data());
+    }
+    else
+    {
+        glGetTexParameterIuiv(GetTarget(), static_cast<GLenum>(pname), params.data());
+    }
 }
 
 void TextureObject::SetParameter(ParameterEnumVector pname, std::span<const GLenum> params)
 {
-    assert(IsBound());
-    glTexParameterIuiv(GetTarget(), static_cast<GLenum>(pname), params.data());
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glTextureParameterIuiv(GetHandle(), static_cast<GLenum>(pname), params.data());
+    }
+    else
+    {
+        glTexParameterIuiv(GetTarget(), static_cast<GLenum>(pname), params.data());
+    }
 }
 
 void TextureObject::GetParameter(ParameterColor pname, std::span<GLfloat, 4> params) const
 {
-    assert(IsBound());
-    glGetTexParameterfv(GetTarget(), static_cast<GLenum>(pname), params.data());
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glGetTextureParameterfv(GetHandle(), static_cast<GLenum>(pname), params.data());
+    }
+    else
+    {
+        glGetTexParameterfv(GetTarget(), static_cast<GLenum>(pname), params.data());
+    }
 }
 
 void TextureObject::SetParameter(ParameterColor pname, std::span<const GLfloat, 4> params)
 {
-    assert(IsBound());
-    glTexParameterfv(GetTarget(), static_cast<GLenum>(pname), params.data());
+    assert(IsReadyToEdit());
+    if (DeviceGL::IsDirectStateAccessEnabled())
+    {
+        glTextureParameterfv(GetHandle(), static_cast<GLenum>(pname), params.data());
+    }
+    else
+    {
+        glTexParameterfv(GetTarget(), static_cast<GLenum>(pname), params.data());
+    }
 }
 
 #ifndef NDEBUG
@@ -250,3 +368,107 @@ int TextureObject::GetDataComponentCount(InternalFormat internalFormat)
         return 0;
     }
 }
+
+TextureObject::Format TextureObject::GetFormat(InternalFormat internalFormat)
+{
+    switch (internalFormat)
+    {
+    case InternalFormatR:
+    case InternalFormatR8:
+    case InternalFormatR16:
+    case InternalFormatR8SNorm:
+    case InternalFormatR16SNorm:
+    case InternalFormatR16F:
+    case InternalFormatR32F:
+    case InternalFormatRCompressed:
+        return FormatR;
+    case InternalFormatRG:
+    case InternalFormatRG8:
+    case InternalFormatRG16:
+    case InternalFormatRG8SNorm:
+    case InternalFormatRG16SNorm:
+    case InternalFormatRG16F:
+    case InternalFormatRG32F:
+    case InternalFormatRGCompressed:
+        return FormatRG;
+    case InternalFormatRGB:
+    case InternalFormatRGB8:
+    case InternalFormatRGB16:
+    case InternalFormatRGB8SNorm:
+    case InternalFormatRGB16SNorm:
+    case InternalFormatRGB16F:
+    case InternalFormatRGB32F:
+    case InternalFormatSRGB8:
+    case InternalFormatRGBCompressed:
+    case InternalFormatSRGBCompressed:
+    case InternalFormatR11G11B10:
+        return FormatRGB;
+    case InternalFormatRGBA:
+    case InternalFormatRGBA8:
+    case InternalFormatRGBA16:
+    case InternalFormatRGBA8SNorm:
+    case InternalFormatRGBA16SNorm:
+    case InternalFormatRGBA16F:
+    case InternalFormatRGBA32F:
+    case InternalFormatSRGBA8:
+    case InternalFormatRGBACompressed:
+    case InternalFormatSRGBACompressed:
+    case InternalFormatRGB10A2:
+        return FormatRGBA;
+    case InternalFormatDepth:
+    case InternalFormatDepth16:
+    case InternalFormatDepth24:
+    case InternalFormatDepth32:
+    case InternalFormatDepth32F:
+        return FormatDepth;
+    case InternalFormatDepthStencil:
+    case InternalFormatDepth24Stencil8:
+    case InternalFormatDepth32FStencil8:
+        return FormatDepthStencil;
+    default:
+        //Unknown format
+        return FormatInvalid;
+    }
+}
+
+TextureObject::InternalFormat TextureObject::GetSizedInternalFormat(InternalFormat internalFormat)
+{
+    switch (internalFormat)
+    {
+    case InternalFormatR:
+    case InternalFormatRCompressed:
+        return InternalFormatR8;
+    case InternalFormatRG:
+    case InternalFormatRGCompressed:
+        return InternalFormatRG8;
+    case InternalFormatRGB:
+    case InternalFormatRGBCompressed:
+        return InternalFormatRGB8;
+    case InternalFormatRGBA:
+    case InternalFormatRGBACompressed:
+        return InternalFormatRGBA8;
+    case InternalFormatSRGBCompressed:
+        return InternalFormatSRGB8;
+    case InternalFormatSRGBACompressed:
+        return InternalFormatSRGBA8;
+    case InternalFormatDepth:
+        return InternalFormatDepth24;
+    case InternalFormatDepthStencil:
+        return InternalFormatDepth24Stencil8;
+    default:
+        // Already sized
+        return internalFormat;
+    }
+}
+
+int TextureObject::GetMipmapLevelCount(GLsizei width, GLsizei height, GLsizei depth)
+{
+    GLsizei size = std::max(width, std::max(height, depth));
+    int levelCount = 1;
+    while (size > 1)
+    {
+        size >>= 1;
+        ++levelCount;
+    }
+    return levelCount;
+}
@@ -1,9 +1,11 @@
 #include <ituGL/utils/DearImGui.h>
 
+#include <ituGL/core/DeviceGL.h>
 #include <ituGL/application/Window.h>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
+#include <cassert>
 
 DearImGui::DearImGui()
 {
@@ -41,6 +43,9 @@ void DearImGui::BeginFrame()
 
 void DearImGui::EndFrame()
 {
+    // The draw data is submitted directly, it can't be recorded for the RenderThread
+    assert(DeviceGL::IsContextCurrent());
+
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }